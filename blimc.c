@@ -29,7 +29,7 @@ static Clause * clauses;
 static int nclauses, szclauses;
 
 static int * lits;
-static int nlits, szlits;
+static int nlits, szlits, maxlit;
 
 static int maxvar;
 static int * litmap;
@@ -344,6 +344,7 @@ static void extract (void * dummy, int lit) {
       lits = rsz (0, lits, oldbytes, newbytes);
     }
     lits[nlits++] = lit;
+    if (abs (lit) > maxlit) maxlit = abs (lit);
   } else {
     if (nclauses == szclauses) {
       oldbytes = szclauses * sizeof *clauses;
@@ -360,9 +361,12 @@ static void extract (void * dummy, int lit) {
   }
 }
 
+// Extracted clauses may contain auxiliary variables beyond those of the
+// model (see 'lglctrav' in 'lglib.h'), which are mapped as well.
+
 static int mapuntimedlit (int lit) {
   int idx = abs (lit), res;
-  assert (1 <= idx && idx <= (int) model->maxvar + 1);
+  assert (1 <= idx && idx <= maxlit);
   if (!(res = litmap[idx])) litmap[idx] = res = ++maxvar;
   if (lit < 0) res = -res;
   return res;
@@ -425,7 +429,8 @@ static void init (void) {
   size_t bytes;
   unsigned i;
   int lit;
-  bytes = (model->maxvar + 2) * sizeof *litmap;
+  if (maxlit < (int) model->maxvar + 1) maxlit = model->maxvar + 1;
+  bytes = (maxlit + 1) * sizeof *litmap;
   litmap = new (0, bytes);
   memset (litmap, 0, bytes);
   assert (!maxvar);
@@ -658,7 +663,7 @@ int main (int argc, char ** argv) {
     } else if (res == 20 && !model->num_latches) 
       fprintf (outfile, "0\nb0\n.\n");
     else fprintf (outfile, "2\nb0\n.\n");
-    del (0, litmap, (model->maxvar + 2) * sizeof *litmap);
+    del (0, litmap, (maxlit + 1) * sizeof *litmap);
   }
   fflush (outfile);
   del (0, coi, (model->maxvar+1) * sizeof *coi);
@@ -16,6 +16,7 @@ classify=no
 aiger=undefined
 yalsat=undefined
 files=no
+shape=no
 
 ##########################################################################
 
@@ -57,6 +58,7 @@ do
        echo "--druplig       specify Druplig directory (default '../druplig')"
        echo "--no-druplig    do not include Druplig code"
        echo "--files         generate statistics files"
+       echo "--shape         collect watch and clause shape statistics"
        echo
        echo "--classify      use classifier for automatic parameter setting"
        exit 0
@@ -83,6 +85,7 @@ do
     --druplig) druplig=`echo "$1"|sed -e 's,^--druplig=,,'`;;
     --no-druplig) druplig=no;;
     --files) files=yes;;
+    --shape) shape=yes;;
     --classify) classify=yes;;
     -f*|-m*) if [ $other = none ]; then other=$1; else other="$other $1"; fi;;
     *) echo "*** configure.sh: invalid command line option '$1'"; exit 1;;
@@ -194,7 +197,7 @@ else
   [ $lto = yes ] && CFLAGS="$CFLAGS -flto -fwhole-program"
 fi
 
-LIBS="-lm"
+LIBS="-lm -lpthread"
 HDEPS=""
 LDEPS=""
 
@@ -243,6 +246,7 @@ fi
 [ $yalsat = no ] && CFLAGS="$CFLAGS -DNLGLYALSAT"
 [ $files = no ] && CFLAGS="$CFLAGS -DNLGLFILES"
 [ $dema = no ] && CFLAGS="$CFLAGS -DNLGLDEMA"
+[ $shape = yes ] && CFLAGS="$CFLAGS -DLGLSHAPE"
 
 if [ $classify = yes -a -d sc14classify ]
 then
@@ -3,6 +3,7 @@
 /*-------------------------------------------------------------------------*/
 
 #include "lglib.h"
+#include "lgljson.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -95,6 +96,7 @@ typedef struct Worker {
 static double startime;
 static size_t allocated, maxallocated;
 static FILE * statsfile, * histfile;
+static LJS * jsonstats;
 
 static Worker * workers;
 static int nworkers;
@@ -828,7 +830,7 @@ static void setsighandlers (void) {
 }
 
 int main (int argc, char ** argv) {
-  const char * statsfilename = 0, * histfilename = 0;
+  const char * statsfilename = 0, * histfilename = 0, * jsonfilename = 0;
   int i, closeinputfile, res = 0;
   Worker * winner, * w;
   startime = currentime ();
@@ -848,6 +850,7 @@ int main (int argc, char ** argv) {
 "\n"
 "  -s  <stats> output statistics to separate file\n"
 "  -t  <hist> output job run time histogram to separate file\n"
+"  -j  <json> output JSON statistics of all workers and their sum\n"
 "\n"
 "  --clone       use cloning for hard cubes\n"
 "  --reduce      reduce learned clause cache after each job\n"
@@ -890,6 +893,10 @@ int main (int argc, char ** argv) {
       if (histfilename) die ("two '-t' options");
       if (++i == argc) die ("argument to '-t' missing");
       histfilename = argv[i];
+    } else if (!strcmp (argv[i], "-j")) {
+      if (jsonfilename) die ("two '-j' options");
+      if (++i == argc) die ("argument to '-j' missing");
+      jsonfilename = argv[i];
     } else if (!strcmp (argv[i], "--clone")) doclone = 1;
     else if (!strcmp (argv[i], "--no-flush")) noflush = 1;
     else if (!strcmp (argv[i], "-d") || !strcmp (argv[i], "--drup")) {
@@ -914,6 +921,12 @@ int main (int argc, char ** argv) {
     die ("can not write to stats file '%s'", statsfilename);
   if (histfilename && !(histfile = fopen (histfilename, "w")))
     die ("can not write to job run time histogram file '%s'", histfilename);
+  if (jsonfilename) {
+    FILE * jsonfile = fopen (jsonfilename, "w");
+    if (!jsonfile)
+      die ("can not write to JSON statistics file '%s'", jsonfilename);
+    jsonstats = ljsinit (jsonfile);
+  }
   if (verbose && !statsfile) statsfile = stdout;
   if (verbose)
     lglbnr ("iLingeling Incremental Parallel Lingeling", "c ", stdout),
@@ -949,6 +962,13 @@ int main (int argc, char ** argv) {
   if (statsfilename) fclose (statsfile);
   if (histfile) hist ();
   if (histfile) fclose (histfile);
+  if (jsonstats) {
+    for (w = workers; w < workers + nworkers; w++) {
+      ljsadd (jsonstats, w->lgl);
+      if (w->cloned.lgl) ljsadd (jsonstats, w->cloned.lgl);
+    }
+    ljsrelease (jsonstats);
+  }
   if (res == 10) printf ("s SATISFIABLE\n");
   else if (res == 20) printf ("s UNSATISFIABLE\n");
   else printf ("s UNKNOWN\n");
@@ -0,0 +1,171 @@
+/*-------------------------------------------------------------------------*/
+/* Copyright 2010-2020 Armin Biere Johannes Kepler University Linz Austria */
+/*-------------------------------------------------------------------------*/
+
+#include "lglib.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+/*------------------------------------------------------------------------*/
+// Compares adding clauses and assumptions literal by literal through
+// 'lgladd' and 'lglassume' with the bulk versions 'lgladdclauses' and
+// 'lglassumeall' on random clauses.
+
+static int vars = 1000000, clauses = 4000000, len = 3, rounds = 3;
+static unsigned rng = 1;
+
+static void die (const char * fmt, ...) {
+  va_list ap;
+  fputs ("*** lglapibench: ", stderr);
+  va_start (ap, fmt);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  fflush (stderr);
+  exit (1);
+}
+
+static void msg (const char * fmt, ...) {
+  va_list ap;
+  fputs ("c [lglapibench] ", stdout);
+  va_start (ap, fmt);
+  vprintf (fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+static double getime (void) {
+  struct timeval tv;
+  double res = 0;
+  if (!gettimeofday (&tv, 0)) res = 1e-6 * tv.tv_usec, res += tv.tv_sec;
+  return res;
+}
+
+static unsigned next (void) {
+  rng *= 1664525u;
+  rng += 1013904223u;
+  return rng;
+}
+
+static int pick (void) {
+  int res = 1 + (next () >> 4) % vars;
+  if (next () & (1u << 20)) res = -res;
+  return res;
+}
+
+static double addsingle (const int * lits, size_t n) {
+  const int * p, * end = lits + n;
+  double res;
+  LGL * lgl = lglinit ();
+  res = getime ();
+  for (p = lits; p < end; p++) lgladd (lgl, *p);
+  res = getime () - res;
+  lglrelease (lgl);
+  return res;
+}
+
+static double addbulk (const int * lits, size_t n) {
+  double res;
+  LGL * lgl = lglinit ();
+  res = getime ();
+  lgladdclauses (lgl, lits, n);
+  res = getime () - res;
+  lglrelease (lgl);
+  return res;
+}
+
+static double assumesingle (const int * lits, size_t n) {
+  const int * p, * end = lits + n;
+  double res;
+  LGL * lgl = lglinit ();
+  res = getime ();
+  for (p = lits; p < end; p++) lglassume (lgl, *p);
+  res = getime () - res;
+  lglrelease (lgl);
+  return res;
+}
+
+static double assumebulk (const int * lits, size_t n) {
+  double res;
+  LGL * lgl = lglinit ();
+  res = getime ();
+  lglassumeall (lgl, lits, n);
+  res = getime () - res;
+  lglrelease (lgl);
+  return res;
+}
+
+static void report (const char * name, size_t n, double single, double bulk) {
+  msg ("%-6s %10.3f %10.3f seconds %6.2f speed-up "
+       "(%.1f vs. %.1f million literals per second)",
+       name, single, bulk, bulk > 0 ? single / bulk : 0.0,
+       single > 0 ? 1e-6 * n / single : 0.0,
+       bulk > 0 ? 1e-6 * n / bulk : 0.0);
+}
+
+static int isnum (const char * str) {
+  const char * p = str;
+  if (!*p) return 0;
+  while (*p) if (*p < '0' || *p++ > '9') return 0;
+  return 1;
+}
+
+static int intarg (int argc, char ** argv, int * iptr) {
+  if (*iptr + 1 >= argc || !isnum (argv[*iptr + 1]))
+    die ("argument to '%s' missing or invalid", argv[*iptr]);
+  return atoi (argv[++*iptr]);
+}
+
+int main (int argc, char ** argv) {
+  double adds[2], assumes[2];
+  size_t nlits, nassumes;
+  int i, j, * lits;
+  for (i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h")) {
+      printf (
+"usage: lglapibench [-h][-v <vars>][-c <clauses>][-k <len>][-r <rounds>]"
+"[-s <seed>]\n");
+      exit (0);
+    } else if (!strcmp (argv[i], "-v")) vars = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-c")) clauses = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-k")) len = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-r")) rounds = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-s")) rng = intarg (argc, argv, &i);
+    else die ("invalid command line option '%s' (try '-h')", argv[i]);
+  }
+  if (vars < 1) die ("expected at least one variable");
+  if (len < 1) die ("expected positive clause length");
+  nlits = (len + 1) * (size_t) clauses;
+  if (!(lits = malloc (nlits * sizeof *lits))) die ("out of memory");
+  nassumes = clauses < vars ? clauses : vars;
+  for (i = 0; i < (int) nassumes; i++)
+    lits[i] = (next () & (1u << 20)) ? i + 1 : -i - 1;
+  adds[0] = adds[1] = assumes[0] = assumes[1] = 0;
+  msg ("assuming %zu literals", nassumes);
+  for (i = 0; i < rounds; i++) {
+    assumes[0] += assumesingle (lits, nassumes);
+    assumes[1] += assumebulk (lits, nassumes);
+  }
+  msg ("generating %d clauses of length %d over %d variables",
+       clauses, len, vars);
+  for (i = 0; i < clauses; i++) {
+    for (j = 0; j < len; j++) lits[i * (size_t)(len + 1) + j] = pick ();
+    lits[i * (size_t)(len + 1) + len] = 0;
+  }
+  for (i = 0; i < rounds; i++) {
+    adds[0] += addsingle (lits, nlits);
+    adds[1] += addbulk (lits, nlits);
+  }
+  msg ("%d rounds, %zu literals, %zu assumptions",
+       rounds, nlits, nassumes);
+  msg ("%-6s %10s %10s", "", "single", "bulk");
+  report ("add", rounds * nlits, adds[0], adds[1]);
+  report ("assume", rounds * nassumes, assumes[0], assumes[1]);
+  free (lits);
+  return 0;
+}
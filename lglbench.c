@@ -0,0 +1,510 @@
+/*-------------------------------------------------------------------------*/
+/* Copyright 2010-2020 Armin Biere Johannes Kepler University Linz Austria */
+/*-------------------------------------------------------------------------*/
+
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*------------------------------------------------------------------------*/
+// Generates deterministic CNF families, runs 'lingeling' (or 'plingeling')
+// on them with JSON statistics enabled and reports throughput, time spent
+// in the main phases and peak memory in a stable format.  The output of
+// two builds on the same machine can be compared line by line.
+
+static int scale = 1, threads, timelimit = 300, csv, keep, genonly;
+static const char * solver, * dir, * only;
+static unsigned rng = 1;
+
+static void die (const char * fmt, ...) {
+  va_list ap;
+  fputs ("*** lglbench: ", stderr);
+  va_start (ap, fmt);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  fflush (stderr);
+  exit (1);
+}
+
+static void msg (const char * fmt, ...) {
+  va_list ap;
+  fputs ("c [lglbench] ", stdout);
+  va_start (ap, fmt);
+  vprintf (fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+static double getime (void) {
+  struct timeval tv;
+  double res = 0;
+  if (!gettimeofday (&tv, 0)) res = 1e-6 * tv.tv_usec, res += tv.tv_sec;
+  return res;
+}
+
+static unsigned next (void) {
+  rng *= 1664525u;
+  rng += 1013904223u;
+  return rng;
+}
+
+static int pick (int n) { return (next () >> 8) % n; }
+
+static int sign (void) { return (next () & (1u << 20)) ? 1 : -1; }
+
+/*------------------------------------------------------------------------*/
+// Clauses are collected first, since the header needs the counts.
+
+static int * lits, nlits, szlits, nclauses, nvars;
+
+static void add (int lit) {
+  if (nlits == szlits) {
+    szlits = szlits ? 2*szlits : 1024;
+    if (!(lits = realloc (lits, szlits * sizeof *lits)))
+      die ("out of memory");
+  }
+  lits[nlits++] = lit;
+  if (!lit) nclauses++;
+  else if (abs (lit) > nvars) nvars = abs (lit);
+}
+
+static void binary (int a, int b) { add (a), add (b), add (0); }
+
+static void ternary (int a, int b, int c) {
+  add (a), add (b), add (c), add (0);
+}
+
+static void xor (int y, int a, int b) {
+  ternary (-y, a, b), ternary (-y, -a, -b);
+  ternary (y, -a, b), ternary (y, a, -b);
+}
+
+static void and (int y, int a, int b) {
+  binary (-y, a), binary (-y, b), ternary (y, -a, -b);
+}
+
+static void reset (void) { nlits = nclauses = nvars = 0; }
+
+/*------------------------------------------------------------------------*/
+
+// Uniform random 3-SAT at the satisfiability threshold.
+
+static void ksat (void) {
+  int n = 180 + 20*scale, m = (426 * n) / 100, i, j, v[3];
+  for (i = 0; i < m; i++) {
+    for (j = 0; j < 3; j++) {
+      v[j] = 1 + pick (n);
+      if ((j > 0 && v[j] == v[0]) || (j > 1 && v[j] == v[1])) j--;
+    }
+    for (j = 0; j < 3; j++) add (sign () * v[j]);
+    add (0);
+  }
+}
+
+// Pigeon hole principle with one more pigeon than holes.
+
+static void php (void) {
+  int h = 7 + scale, p = h + 1, i, j, k;
+#define PH(I,J) (1 + (I)*h + (J))
+  for (i = 0; i < p; i++) {
+    for (j = 0; j < h; j++) add (PH (i, j));
+    add (0);
+  }
+  for (j = 0; j < h; j++)
+    for (i = 0; i < p; i++)
+      for (k = i + 1; k < p; k++)
+	binary (-PH (i, j), -PH (k, j));
+#undef PH
+}
+
+// Two XOR chains over the same inputs in different order, where one
+// result is forced to true and the other to false.
+
+static void parity (void) {
+  int n = 200*scale, * perm, i, j, tmp, prev, y;
+  if (!(perm = malloc (n * sizeof *perm))) die ("out of memory");
+  for (i = 0; i < n; i++) perm[i] = i + 1;
+  for (i = n - 1; i > 0; i--) {
+    j = pick (i + 1);
+    tmp = perm[i], perm[i] = perm[j], perm[j] = tmp;
+  }
+  y = n;
+  for (prev = 1, i = 1; i < n; i++) xor (++y, prev, i + 1), prev = y;
+  add (prev), add (0);
+  for (prev = perm[0], i = 1; i < n; i++)
+    xor (++y, prev, perm[i]), prev = y;
+  add (-prev), add (0);
+  free (perm);
+}
+
+// Unrolling of a counter with enable input starting at zero, where the
+// bad state 'all ones' can not be reached within the bound.
+
+static void bmc (void) {
+  int bits = 5 + scale, steps = (1 << bits) - 2, t, b, c, s, n, * bad;
+  int * cur, * nxt, * tmp;
+  cur = malloc (bits * sizeof *cur);
+  nxt = malloc (bits * sizeof *nxt);
+  bad = malloc ((steps + 1) * sizeof *bad);
+  if (!cur || !nxt || !bad) die ("out of memory");
+  n = 0;
+  for (b = 0; b < bits; b++) cur[b] = ++n, add (-cur[b]), add (0);
+  for (t = 0; t <= steps; t++) {
+    bad[t] = ++n;
+    for (b = 0; b < bits; b++) binary (-bad[t], cur[b]);
+    for (b = 0; b < bits; b++) add (-cur[b]);
+    add (bad[t]), add (0);
+    if (t == steps) break;
+    c = ++n;				// enable input
+    for (b = 0; b < bits; b++) {
+      nxt[b] = ++n;
+      xor (nxt[b], cur[b], c);
+      if (b + 1 == bits) break;
+      s = ++n;
+      and (s, cur[b], c);
+      c = s;
+    }
+    tmp = cur, cur = nxt, nxt = tmp;
+  }
+  for (t = 0; t <= steps; t++) add (bad[t]);
+  add (0);
+  free (bad);
+  free (nxt);
+  free (cur);
+}
+
+// Large satisfiable instance with a planted solution, mixed clause length
+// and local variable neighbourhoods, which is easy but stresses parsing,
+// preprocessing and memory.
+
+static void industrial (void) {
+  int n = 100000*scale, m = 4*n, i, j, len, center, idx, lit, sat;
+  const int window = 64;
+  char * sol;
+  if (!(sol = malloc (n + 1))) die ("out of memory");
+  for (i = 1; i <= n; i++) sol[i] = (sign () > 0);
+  for (i = 0; i < m; i++) {
+    j = pick (10);
+    len = j < 3 ? 2 : j < 8 ? 3 : 4 + pick (3);
+    center = 1 + pick (n);
+    sat = 0;
+    for (j = 0; j < len; j++) {
+      idx = center + pick (window) - window/2;
+      if (idx < 1) idx += n;
+      if (idx > n) idx -= n;
+      lit = sign () * idx;
+      if ((lit > 0) == sol[idx]) sat = 1;
+      if (j + 1 == len && !sat) lit = sol[idx] ? idx : -idx;
+      add (lit);
+    }
+    add (0);
+  }
+  free (sol);
+}
+
+/*------------------------------------------------------------------------*/
+
+typedef struct Family { const char * name; void (*gen)(void); } Family;
+
+static Family families[] = {
+  { "ksat", ksat },
+  { "php", php },
+  { "parity", parity },
+  { "bmc", bmc },
+  { "industrial", industrial },
+};
+
+#define NFAMILIES ((int)(sizeof families / sizeof *families))
+
+static void generate (Family * f, const char * path) {
+  FILE * file;
+  int i;
+  reset ();
+  rng = (rng ^ 0x9e3779b9u) + (unsigned) (f - families);
+  f->gen ();
+  if (!(file = fopen (path, "w"))) die ("can not write '%s'", path);
+  fprintf (file, "p cnf %d %d\n", nvars, nclauses);
+  for (i = 0; i < nlits; i++)
+    fprintf (file, lits[i] ? "%d " : "%d\n", lits[i]);
+  fclose (file);
+}
+
+/*------------------------------------------------------------------------*/
+// Just enough of JSON to look up '"<section>":{...,"<key>":<num>,...}'.
+
+static char * slurp (const char * path) {
+  char * res = 0;
+  FILE * file;
+  long bytes;
+  if (!(file = fopen (path, "r"))) return 0;
+  if (!fseek (file, 0, SEEK_END) && (bytes = ftell (file)) > 0 &&
+      !fseek (file, 0, SEEK_SET) && (res = malloc (bytes + 1))) {
+    if (fread (res, 1, bytes, file) != (size_t) bytes) bytes = 0;
+    res[bytes] = 0;
+  }
+  fclose (file);
+  return res;
+}
+
+static double lookup (const char * json,
+                      const char * sec, const char * key) {
+  char pattern[80];
+  const char * p, * end;
+  size_t len;
+  sprintf (pattern, "\"%s\":{", sec);
+  if (!(p = strstr (json, pattern))) return 0;
+  p += strlen (pattern);
+  if (!(end = strchr (p, '}'))) return 0;
+  sprintf (pattern, "\"%s\":", key);
+  len = strlen (pattern);
+  while (p && p < end) {
+    if (!strncmp (p, pattern, len)) return atof (p + len);
+    if ((p = strchr (p, ','))) p++;
+  }
+  return 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+static const char * phases[] = {
+  "search", "preprocessing", "inprocessing",
+  "elim", "probe", "gauss", "card", "sweep", "block",
+};
+
+#define NPHASES ((int)(sizeof phases / sizeof *phases))
+
+typedef struct Result {
+  int res;
+  double wall, process, confs, props, maxmb, times[NPHASES];
+} Result;
+
+static int run (const char * cnf, const char * json, Result * r) {
+  char tlimbuf[20], threadsbuf[20], jsonbuf[256 + 8], * argv[10];
+  double start, deadline;
+  char * buf, * last, * p;
+  int argc, status, i, id;
+  argc = 0;
+  argv[argc++] = (char *) solver;
+  argv[argc++] = "-n";
+  if (threads) {
+    sprintf (threadsbuf, "%d", threads);
+    argv[argc++] = "-t";
+    argv[argc++] = threadsbuf;
+  } else {
+    sprintf (tlimbuf, "%d", timelimit);
+    argv[argc++] = "-T";
+    argv[argc++] = tlimbuf;
+  }
+  sprintf (jsonbuf, "--json=%s", json);
+  argv[argc++] = jsonbuf;
+  argv[argc++] = (char *) cnf;
+  argv[argc] = 0;
+  unlink (json);
+  memset (r, 0, sizeof *r);
+  start = getime ();
+  deadline = start + 2*timelimit + 1;
+  if (!(id = fork ())) {
+    if (!freopen ("/dev/null", "w", stdout)) exit (1);
+    execv (solver, argv);
+    exit (1);
+  }
+  if (id < 0) die ("can not generate child process");
+  while (!waitpid (id, &status, WNOHANG)) {
+    if (getime () > deadline) {
+      kill (id, SIGKILL);
+      waitpid (id, &status, 0);
+      break;
+    }
+    usleep (1000);
+  }
+  r->wall = getime () - start;
+  r->res = WIFEXITED (status) ? WEXITSTATUS (status) : -1;
+  if (!(buf = slurp (json))) return 0;
+  if (threads && (p = strstr (buf, "\"total\":"))) last = p;
+  else {
+    for (last = buf, p = buf; *p; p++)
+      if (p[0] == '\n' && p[1]) last = p + 1;
+  }
+  r->process = lookup (last, "solver", "seconds");
+  r->maxmb = lookup (last, "solver", "maxmb");
+  r->confs = lookup (last, "stats", "confs");
+  r->props = lookup (last, "stats", "props.search");
+  r->props += lookup (last, "stats", "props.simp");
+  r->props += lookup (last, "stats", "props.lkhd");
+  for (i = 0; i < NPHASES; i++)
+    r->times[i] = lookup (last, "times", phases[i]);
+  free (buf);
+  return 1;
+}
+
+static const char * result (int res) {
+  if (res == 10) return "sat";
+  if (res == 20) return "unsat";
+  if (res == 0) return "unknown";
+  return "error";
+}
+
+static double rate (double n, double t) { return t > 0 ? n / t : 0; }
+
+static void header (void) {
+  int i;
+  if (csv) {
+    printf ("family,vars,clauses,result,wall,process,"
+            "confs,props,confs/sec,props/sec,maxmb");
+    for (i = 0; i < NPHASES; i++) printf (",%s", phases[i]);
+  } else {
+    printf ("%-10s %8s %9s %7s %8s %8s %11s %11s %8s",
+            "family", "vars", "clauses", "result", "wall", "process",
+	    "confs/sec", "props/sec", "maxmb");
+    for (i = 0; i < NPHASES; i++) printf (" %6.6s", phases[i]);
+  }
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+static void report (const char * name, int vars, int clauses,
+                    const char * res, Result * r) {
+  int i;
+  if (csv) {
+    printf ("%s,%d,%d,%s,%.3f,%.3f,%.0f,%.0f,%.1f,%.1f,%.1f",
+            name, vars, clauses, res, r->wall, r->process, r->confs,
+	    r->props, rate (r->confs, r->process),
+	    rate (r->props, r->process), r->maxmb);
+    for (i = 0; i < NPHASES; i++) printf (",%.3f", r->times[i]);
+  } else {
+    printf ("%-10s %8d %9d %7s %8.2f %8.2f %11.0f %11.0f %8.1f",
+            name, vars, clauses, res, r->wall, r->process,
+	    rate (r->confs, r->process), rate (r->props, r->process),
+	    r->maxmb);
+    for (i = 0; i < NPHASES; i++) printf (" %6.2f", r->times[i]);
+  }
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+/*------------------------------------------------------------------------*/
+
+static int isnum (const char * str) {
+  const char * p = str;
+  if (!*p) return 0;
+  while (*p) if (*p < '0' || *p++ > '9') return 0;
+  return 1;
+}
+
+static int intarg (int argc, char ** argv, int * iptr) {
+  if (*iptr + 1 >= argc || !isnum (argv[*iptr + 1]))
+    die ("argument to '%s' missing or invalid", argv[*iptr]);
+  return atoi (argv[++*iptr]);
+}
+
+static const char * strarg (int argc, char ** argv, int * iptr) {
+  if (*iptr + 1 >= argc) die ("argument to '%s' missing", argv[*iptr]);
+  return argv[++*iptr];
+}
+
+static int selected (const char * name) {
+  const char * p;
+  size_t len;
+  if (!only) return 1;
+  len = strlen (name);
+  for (p = only; (p = strstr (p, name)); p += len)
+    if ((p == only || p[-1] == ',') && (!p[len] || p[len] == ','))
+      return 1;
+  return 0;
+}
+
+int main (int argc, char ** argv) {
+  char cnf[256], json[256], tmpdir[] = "/tmp/lglbenchXXXXXX";
+  unsigned seed;
+  Result r, sum;
+  int i, j, ok, sumvars, sumclauses;
+  seed = rng;
+  for (i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h")) {
+      printf (
+"usage: lglbench [ <option> ... ]\n"
+"\n"
+"where <option> is one of the following:\n"
+"\n"
+"  -h             print this command line option summary\n"
+"  -s <scale>     size of the generated instances (default %d)\n"
+"  -S <seed>      seed of the generators (default %u)\n"
+"  -f <families>  comma separated list of families (default all)\n"
+"  -b <solver>    solver binary (default './lingeling')\n"
+"  -t <threads>   run './plingeling' (or '<solver>') with these threads\n"
+"  -T <seconds>   time limit per instance (default %d)\n"
+"  -d <dir>       directory for generated files (default temporary)\n"
+"  -k             keep generated files\n"
+"  -g             only generate the instances\n"
+"  -c             comma separated values output\n"
+"\n"
+"families:", scale, seed, timelimit);
+      for (j = 0; j < NFAMILIES; j++) printf (" %s", families[j].name);
+      fputc ('\n', stdout);
+      exit (0);
+    } else if (!strcmp (argv[i], "-s")) scale = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-S")) seed = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-f")) only = strarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-b")) solver = strarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-t")) threads = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-T")) timelimit = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-d")) dir = strarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-k")) keep = 1;
+    else if (!strcmp (argv[i], "-g")) genonly = keep = 1;
+    else if (!strcmp (argv[i], "-c")) csv = 1;
+    else die ("invalid command line option '%s' (try '-h')", argv[i]);
+  }
+  if (scale < 1) die ("expected positive scale");
+  if (timelimit < 1) die ("expected positive time limit");
+  if (!solver) solver = threads ? "./plingeling" : "./lingeling";
+  if (!genonly && access (solver, X_OK))
+    die ("can not execute solver '%s'", solver);
+  for (j = 0; j < NFAMILIES; j++) if (selected (families[j].name)) break;
+  if (j == NFAMILIES) die ("no valid family selected");
+  if (dir) {
+    if (mkdir (dir, 0777) && access (dir, W_OK))
+      die ("can not create directory '%s'", dir);
+  } else if (!(dir = mkdtemp (tmpdir)))
+    die ("can not create temporary directory");
+  if (strlen (dir) > 200) die ("directory name too long");
+  msg ("solver '%s'%s, scale %d, seed %u, time limit %d seconds",
+       solver, threads ? " (plingeling)" : "", scale, seed, timelimit);
+  sprintf (json, "%s/lglbench.json", dir);
+  if (!genonly) header ();
+  memset (&sum, 0, sizeof sum);
+  sumvars = sumclauses = 0;
+  for (j = 0; j < NFAMILIES; j++) {
+    if (!selected (families[j].name)) continue;
+    rng = seed;
+    sprintf (cnf, "%s/%s-s%d.cnf", dir, families[j].name, scale);
+    generate (families + j, cnf);
+    if (genonly) {
+      msg ("generated '%s' with %d variables and %d clauses",
+           cnf, nvars, nclauses);
+      continue;
+    }
+    ok = run (cnf, json, &r);
+    report (families[j].name, nvars, nclauses,
+            ok ? result (r.res) : "failed", &r);
+    sumvars += nvars, sumclauses += nclauses;
+    sum.wall += r.wall, sum.process += r.process;
+    sum.confs += r.confs, sum.props += r.props;
+    if (r.maxmb > sum.maxmb) sum.maxmb = r.maxmb;
+    for (i = 0; i < NPHASES; i++) sum.times[i] += r.times[i];
+    if (!keep) unlink (cnf);
+  }
+  if (!genonly) report ("total", sumvars, sumclauses, "-", &sum);
+  unlink (json);
+  if (!keep) rmdir (dir);
+  free (lits);
+  return 0;
+}
@@ -0,0 +1,45 @@
+#ifndef lglclog_h_INCLUDED
+#define lglclog_h_INCLUDED
+
+/*------------------------------------------------------------------------*/
+// Events of the binary conflict log with their number of arguments and
+// the names of the arguments.  The order of this list determines the
+// binary opcodes and thus new events should only be added at the end.
+//
+//   conflict  level: decision level of the conflict
+//             jlevel: backjump level
+//             glue: real glue of the learned clause
+//             size: size of the learned clause
+//             trail: trail size at the conflict
+//
+//   restart   level: decision level before the restart
+//             target: level kept by trail reuse (equal if skipped)
+//
+//   reduce    collected, retired: removed learned clauses
+//             remaining: large learned clauses left
+
+#define LCLEVENTS \
+LCLEVENT(conflict,5,"level,jlevel,glue,size,trail") \
+LCLEVENT(restart,2,"level,target") \
+LCLEVENT(reduce,3,"collected,retired,remaining")
+
+typedef enum LCLEvent {
+#define LCLEVENT(NAME,ARGS,FIELDS) LCL_ ## NAME,
+LCLEVENTS
+#undef LCLEVENT
+  LCL_NEVENTS
+} LCLEvent;
+
+#define LCLMAXARGS 5
+
+/*------------------------------------------------------------------------*/
+// Conflict logs start with these four bytes followed by the format version
+// as varint.  Each event is encoded as opcode byte followed by the number
+// of conflicts since the previous event and then its arguments, all as
+// unsigned LEB128 varints.
+
+#define LCLVERSION 1
+
+#define LCLMAGIC { 0x8d, 'L', 'C', 'L' }
+
+#endif
@@ -17,7 +17,7 @@
 #define MAXLDFW		31	
 #define REPMOD 		22
 
-#define FUNVAR		12
+#define FUNVAR		14
 #define FUNQUADS	(1<<(FUNVAR - 6))
 #define FALSECNF	(1ll<<32)
 #define TRUECNF		0ll
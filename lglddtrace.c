@@ -22,6 +22,7 @@
 #include <unistd.h>
 
 #include "lglib.h"
+#include "lgltrapi.h"
 
 void lglchkclone (LGL *);
 
@@ -150,23 +151,6 @@ static void msg (const char * fmt, ...) {
   fflush (stdout);
 }
 
-static int isnumstr (const char * str) {
-  const char * p;
-  int ch;
-  if (*(p = str) == '-') p++;
-  if (!isdigit ((int)*p++)) return 0;
-  while (isdigit (ch = *p)) p++;
-  return !ch;
-}
-
-static int intarg (char * op) {
-  const char * tok;
-  if (!(tok = strtok (0, " ")) || !isnumstr (tok) || strtok (0, " "))
-    perr ("expected integer argument for '%s'", op);
-  assert (tok);
-  return atoi (tok);
-}
-
 static int remr (Range * r) { return r->removed <= runs; }
 static int reme (Event * e) { return e->removed <= runs; }
 
@@ -359,12 +343,6 @@ static const char * type2str (Type type) {
   }
 }
 
-static void noarg (Type op) {
-  if (strtok (0, " ")) 
-    perr ("argument after '%s'", type2str (op));
-  event (op, 0, 0);
-}
-
 static void newline (void) {
   int i;
   if (!verbose) return;
@@ -729,8 +707,9 @@ static double getime (void) {
 }
 
 int main (int argc, char ** argv) {
-  int i, len, ch, close = 0, count;
-  char buffer[80], * tok, * opt;
+  int i, len, close = 0, count, op, arg, status;
+  const char * opt;
+  LTR * ltr;
   double start, delta;
   FILE * file;
   start = getime ();
@@ -764,63 +743,53 @@ int main (int argc, char ** argv) {
   }
   if (!file) die ("can not read '%s'", iname);
   msg ("reading %s", iname);
-  buffer[len = 0] = 0;
-  lineno = 1;
+  if (!(ltr = ltrinit (file))) die ("out of memory");
+  if (ltrbinary (ltr)) msg ("binary trace format");
   count = 0;
-NEXT:
-  ch = getc (file);
-  if (ch == EOF) goto DONE;
-  if (ch == '\r') goto NEXT;
-  if (ch != '\n') {
-    if (len + 1 >= (int) sizeof (buffer)) perr ("line buffer exceeded");
-    buffer[len++] = ch;
-    buffer[len] = 0;
-    goto NEXT;
+  while ((status = ltrnext (ltr, &op, &arg, &opt)) > 0) {
+    lineno = ltrlineno (ltr) - 1;
+    if (verbose > 2) msg ("event %d : %s", lineno, ltrcmd2str (op));
+    switch (op) {
+      case LTR_add: event (ADD, arg, 0); break;
+      case LTR_return: event (RETURN, arg, 0); break;
+      case LTR_deref: event (DEREF, arg, 0); break;
+      case LTR_fixed: event (FIXED, arg, 0); break;
+      case LTR_frozen: event (FROZEN, arg, 0); break;
+      case LTR_reusable: event (REUSABLE, arg, 0); break;
+      case LTR_usable: event (USABLE, arg, 0); break;
+      case LTR_repr: event (REPR, arg, 0); break;
+      case LTR_failed: event (FAILED, arg, 0); break;
+      case LTR_assume: event (ASSUME, arg, 0); break;
+      case LTR_init: event (INIT, 0, 0); break;
+      case LTR_sat: event (SAT, 0, 0); break;
+      case LTR_simp: event (SIMP, arg, 0); break;
+      case LTR_setphases: event (SETPHASES, 0, 0); break;
+      case LTR_freeze: event (FREEZE, arg, 0); break;
+      case LTR_setimportant: event (SETIMPORTANT, arg, 0); break;
+      case LTR_setphase: event (SETPHASE, arg, 0); break;
+      case LTR_resetphase: event (RESETPHASE, arg, 0); break;
+      case LTR_melt: event (MELT, arg, 0); break;
+      case LTR_reuse: event (REUSE, arg, 0); break;
+      case LTR_option: event (OPTION, arg, opt); break;
+      case LTR_release: event (RELEASE, 0, 0); break;
+      case LTR_incvar: event (INCVAR, 0, 0); break;
+      case LTR_maxvar: event (MAXVAR, 0, 0); break;
+      case LTR_inconsistent: event (INCONSISTENT, 0, 0); break;
+      case LTR_lkhd: event (LKHD, 0, 0); break;
+      case LTR_fixate: event (FIXATE, 0, 0); break;
+      case LTR_reduce: event (REDUCE, 0, 0); break;
+      case LTR_flush: event (FLUSH, 0, 0); break;
+      case LTR_chkclone: event (CHKCLONE, 0, 0); break;
+      case LTR_changed: event (CHANGED, 0, 0); break;
+      default: perr ("unsupported command '%s'", ltrcmd2str (op)); break;
+    }
+    count++;
+  }
+  if (status < 0) {
+    lineno = ltrlineno (ltr);
+    perr ("%s", ltrerr (ltr));
   }
-  if (verbose > 2) msg ("line %d : %s", lineno, buffer);
-  if (!(tok = strtok (buffer, " "))) perr ("empty line");
-  else if (!strcmp (tok, "add")) event (ADD, intarg ("add"), 0);
-  else if (!strcmp (tok, "return")) event (RETURN, intarg ("return"), 0);
-  else if (!strcmp (tok, "deref")) event (DEREF, intarg ("deref"), 0);
-  else if (!strcmp (tok, "fixed")) event (FIXED, intarg ("fixed"), 0);
-  else if (!strcmp (tok, "frozen")) event (FROZEN, intarg ("frozen"), 0);
-  else if (!strcmp (tok, "reusable")) event (REUSABLE, intarg ("reusable"), 0);
-  else if (!strcmp (tok, "usable")) event (USABLE, intarg ("usable"), 0);
-  else if (!strcmp (tok, "repr")) event (REPR, intarg ("repr"), 0);
-  else if (!strcmp (tok, "failed")) event (FAILED, intarg ("failed"), 0);
-  else if (!strcmp (tok, "assume")) event (ASSUME, intarg ("assume"), 0);
-  else if (!strcmp (tok, "phase")) event (PHASE, intarg ("phase"), 0);
-  else if (!strcmp (tok, "init")) noarg (INIT);
-  else if (!strcmp (tok, "sat")) noarg (SAT);
-  else if (!strcmp (tok, "simp")) event (SIMP, intarg ("simp"), 0);
-  else if (!strcmp (tok, "setphases")) noarg (SETPHASES);
-  else if (!strcmp (tok, "freeze")) event (FREEZE, intarg ("freeze"), 0);
-  else if (!strcmp (tok, "setimportant"))
-    event (SETIMPORTANT, intarg ("setimportant"), 0);
-  else if (!strcmp (tok, "setphase")) event (SETPHASE, intarg ("setphase"), 0);
-  else if (!strcmp (tok, "resetphase"))
-    event (SETPHASE, intarg ("resetphase"), 0);
-  else if (!strcmp (tok, "melt")) event (MELT, intarg ("melt"), 0);
-  else if (!strcmp (tok, "reuse")) event (REUSE, intarg ("reuse"), 0);
-  else if (!strcmp (tok, "option")) {
-    if (!(opt = strtok (0, " "))) perr ("option iname missing");
-    event (OPTION, intarg ("option"), opt);
-  } else if (!strcmp (tok, "release")) noarg (RELEASE);
-  else if (!strcmp (tok, "incvar")) noarg (INCVAR);
-  else if (!strcmp (tok, "maxvar")) noarg (MAXVAR);
-  else if (!strcmp (tok, "inconsistent")) noarg (INCONSISTENT);
-  else if (!strcmp (tok, "lkhd")) noarg (LKHD);
-  else if (!strcmp (tok, "fixate")) noarg (FIXATE);
-  else if (!strcmp (tok, "reduce")) noarg (REDUCE);
-  else if (!strcmp (tok, "flush")) noarg (FLUSH);
-  else if (!strcmp (tok, "chkclone")) noarg (CHKCLONE);
-  else if (!strcmp (tok, "changed")) noarg (CHANGED);
-  else perr ("invalid command '%s'", tok);
-  lineno++;
-  count++;
-  len = 0;
-  goto NEXT;
-DONE:
+  ltrelease (ltr);
   if(close == 1) fclose (file);
   if(close == 2) pclose (file);
   msg ("parsed %d events in %s", count, iname);
@@ -8,6 +8,8 @@
 
 #include "lglconst.h"
 #include "lglopts.h"
+#include "lgltrapi.h"
+#include "lglclog.h"
 
 /*-------------------------------------------------------------------------*/
 
@@ -15,6 +17,7 @@
 #include <ctype.h>
 #include <limits.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -22,9 +25,23 @@
 #include <string.h>
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include <stddef.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define LGLTSC
+#endif
+
+#if defined(__linux__) && !defined(NLGLPERF)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define LGLPERF
+#endif
+
 /*-------------------------------------------------------------------------*/
 
 #ifndef NLGLYALSAT
@@ -243,10 +260,10 @@ do { \
 
 /*------------------------------------------------------------------------*/
 
-#define TRAPI(MSG,ARGS...) \
+#define TRAPI(CMD,ARGS...) \
 do { \
   if (!lgl->apitrace) break; \
-  lgltrapi (lgl, MSG, ##ARGS); \
+  lgltrapi (lgl, LTR_ ## CMD, ##ARGS); \
 } while (0)
 
 #define LGLCHKACT(ACT) \
@@ -255,13 +272,18 @@ do { assert (NOTALIT <= (ACT) && (ACT) < REMOVED - 1); } while (0)
 /*------------------------------------------------------------------------*/
 
 #define NEW(P,N) \
-do { (P) = lglnew (lgl, (N) * sizeof *(P)); } while (0)
+do { \
+  (P) = lglnewcat (lgl, lglmemcat (lgl, &(P)), (N) * sizeof *(P)); \
+} while (0)
 
 #define DEL(P,N) \
 do { lgldel (lgl, (P), (N) * sizeof *(P)); (P) = 0; } while (0)
 
 #define RSZ(P,O,N) \
-do { (P) = lglrsz (lgl, (P), (O)*sizeof*(P), (N)*sizeof*(P)); } while (0)
+do { \
+  (P) = lglrszcat (lgl, (P) ? 0 : lglmemcat (lgl, &(P)), \
+                   (P), (O)*sizeof*(P), (N)*sizeof*(P)); \
+} while (0)
 
 #define CLN(P,N) \
 do { memset ((P), 0, (N) * sizeof *(P)); } while (0)
@@ -384,9 +406,14 @@ do { \
 
 /*------------------------------------------------------------------------*/
 
+#define CLONEMEMCAT(PTR) \
+do { lgl->memcat = (PTR) ? lglptrmemcat (orig, PTR) : 0; } while (0)
+
 #define CLONE(FIELD,SIZE) \
 do { \
+  CLONEMEMCAT (orig->FIELD); \
   NEW (lgl->FIELD, (SIZE)); \
+  lgl->memcat = 0; \
   memcpy (lgl->FIELD, orig->FIELD, (SIZE) * sizeof *(lgl->FIELD)); \
 } while (0)
 
@@ -395,7 +422,9 @@ do { \
   size_t COUNT = orig->NAME.top - orig->NAME.start; \
   size_t SIZE = orig->NAME.end - orig->NAME.start; \
   size_t BYTES = SIZE * sizeof *lgl->NAME.start; \
+  CLONEMEMCAT (orig->NAME.start); \
   NEW (lgl->NAME.start, SIZE); \
+  lgl->memcat = 0; \
   memcpy (lgl->NAME.start, orig->NAME.start, BYTES); \
   lgl->NAME.top = lgl->NAME.start + COUNT; \
   lgl->NAME.end = lgl->NAME.start + SIZE; \
@@ -503,7 +532,7 @@ typedef struct PSz { int pos, size; } PSz;
 typedef struct RNG { unsigned z, w; } RNG;
 typedef struct Stk { int * start, * top, * end; } Stk;
 typedef struct Timer { double start; int idx, ign; } Timer;
-typedef struct Timers { Timer stk[MAXPHN]; int nest; } Timers;
+typedef struct Timers { Timer stk[MAXPHN]; int nest, backend, perf; } Timers;
 typedef struct Trv { void * state; void (*trav)(void *, int); } Trv;
 typedef struct TVar { signed int val : 30; unsigned mark : 2; } TVar;
 typedef struct Wtk { struct Work * start, * top, * end; } Wtk;
@@ -588,7 +617,7 @@ typedef struct AVar {
 
 typedef struct Ext {
   unsigned equiv:1,melted:1,blocking:2,eliminated:1,tmpfrozen:1,imported:1;
-  unsigned assumed:2,failed:2,aliased:1,important:1;
+  unsigned assumed:2,failed:2,aliased:1,important:1,extended:1;
   signed int val:2, oldval:2;
   int repr, frozen;
 } Ext;
@@ -646,6 +675,60 @@ static const char * featurenames[] = {
 };
 
 /*------------------------------------------------------------------------*/
+// Allocations are tagged with one of these categories, which is kept in a
+// small header in front of each block.  Thus deallocations and
+// reallocations are attributed to the same category as the allocation.
+
+#define MEMCATS \
+MEMCAT(core) \
+MEMCAT(variables) \
+MEMCAT(external) \
+MEMCAT(extend) \
+MEMCAT(irredundant) \
+MEMCAT(redundant) \
+MEMCAT(watches) \
+MEMCAT(search) \
+MEMCAT(elim) \
+MEMCAT(gauss) \
+MEMCAT(simplify) \
+MEMCAT(other)
+
+typedef enum MemCat {
+#define MEMCAT(NAME) MEM_ ## NAME,
+MEMCATS
+#undef MEMCAT
+  NMEMCATS
+} MemCat;
+
+static const char * memcatnames[] = {
+#define MEMCAT(NAME) #NAME,
+MEMCATS
+#undef MEMCAT
+};
+
+typedef struct MemCnt { size_t current, max; } MemCnt;
+
+/*------------------------------------------------------------------------*/
+
+#ifdef LGLSHAPE
+// Shape statistics are only collected if compiled with '-DLGLSHAPE'
+// (configure with '--shape').  Watch list lengths (the 'count' field of
+// 'HTS') are bucketed logarithmically, i.e., bucket 'i > 0' contains
+// lengths from '2^(i-1)' to '2^i - 1'.  The blocking literal counters are
+// indexed by the tag of the watch and count how often the blocking literal
+// alone satisfied the clause during search propagation.
+
+#define SHAPEBUCKETS 16
+
+typedef struct Shape {
+  struct { int64_t props, visits; } wchs[SHAPEBUCKETS];
+  struct { int64_t blit[LRGCS + 1], updated; } blocked;
+} Shape;
+
+#define SHAPEINC(FIELD) do { lgl->stats->shape.FIELD++; } while (0)
+#else
+#define SHAPEINC(FIELD) do { } while (0)
+#endif
 
 typedef struct Stats {
   int64_t agility;
@@ -676,7 +759,7 @@ typedef struct Stats {
   struct { int64_t sat, mosat, simp, deref, fixed, freeze, lkhd;
 	   int64_t melt, add, assume, cassume, failed, repr; } calls;
   struct { int64_t search, simp, lkhd; } props, visits;
-  struct { size_t current, max; } bytes;
+  MemCnt bytes, mem[NMEMCATS];
   struct { int bin, trn, lrg; } red;
   struct { int cnt, simple, trn, lrg, sub; } hbr;
   struct { int current, sum; } fixed, equiv;
@@ -690,6 +773,8 @@ typedef struct Stats {
     struct { int count, failed, lifted; int64_t probed, steps; } treelook;
   } prb;
   struct { int count, red, failed; int64_t lits, bins, steps; } trd;
+  struct { int count;
+           int64_t clauses, subsumed, strengthened, red, steps; } subs;
   struct { int removed, red; } bindup;
   struct { int count, rounds;
 	   struct { int trds, failed, sccs; int64_t sumsccsizes; } stamp;
@@ -701,6 +786,8 @@ typedef struct Stats {
   struct {
     int count, elmd, pure, large, sub, str, blkd, rounds;
     struct { int elm, tried, failed; } small;
+    struct { int equiv, and, ite, xor; } gates;
+    struct { int64_t batches, cands, passed, deferred; } par;
     int64_t resolutions, copies, subchks, strchks, ipos, steps; } elm;
   struct {
     int sub2, sub3, subl, str2, str3, str3self, strl, strlself;
@@ -747,6 +834,7 @@ typedef struct Stats {
     } card;
   struct { int64_t bin, trn; } moved;
   struct { int count; int64_t added, skipped, steps; } bca;
+  struct { int count; int64_t vars, added, removed, steps; } bva;
   struct { 
     struct {
       int64_t produced; 
@@ -771,6 +859,7 @@ typedef struct Stats {
     struct { int64_t classes, envs; } sumsize;
     struct { int64_t total;
 	     struct { int64_t count, sat, unsat; } type[3]; } queries;
+    struct { int64_t count, gates, classes, refined; } sim;
   } sweep;
   struct { int64_t count; int max, min; } setscincf;
   struct { int64_t tried, locked; } promote;
@@ -778,6 +867,9 @@ typedef struct Stats {
   struct { int64_t flushed, sorted; } queue;
   struct { int64_t count, lits; } bump;
   struct { int64_t count; EMA avg; int changed, level; } stability;
+#ifdef LGLSHAPE
+  Shape shape;
+#endif
 } Stats;
 
 /*------------------------------------------------------------------------*/
@@ -788,6 +880,7 @@ typedef struct Times {
 #define TIMESLEVEL0     lookahead
     double elim, transred, block, unhide, ternres;              // level 1
     double gauss, quatres, card, cce, bca, locs, sweep;         // level 1
+    double subsume, bva;                                        // level 1
     double showscoredist, showfeatures, prune;                  // level 1
     double probe;///////PUT NOTHING HERE!                       // level 1
 #define TIMESLEVEL1     probe
@@ -808,6 +901,19 @@ typedef struct Times {
 #define TIMESLEVEL2IDX (&(((Times*)0)->TIMESLEVEL2)- &((Times*)0)->all)
 #define TIMESLEVEL3IDX (&(((Times*)0)->TIMESLEVEL3)- &((Times*)0)->all)
 
+#define NPHASES ((int)(sizeof (Times) / sizeof (double)))
+
+/*------------------------------------------------------------------------*/
+// Hardware performance counters accumulated per phase along the timers.
+
+enum { PERFCYCLES, PERFINSTRS, PERFCACHE, PERFBRANCH, NPERF };
+
+typedef struct Perf {
+  int fd[NPERF], slot[NPERF], nslots;
+  int64_t start[MAXPHN][NPERF];
+  int64_t ctrs[NPHASES][NPERF];
+} Perf;
+
 /*------------------------------------------------------------------------*/
 
 typedef struct Del { int cur, rem; } Del;
@@ -825,7 +931,7 @@ typedef struct Limits {
   struct { struct { int64_t otfs, confs; } vars; } rescore;
   struct { int pen; Del del; int64_t steps, irrprgss; } elm, blk;
   struct { int pen; Del del; int64_t steps; }
-    trd, unhd, ternres, quatres, cce, card, sweep;
+    trd, unhd, ternres, quatres, cce, card, sweep, subs, bva;
   struct { int pen; Del del; struct { int64_t extr, elim; } steps; } gauss;
   struct { int64_t confs; } restart;
   struct { int64_t steps; 
@@ -841,6 +947,7 @@ typedef struct Limits {
   struct { int64_t confs, inc; int vars; } locs;
   struct { int redlarge, reset; } reduce;
   struct { int64_t decisions, inc; } prune;
+  struct { int64_t confs; } statsnap;
 } Limits;
 
 /*------------------------------------------------------------------------*/
@@ -861,6 +968,8 @@ typedef struct Cbs {
     struct { void (*fun)(void*,int,int); void * state; } unlock;
   } eqs;
   struct { void(*lock)(void*); void (*unlock)(void*); void*state; } msglock;
+  struct { void (*fun)(void*,int); void * state; } query;
+  struct { void (*fun)(void*,LGL*); void * state; } statsnap;
   double (*getime)(void);
   void (*onabort)(void *); void * abortstate;
 } Cbs;
@@ -871,8 +980,10 @@ typedef struct Dis { struct { Stk bin, trn; } red, irr; } Dis;
 
 typedef struct Elm {
   int64_t oldsteps;
-  int pivot, negcls, necls, neglidx, round, oldelmd;
-  Stk lits, next, clv, csigs, sizes, occs, noccs, mark, m2i;
+  int pivot, negcls, necls, neglidx, round, oldelmd, gate, funquads;
+  int nfuns;
+  Fun * funs;
+  Stk lits, next, clv, csigs, sizes, occs, noccs, mark, m2i, gatecls;
   struct { Stk stk; int * pos, mt, nvars; } touched;
   int bkwdocclim;
 } Elm;
@@ -909,13 +1020,17 @@ typedef struct SWP {
   Stk partition;
   struct { int64_t classes, envs; } sumsize;
   struct { int count; struct { int a, b; } cached; Stk stk; } decision;
+  struct { uint64_t * vals, * mask; int words; } sim;
 } SWP;
 
 typedef struct Tlk { Stk stk, seen; TVar * tvars; LKHD * lkhd; } Tlk;
 
+typedef struct MemBlk { const void * ptr; int cat; } MemBlk;
+
 typedef struct Mem {
   void * state;
   lglalloc alloc; lglrealloc realloc; lgldealloc dealloc;
+  MemBlk * blks; size_t nblks, szblks;
 } Mem;
 
 typedef struct Wchs { Stk stk; unsigned start[MAXLDFW]; int free; } Wchs;
@@ -927,15 +1042,47 @@ typedef struct Wrk {
 
 typedef struct Queue { Stk stk; int mt, next, sorted; } Queue;
 
+#define TRAPIBUFSIZE (1<<16)
+
+typedef struct Trapi {
+  FILE * file;
+  unsigned char * buf[2];
+  size_t count, pending;
+  int current, async, stop, failed, warned;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+} Trapi;
+
+#define CLOGBUFSIZE (1<<16)
+#define CLOGBUFS 8
+
+typedef struct Classifier {
+  char ** names;
+  int npresets, szpresets;
+  Stk settings, nodes, points;
+} Classifier;
+
+typedef struct Clog {
+  FILE * file;
+  unsigned char * buf[CLOGBUFS];
+  size_t count[CLOGBUFS];
+  int head, tail, pending, stop, failed;
+  int64_t confs, events, bytes, stalls;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+} Clog;
+
 /*------------------------------------------------------------------------*/
 
 struct LGL {
   State state;
 
   int probing, tid, tids;
-  int nvars, szvars, maxext, szext, changed, mt, repcntdown;
+  int nvars, szvars, maxext, szext, ndefs, changed, mt, repcntdown;
   int szdrail, next, next2, flushed, level, alevel, wait, glag;
-  int unassigned, lrgluereasons, failed, assumed;
+  int unassigned, lrgluereasons, failed, assumed, extidxed;
 
   Flt scinc, scincf, maxscore, minscore;
   int scincinc;
@@ -963,6 +1110,7 @@ struct LGL {
   Stats * stats;
   Times * times;
   Timers * timers;
+  Perf * perf;
   Limits * limits;
   Ext * ext;
   int * i2e;
@@ -982,6 +1130,7 @@ struct LGL {
   int prevglue;
 #endif
   Stk clause, eclause, extend, irr, trail, frames, promote;
+  Stk extseg, exthead, extlim;
   Stk eassume, assume, learned;
   Stk dsched;
 #ifndef NCHKSOL
@@ -1004,9 +1153,15 @@ struct LGL {
   char closeapitrace;
   FILE * out;
   FILE * apitrace;
+  Trapi * trapi;
+  Clog * clog;
+  Classifier * classifier;
   FILE * trace;
+  FILE * timeline;
+  int timelined;
   char * prefix;
   Cbs * cbs;
+  int memcat;
 
   LGL * clone;
 
@@ -1216,6 +1371,9 @@ static void lgldie (LGL * lgl, const char * msg, ...) {
   exit (0);
 }
 
+static void lglflushtrapi (LGL *, int);
+static void lglflushclog (LGL *);
+
 static void lglabort (LGL * lgl) {
   if (!lgl) exit (1);
   if (lgl->opts && lgl->opts->sleeponabort.val) {
@@ -1226,6 +1384,8 @@ static void lglabort (LGL * lgl) {
     fflush (stderr);
     sleep (lgl->opts->sleeponabort.val);
   }
+  if (lgl->trapi) lglflushtrapi (lgl, 1);
+  if (lgl->clog) lglflushclog (lgl);
   if (lgl->cbs && lgl->cbs->onabort)
     lgl->cbs->onabort (lgl->cbs->abortstate);
   if (lgl->opts && lgl->opts->exitonabort.val) exit (1);
@@ -1296,10 +1456,80 @@ double lglprocesstime (void) {
   return res;
 }
 
+/*------------------------------------------------------------------------*/
+// Wall-clock timer backends for phase profiling, which are much cheaper
+// than 'getrusage'.  Both are measured relative to a common origin.  The
+// time stamp counter is only used if it is invariant and then calibrated
+// once per process against the monotonic clock, otherwise we fall back to
+// the monotonic clock.
+
+#ifdef CLOCK_MONOTONIC_RAW
+#define LGLMONOTONIC CLOCK_MONOTONIC_RAW
+#else
+#define LGLMONOTONIC CLOCK_MONOTONIC
+#endif
+
+static pthread_once_t lgltimeonce = PTHREAD_ONCE_INIT;
+static double lgltimeorigin;
+
+#ifdef LGLTSC
+static unsigned long long lgltscorigin;
+static double lgltscsecs;
+#endif
+
+static double lglclocktime (void) {
+  struct timespec ts;
+  if (clock_gettime (LGLMONOTONIC, &ts)) return 0;
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+#ifdef LGLTSC
+static int lglinvarianttsc (void) {
+  unsigned eax, ebx, ecx, edx;
+  if (!__get_cpuid (0x80000000, &eax, &ebx, &ecx, &edx)) return 0;
+  if (eax < 0x80000007) return 0;
+  if (!__get_cpuid (0x80000007, &eax, &ebx, &ecx, &edx)) return 0;
+  return (edx >> 8) & 1;
+}
+#endif
+
+static void lglinitime (void) {
+#ifdef LGLTSC
+  unsigned long long end;
+  double time;
+#endif
+  lgltimeorigin = lglclocktime ();
+#ifdef LGLTSC
+  if (!lglinvarianttsc ()) return;
+  lgltscorigin = __rdtsc ();
+  do time = lglclocktime (); while (time - lgltimeorigin < 0.01);
+  end = __rdtsc ();
+  if (end <= lgltscorigin) return;
+  lgltscsecs = (time - lgltimeorigin) / (end - lgltscorigin);
+#endif
+}
+
+static double lglmonotonictime (void) {
+  pthread_once (&lgltimeonce, lglinitime);
+  return lglclocktime () - lgltimeorigin;
+}
+
+static double lgltsctime (void) {
+  pthread_once (&lgltimeonce, lglinitime);
+#ifdef LGLTSC
+  if (lgltscsecs) return (__rdtsc () - lgltscorigin) * lgltscsecs;
+#endif
+  return lglclocktime () - lgltimeorigin;
+}
+
 static double lglgetime (LGL * lgl) {
   lgl->stats->times++;
   if (lgl->cbs && lgl->cbs->getime) return lgl->cbs->getime ();
-  else return lglprocesstime ();
+  switch (lgl->timers->backend) {
+    case 2: return lgltsctime ();
+    case 1: return lglmonotonictime ();
+    default: return lglprocesstime ();
+  }
 }
 
 static int lglprofidx (LGL * lgl, double * timestatsptr) {
@@ -1328,22 +1558,178 @@ static int lglignprofptr (LGL * lgl, double * timestatsptr) {
   return lglignprofidx (lgl, lglprofidx (lgl, timestatsptr));
 }
 
+/*------------------------------------------------------------------------*/
+// The counters are opened once as one group for the calling thread when
+// the outermost timer is started the first time with 'perf' enabled, and
+// all of them are then read with a single system call.  If the leading
+// cycle counter can not be opened, counting is disabled.
+
+static void lglinitperf (LGL *);
+
+static int lglreadperf (LGL * lgl, int64_t * ctrs) {
+#ifdef LGLPERF
+  uint64_t buf[NPERF + 1];
+  Perf * perf = lgl->perf;
+  ssize_t bytes;
+  int i;
+  assert (perf && perf->nslots);
+  bytes = read (perf->fd[0], buf, sizeof buf);
+  if (bytes < (ssize_t) ((perf->nslots + 1) * sizeof *buf)) return 0;
+  for (i = 0; i < NPERF; i++)
+    ctrs[i] = perf->slot[i] < 0 ? 0 : (int64_t) buf[1 + perf->slot[i]];
+  return 1;
+#else
+  (void) lgl, (void) ctrs;
+  return 0;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+// Timeline in the Chrome trace event format, which can be loaded into
+// 'chrome://tracing' or 'ui.perfetto.dev'.  Every phase which is not
+// ignored by the 'profile' level becomes a slice, restarts are instant
+// events, and conflicts, learned clauses and allocated memory are sampled
+// as counters after restarts and phases up to level one.  The track is
+// given by the id set with 'lglsetid'.  Time stamps are always taken
+// from the monotonic wall clock independent of the 'timer' option.  Each
+// event is written with a single 'fprintf' and thus solvers running in
+// different threads can share the same file.
+
+#define TIMEIDX(NAME) ((int)(&((Times*)0)->NAME - &((Times*)0)->all))
+
+static const char * lglphasename (int idx) {
+#define PHASENAME(NAME) \
+  do { if (idx == TIMEIDX (NAME)) return # NAME; } while (0)
+  PHASENAME (all);
+  PHASENAME (search);
+  PHASENAME (preprocessing);
+  PHASENAME (inprocessing);
+  PHASENAME (lookahead);
+  PHASENAME (elim);
+  PHASENAME (transred);
+  PHASENAME (block);
+  PHASENAME (unhide);
+  PHASENAME (ternres);
+  PHASENAME (gauss);
+  PHASENAME (quatres);
+  PHASENAME (card);
+  PHASENAME (cce);
+  PHASENAME (bca);
+  PHASENAME (locs);
+  PHASENAME (sweep);
+  PHASENAME (subsume);
+  PHASENAME (bva);
+  PHASENAME (showscoredist);
+  PHASENAME (showfeatures);
+  PHASENAME (prune);
+  PHASENAME (probe);
+  PHASENAME (prb.simple);
+  PHASENAME (prb.basic);
+  PHASENAME (prb.treelook);
+  PHASENAME (quatres1);
+  PHASENAME (quatres2);
+  PHASENAME (gc);
+  PHASENAME (decompose);
+  PHASENAME (queuesort);
+  PHASENAME (phase);
+  PHASENAME (backward);
+  PHASENAME (restart);
+  PHASENAME (defrag);
+  PHASENAME (reduce);
+  PHASENAME (analysis);
+  PHASENAME (decide);
+  PHASENAME (bump);
+  PHASENAME (mincls);
+  PHASENAME (druplig);
+  PHASENAME (redcls);
+  PHASENAME (queuedecision);
+  PHASENAME (heapdecision);
+  PHASENAME (subl);
+#undef PHASENAME
+  return "unknown";
+}
+
+static int lgltimelinetid (LGL * lgl) { return lgl->tid < 0 ? 0 : lgl->tid; }
+
+static double lgltimelinets (void) { return 1e6 * lglmonotonictime (); }
+
+static void lgltimelinename (LGL * lgl) {
+  int tid;
+  if (lgl->timelined) return;
+  lgl->timelined = 1;
+  tid = lgltimelinetid (lgl);
+  fprintf (lgl->timeline,
+    ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+    "\"args\":{\"name\":\"solver %d\"}}", tid, tid);
+}
+
+static void lgltimelinephase (LGL * lgl, char ph, int idx) {
+  lgltimelinename (lgl);
+  fprintf (lgl->timeline,
+    ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%d}",
+    lglphasename (idx), ph, lgltimelinets (), lgltimelinetid (lgl));
+}
+
+static void lgltimelinecounters (LGL * lgl) {
+  Stats * s = lgl->stats;
+  int tid = lgltimelinetid (lgl);
+  fprintf (lgl->timeline,
+    ",\n{\"name\":\"solver %d\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":0,"
+    "\"id\":%d,\"args\":{\"conflicts\":%lld,\"learned\":%lld,"
+    "\"MB\":%.1f}}",
+    tid, lgltimelinets (), tid, (LGLL) s->confs,
+    (LGLL) s->red.bin + s->red.trn + s->red.lrg,
+    s->bytes.current / (double)(1<<20));
+}
+
+static void lgltimelinerestart (LGL * lgl) {
+  if (!lgl->timeline) return;
+  lgltimelinename (lgl);
+  fprintf (lgl->timeline,
+    ",\n{\"name\":\"restart\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+    "\"pid\":0,\"tid\":%d}",
+    lgltimelinets (), lgltimelinetid (lgl));
+  lgltimelinecounters (lgl);
+}
+
+void lglsetimeline (LGL * lgl, FILE * file) {
+  REQINIT ();
+  lgl->timeline = file;
+  lgl->timelined = 0;
+  if (!file || ftell (file)) return;
+  fputs ("[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,"
+         "\"args\":{\"name\":\"lingeling\"}}", file);
+}
+
 static void lglstart (LGL * lgl, double * timestatsptr) {
   Timer * timer;
   int ign, idx;
   idx = lglprofidx (lgl, timestatsptr);
   ign = lglignprofidx (lgl, idx);
   assert (lgl->timers->nest < MAXPHN);
+  if (!lgl->timers->nest) {
+    lgl->timers->backend = lgl->opts->timer.val;
+    if (lgl->opts->perf.val && !lgl->perf) lglinitperf (lgl);
+    lgl->timers->perf = lgl->opts->perf.val && lgl->perf->nslots;
+  }
   timer = lgl->timers->stk + lgl->timers->nest++;
   timer->idx = idx;
   if ((timer->ign = ign)) timer->start = 0;
-  else timer->start = lglgetime (lgl);
+  else {
+    if (lgl->timeline) lgltimelinephase (lgl, 'B', idx);
+    timer->start = lglgetime (lgl);
+    if (lgl->timers->perf &&
+        !lglreadperf (lgl, lgl->perf->start[lgl->timers->nest - 1]))
+      lgl->timers->perf = 0;
+  }
 }
 
 void lglflushtimers (LGL * lgl) {
   double time = lglgetime (lgl), delta, entered, * ptr;
+  int64_t ctrs[NPERF], * start, * sum;
   Timer * timer;
-  int nest;
+  int nest, perf, i;
+  perf = lgl->timers->perf && lglreadperf (lgl, ctrs);
   for (nest = 0; nest < lgl->timers->nest; nest++) {
     timer = lgl->timers->stk + nest;
     if (timer->ign) continue;
@@ -1353,6 +1739,13 @@ void lglflushtimers (LGL * lgl) {
     if (delta < 0) delta = 0;
     ptr = timer->idx + (double*)lgl->times;
     *ptr += delta;
+    if (!perf) continue;
+    start = lgl->perf->start[nest];
+    sum = lgl->perf->ctrs[timer->idx];
+    for (i = 0; i < NPERF; i++) {
+      sum[i] += ctrs[i] - start[i];
+      start[i] = ctrs[i];
+    }
   }
 }
 
@@ -1366,7 +1759,13 @@ static void lglstop (LGL * lgl) {
   Timer * timer;
   assert (lgl->timers->nest > 0);
   timer = lgl->timers->stk + lgl->timers->nest - 1;
-  if (!timer->ign) lglflushtimers (lgl);
+  if (!timer->ign) {
+    lglflushtimers (lgl);
+    if (lgl->timeline) {
+      lgltimelinephase (lgl, 'E', timer->idx);
+      if (timer->idx <= TIMESLEVEL1IDX) lgltimelinecounters (lgl);
+    }
+  }
   lgl->timers->nest--;
   assert (lgl->timers->nest >= 0);
 }
@@ -1379,11 +1778,16 @@ void lglsetid (LGL * lgl, int tid, int tids) {
   ABORTIF (tid >= tids, "id exceed number of ids");
   lgl->tid = tid;
   lgl->tids = tids;
+  lgl->timelined = 0;
 }
 
 /*------------------------------------------------------------------------*/
 
-static void lglinc (LGL * lgl, size_t bytes) {
+static void lglinc (LGL * lgl, int cat, size_t bytes) {
+  MemCnt * cnt = lgl->stats->mem + cat;
+  assert (0 <= cat && cat < NMEMCATS);
+  cnt->current += bytes;
+  if (cnt->max < cnt->current) cnt->max = cnt->current;
   lgl->stats->bytes.current += bytes;
   if (lgl->stats->bytes.max < lgl->stats->bytes.current) {
     lgl->stats->bytes.max = lgl->stats->bytes.current;
@@ -1391,51 +1795,291 @@ static void lglinc (LGL * lgl, size_t bytes) {
   }
 }
 
-static void lgldec (LGL * lgl, size_t bytes) {
+static void lgldec (LGL * lgl, int cat, size_t bytes) {
+  assert (0 <= cat && cat < NMEMCATS);
+  assert (lgl->stats->mem[cat].current >= bytes);
+  lgl->stats->mem[cat].current -= bytes;
   assert (lgl->stats->bytes.current >= bytes);
   lgl->stats->bytes.current -= bytes;
 }
 
-static void * lglnew (LGL * lgl, size_t bytes) {
-  void * res;
+#define OWNS(FIELD) \
+  ((const char*) &lgl->FIELD <= p && p < (const char*) (&lgl->FIELD + 1))
+
+// Classify by the address of the pointer which receives the allocated
+// block if it is a field of 'lgl', and otherwise by the innermost phase
+// running.  The latter covers temporary and local allocations.
+
+static int lglmemcat (LGL * lgl, void * owner) {
+  const char * p = owner;
+  Timer * t;
+  int idx;
+  if (lgl->memcat) return lgl->memcat;
+  if ((const char*) lgl <= p && p < (const char*) (lgl + 1)) {
+    if (OWNS (times) || OWNS (timers) || OWNS (perf) || OWNS (limits) ||
+        OWNS (fltstr) || OWNS (cbs) || OWNS (trapi) || OWNS (prefix))
+      return MEM_core;
+    if (OWNS (i2e) || OWNS (doms) || OWNS (dvars) || OWNS (qvars) ||
+        OWNS (avars) || OWNS (vals) || OWNS (jwh) || OWNS (drail) ||
+	OWNS (repr) || OWNS (queue))
+      return MEM_variables;
+    if (OWNS (ext) || OWNS (eclause) || OWNS (eassume)
+#ifndef NCHKSOL
+        || OWNS (orig)
+#endif
+       )
+      return MEM_external;
+    if (OWNS (extend) || OWNS (extseg) || OWNS (exthead) || OWNS (extlim))
+      return MEM_extend;
+    if (OWNS (irr)) return MEM_irredundant;
+    if (OWNS (red)) return MEM_redundant;
+    if (OWNS (wchs)) return MEM_watches;
+    if (OWNS (control) || OWNS (clause) || OWNS (trail) ||
+        OWNS (frames) || OWNS (promote) || OWNS (assume) ||
+	OWNS (learned) || OWNS (dsched) || OWNS (poisoned) ||
+	OWNS (seen) || OWNS (minstk) || OWNS (lcaseen)
+#ifndef NDEBUG
+        || OWNS (prevclause)
+#endif
+       )
+      return MEM_search;
+  } else if (lgl->red && (const char*) lgl->red <= p &&
+             p < (const char*)(lgl->red + MAXGLUE + 1))
+    return MEM_redundant;
+  else if (lgl->wchs && (const char*) lgl->wchs <= p &&
+           p < (const char*)(lgl->wchs + 1))
+    return MEM_watches;
+  if (!lgl->timers) return MEM_other;
+  for (t = lgl->timers->stk + lgl->timers->nest - 1;
+       t >= lgl->timers->stk;
+       t--) {
+    idx = t->idx;
+    if (idx == TIMEIDX (elim)) return MEM_elim;
+    if (idx == TIMEIDX (gauss)) return MEM_gauss;
+    if (idx == TIMEIDX (preprocessing)) return MEM_simplify;
+    if (idx == TIMEIDX (inprocessing)) return MEM_simplify;
+    if (idx == TIMEIDX (search)) return MEM_search;
+  }
+  return MEM_other;
+}
+
+#undef OWNS
+
+// The memory category of each allocated block is kept in a hash table
+// with linear probing on the solver side.  Thus external memory managers
+// see exactly the sizes of the blocks (see 'lglib.h').  The table itself
+// is allocated directly and counted as 'core' memory.
+
+static size_t lglmemblkpos (Mem * mem, const void * ptr) {
+  size_t res = (size_t) ptr >> 3;
+  res *= 2654435761u;
+  res ^= res >> 15;
+  return res & (mem->szblks - 1);
+}
+
+static void lglenlmemblks (LGL * lgl) {
+  Mem * mem = lgl->mem;
+  size_t oldsz = mem->szblks, newsz = oldsz ? 2*oldsz : 256, i, pos;
+  MemBlk * old = mem->blks, * new;
+  new = mem->alloc ? mem->alloc (mem->state, newsz * sizeof *new)
+                   : malloc (newsz * sizeof *new);
+  if (!new) lgldie (lgl, "out of memory allocating memory block table");
+  memset (new, 0, newsz * sizeof *new);
+  mem->blks = new;
+  mem->szblks = newsz;
+  for (i = 0; i < oldsz; i++) {
+    if (!old[i].ptr) continue;
+    pos = lglmemblkpos (mem, old[i].ptr);
+    while (new[pos].ptr) pos = (pos + 1) & (newsz - 1);
+    new[pos] = old[i];
+  }
+  if (old) {
+    if (mem->dealloc) mem->dealloc (mem->state, old, oldsz * sizeof *old);
+    else free (old);
+    lgldec (lgl, MEM_core, oldsz * sizeof *old);
+  }
+  lglinc (lgl, MEM_core, newsz * sizeof *new);
+}
+
+static void lglrelmemblks (LGL * lgl) {
+  Mem * mem = lgl->mem;
+  if (!mem->blks) return;
+  lgldec (lgl, MEM_core, mem->szblks * sizeof *mem->blks);
+  if (mem->dealloc)
+    mem->dealloc (mem->state, mem->blks, mem->szblks * sizeof *mem->blks);
+  else free (mem->blks);
+  mem->blks = 0;
+  mem->nblks = mem->szblks = 0;
+}
+
+static void lglsetmemcat (LGL * lgl, const void * ptr, int cat) {
+  Mem * mem = lgl->mem;
+  size_t pos;
+  assert (ptr);
+  if (2*(mem->nblks + 1) > mem->szblks) lglenlmemblks (lgl);
+  pos = lglmemblkpos (mem, ptr);
+  while (mem->blks[pos].ptr) {
+    assert (mem->blks[pos].ptr != ptr);
+    pos = (pos + 1) & (mem->szblks - 1);
+  }
+  mem->blks[pos].ptr = ptr;
+  mem->blks[pos].cat = cat;
+  mem->nblks++;
+}
+
+static size_t lglfindmemblk (Mem * mem, const void * ptr) {
+  size_t pos = lglmemblkpos (mem, ptr);
+  while (mem->blks[pos].ptr != ptr) {
+    assert (mem->blks[pos].ptr);
+    pos = (pos + 1) & (mem->szblks - 1);
+  }
+  return pos;
+}
+
+static int lglptrmemcat (LGL * lgl, const void * ptr) {
+  assert (ptr);
+  return lgl->mem->blks[lglfindmemblk (lgl->mem, ptr)].cat;
+}
+
+// Removes the block and moves back entries of the following cluster which
+// otherwise could not be found anymore.
+
+static int lglunsetmemcat (LGL * lgl, const void * ptr) {
+  Mem * mem = lgl->mem;
+  size_t mask = mem->szblks - 1, i, j, k;
+  MemBlk * blks = mem->blks;
+  int res;
+  i = lglfindmemblk (mem, ptr);
+  res = blks[i].cat;
+  for (j = i;;) {
+    j = (j + 1) & mask;
+    if (!blks[j].ptr) break;
+    k = lglmemblkpos (mem, blks[j].ptr);
+    if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+    blks[i] = blks[j];
+    i = j;
+  }
+  blks[i].ptr = 0;
+  assert (mem->nblks > 0);
+  mem->nblks--;
+  return res;
+}
+
+static void * lglnewcat (LGL * lgl, int cat, size_t bytes) {
+  char * res;
   if (!bytes) return 0;
   if (lgl->mem->alloc) res = lgl->mem->alloc (lgl->mem->state, bytes);
   else res = malloc (bytes);
   if (!res) lgldie (lgl, "out of memory allocating %ld bytes", bytes);
   assert (res);
-  LOG (5, "allocating %p with %ld bytes", res, bytes);
-  lglinc (lgl, bytes);
+  lglsetmemcat (lgl, res, cat);
+  LOG (5, "allocating %p with %ld bytes (%s)", res, bytes, memcatnames[cat]);
+  lglinc (lgl, cat, bytes);
   if (res) memset (res, 0, bytes);
   return res;
 }
 
+static void * lglnew (LGL * lgl, size_t bytes) {
+  return lglnewcat (lgl, lglmemcat (lgl, 0), bytes);
+}
+
 static void lgldel (LGL * lgl, void * ptr, size_t bytes) {
+  int cat;
   if (!ptr) { assert (!bytes); return; }
-  lgldec (lgl, bytes);
-  LOG (5, "freeing %p with %ld bytes", ptr, bytes);
+  cat = lglunsetmemcat (lgl, ptr);
+  lgldec (lgl, cat, bytes);
+  LOG (5, "freeing %p with %ld bytes (%s)", ptr, bytes, memcatnames[cat]);
   if (lgl->mem->dealloc) lgl->mem->dealloc (lgl->mem->state, ptr, bytes);
   else free (ptr);
 }
 
-static void * lglrsz (LGL * lgl, void * ptr, size_t old, size_t new) {
-  void * res;
+static void * lglrszcat (LGL * lgl, int cat,
+                         void * ptr, size_t old, size_t new) {
+  char * res;
   assert (!ptr == !old);
-  if (!ptr) return lglnew (lgl, new);
+  if (!ptr) return lglnewcat (lgl, cat, new);
   if (!new) { lgldel (lgl, ptr, old); return 0; }
   if (old == new) return ptr;
-  lgldec (lgl, old);
+  cat = lglunsetmemcat (lgl, ptr);
+  lgldec (lgl, cat, old);
   if (lgl->mem->realloc)
     res = lgl->mem->realloc (lgl->mem->state, ptr, old, new);
   else res = realloc (ptr, new);
   if (!res)
     lgldie (lgl, "out of memory reallocating %ld to %ld bytes", old, new);
   assert (res);
-  LOG (5, "reallocating %p to %p from %ld to %ld bytes", ptr, res, old, new);
-  lglinc (lgl, new);
+  lglsetmemcat (lgl, res, cat);
+  LOG (5, "reallocating %p to %p from %ld to %ld bytes",
+    ptr, res, old, new);
+  lglinc (lgl, cat, new);
   if (new > old) memset (res + old, 0, new - old);
   return res;
 }
 
+#ifndef NLGLYALSAT
+static void * lglrsz (LGL * lgl, void * ptr, size_t old, size_t new) {
+  return lglrszcat (lgl, ptr ? 0 : lglmemcat (lgl, 0), ptr, old, new);
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+
+static void lglinitperf (LGL * lgl) {
+#ifdef LGLPERF
+  static const uint64_t configs[NPERF] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+  };
+  struct perf_event_attr attr;
+  int i, fd, leader;
+  Perf * perf;
+  assert (!lgl->perf);
+  NEW (perf, 1);
+  lgl->perf = perf;
+  for (i = 0; i < NPERF; i++) perf->fd[i] = perf->slot[i] = -1;
+  for (i = 0; i < NPERF; i++) {
+    memset (&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.disabled = !i;
+    leader = i ? perf->fd[0] : -1;
+    fd = syscall (__NR_perf_event_open, &attr, 0, -1, leader, 0);
+    perf->fd[i] = fd;
+    perf->slot[i] = (fd < 0) ? -1 : perf->nslots++;
+    if (!i && fd < 0) break;
+  }
+  if (perf->fd[0] < 0) {
+    lglprt (lgl, 1, "[perf] hardware performance counters unavailable");
+    perf->nslots = 0;
+  } else {
+    ioctl (perf->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    lglprt (lgl, 1, "[perf] counting %d hardware events per phase",
+      perf->nslots);
+  }
+#else
+  NEW (lgl->perf, 1);
+  lglprt (lgl, 1, "[perf] hardware performance counters not supported");
+#endif
+}
+
+static void lglrelperf (LGL * lgl) {
+  if (!lgl->perf) return;
+#ifdef LGLPERF
+  {
+    int i;
+    for (i = NPERF - 1; i >= 0; i--)
+      if (lgl->perf->fd[i] >= 0) close (lgl->perf->fd[i]);
+  }
+#endif
+  DEL (lgl->perf, 1);
+}
+
 /*------------------------------------------------------------------------*/
 
 static char * lglstrdup (LGL * lgl, const char * str) {
@@ -1517,6 +2161,21 @@ void lglsetconsumedcls (LGL * lgl,
   lgl->cbs->cls.consumed.state = state;
 }
 
+void lglsetquery (LGL * lgl, void (*fun) (void*, int), void * state) {
+  REQINITNOTFORKED ();
+  lglinitcbs (lgl);
+  lgl->cbs->query.fun = fun;
+  lgl->cbs->query.state = state;
+}
+
+void lglsetstatsnap (LGL * lgl, void (*fun) (void*, LGL*), void * state) {
+  REQINITNOTFORKED ();
+  lglinitcbs (lgl);
+  lgl->cbs->statsnap.fun = fun;
+  lgl->cbs->statsnap.state = state;
+  lgl->limits->statsnap.confs = lgl->stats->confs + lgl->opts->statsint.val;
+}
+
 void lglsetlockeq (LGL * lgl, int * (*fun)(void*), void * state) {
   REQINITNOTFORKED ();
   lglinitcbs (lgl);
@@ -1623,21 +2282,162 @@ static void lglclnstk (Stk * s) { lglrststk (s, 0); }
 
 /*------------------------------------------------------------------------*/
 
-static void lgltrapi (LGL * lgl, const char * msg, ...) {
+// Binary API traces are collected in a buffer, which is written when full,
+// at 'lglrelease', on abort, or after each call if 'trapiflush' is set.
+// With 'trapiasync' full buffers are handed over to a background thread
+// which writes them while the solver fills the other buffer.  Write
+// errors are recorded in 'failed', which is protected by 'lock' as soon as
+// the writer thread is running, and reported once.
+
+static int lglwrtrapibuf (Trapi * trapi, const unsigned char * buf,
+                          size_t bytes) {
+  return fwrite (buf, 1, bytes, trapi->file) == bytes;
+}
+
+static void * lgltrapiwriter (void * voidptr) {
+  Trapi * trapi = voidptr;
+  int ok;
+  pthread_mutex_lock (&trapi->lock);
+  for (;;) {
+    while (!trapi->pending && !trapi->stop)
+      pthread_cond_wait (&trapi->cond, &trapi->lock);
+    if (!trapi->pending) break;
+    pthread_mutex_unlock (&trapi->lock);
+    ok = lglwrtrapibuf (trapi,
+                        trapi->buf[!trapi->current], trapi->pending);
+    pthread_mutex_lock (&trapi->lock);
+    if (!ok) trapi->failed = 1;
+    trapi->pending = 0;
+    pthread_cond_broadcast (&trapi->cond);
+  }
+  pthread_mutex_unlock (&trapi->lock);
+  return 0;
+}
+
+static void lglwaitrapi (Trapi * trapi) {
+  if (!trapi->async) return;
+  pthread_mutex_lock (&trapi->lock);
+  while (trapi->pending) pthread_cond_wait (&trapi->cond, &trapi->lock);
+  pthread_mutex_unlock (&trapi->lock);
+}
+
+static void lglflushtrapi (LGL * lgl, int sync) {
+  Trapi * trapi = lgl->trapi;
+  int ok = 1, failed;
+  assert (trapi);
+  if (!trapi->count) return;
+  if (!sync && !trapi->async && lgl->opts->trapiasync.val) {
+    pthread_mutex_init (&trapi->lock, 0);
+    pthread_cond_init (&trapi->cond, 0);
+    if (pthread_create (&trapi->thread, 0, lgltrapiwriter, trapi))
+      lglwrn (lgl, "can not start asynchronous API trace writer");
+    else trapi->async = 1;
+  }
+  lglwaitrapi (trapi);
+  if (sync || !trapi->async) {
+    ok = lglwrtrapibuf (trapi, trapi->buf[trapi->current], trapi->count);
+  } else {
+    pthread_mutex_lock (&trapi->lock);
+    trapi->pending = trapi->count;
+    trapi->current = !trapi->current;
+    pthread_cond_signal (&trapi->cond);
+    pthread_mutex_unlock (&trapi->lock);
+  }
+  trapi->count = 0;
+  if (sync || lgl->opts->trapiflush.val) fflush (trapi->file);
+  if (trapi->async) pthread_mutex_lock (&trapi->lock);
+  if (!ok) trapi->failed = 1;
+  failed = trapi->failed;
+  if (trapi->async) pthread_mutex_unlock (&trapi->lock);
+  if (!failed || trapi->warned) return;
+  trapi->warned = 1;
+  lglwrn (lgl, "writing binary API trace failed");
+}
+
+static void lglputrapi (Trapi * trapi, unsigned u) {
+  unsigned char * p = trapi->buf[trapi->current] + trapi->count;
+  while (u & ~0x7fu) {
+    *p++ = (u & 0x7f) | 0x80;
+    u >>= 7;
+  }
+  *p++ = u;
+  trapi->count = p - trapi->buf[trapi->current];
+}
+
+static void lglbtrapi (LGL * lgl, int cmd, const char * opt, int arg) {
+  Trapi * trapi = lgl->trapi;
+  int sig = ltrcmdsig (cmd);
+  size_t len = opt ? strlen (opt) : 0;
+  if (trapi->count + len + 16 > TRAPIBUFSIZE) lglflushtrapi (lgl, 0);
+  assert (trapi->count + len + 16 <= TRAPIBUFSIZE);
+  trapi->buf[trapi->current][trapi->count++] = cmd;
+  if (sig == 'O') {
+    lglputrapi (trapi, len);
+    memcpy (trapi->buf[trapi->current] + trapi->count, opt, len);
+    trapi->count += len;
+  }
+  if (sig != 'N') lglputrapi (trapi, (((unsigned) arg) << 1) ^ -(arg < 0));
+  if (lgl->opts->trapiflush.val) lglflushtrapi (lgl, 0);
+}
+
+static void lgltrapi (LGL * lgl, int cmd, ...) {
+  const char * opt = 0;
+  int sig, arg = 0;
   va_list ap;
   assert (lgl->apitrace);
-  va_start (ap, msg);
-  vfprintf (lgl->apitrace, msg, ap);
+  sig = ltrcmdsig (cmd);
+  va_start (ap, cmd);
+  if (sig == 'O') opt = va_arg (ap, const char *);
+  if (sig != 'N') arg = va_arg (ap, int);
   va_end (ap);
+  if (lgl->trapi) { lglbtrapi (lgl, cmd, opt, arg); return; }
+  fputs (ltrcmd2str (cmd), lgl->apitrace);
+  if (opt) fprintf (lgl->apitrace, " %s", opt);
+  if (sig != 'N') fprintf (lgl->apitrace, " %d", arg);
   fputc ('\n', lgl->apitrace);
   if (lgl->opts->trapiflush.val) fflush (lgl->apitrace);
 }
 
+static void lglinitrapi (LGL * lgl) {
+  Trapi * trapi;
+  assert (lgl->apitrace);
+  assert (!lgl->trapi);
+  NEW (trapi, 1);
+  NEW (trapi->buf[0], TRAPIBUFSIZE);
+  NEW (trapi->buf[1], TRAPIBUFSIZE);
+  trapi->file = lgl->apitrace;
+  memcpy (trapi->buf[0], ltrmagic, sizeof ltrmagic);
+  trapi->count = sizeof ltrmagic;
+  lglputrapi (trapi, LTRVERSION);
+  lgl->trapi = trapi;
+}
+
+static void lglreltrapi (LGL * lgl) {
+  Trapi * trapi = lgl->trapi;
+  if (!trapi) return;
+  lglflushtrapi (lgl, 1);
+  if (trapi->async) {
+    pthread_mutex_lock (&trapi->lock);
+    trapi->stop = 1;
+    pthread_cond_signal (&trapi->cond);
+    pthread_mutex_unlock (&trapi->lock);
+    pthread_join (trapi->thread, 0);
+    pthread_cond_destroy (&trapi->cond);
+    pthread_mutex_destroy (&trapi->lock);
+  }
+  DEL (trapi->buf[0], TRAPIBUFSIZE);
+  DEL (trapi->buf[1], TRAPIBUFSIZE);
+  DEL (trapi, 1);
+  lgl->trapi = 0;
+}
+
 static void lglopenapitrace (LGL * lgl, const char * name) {
   FILE * file;
+  int len, binary;
   char * cmd;
-  int len;
   len = strlen (name);
+  binary = (len >= 4 && !strcmp (name + len - 4, ".btr")) ||
+           (len >= 7 && !strcmp (name + len - 7, ".btr.gz"));
   if (len >= 3 && !strcmp (name + len - 3, ".gz")) {
     len += 20;
     NEW (cmd, len);
@@ -1651,14 +2451,161 @@ static void lglopenapitrace (LGL * lgl, const char * name) {
   }
   if (file) lgl->apitrace = file;
   else lglwrn (lgl, "can not write API trace to '%s'", name);
-  TRAPI ("init");
+  if (file && binary) lglinitrapi (lgl);
+  TRAPI (init);
 }
 
 void lglwtrapi (LGL * lgl, FILE * apitrace) {
   REQUIRE (UNUSED);
   ABORTIF (lgl->apitrace, "can only write one API trace");
   lgl->apitrace = apitrace;
-  TRAPI ("init");
+  TRAPI (init);
+}
+
+void lglwtrapibin (LGL * lgl, FILE * apitrace) {
+  REQUIRE (UNUSED);
+  ABORTIF (lgl->apitrace, "can only write one API trace");
+  lgl->apitrace = apitrace;
+  lglinitrapi (lgl);
+  TRAPI (init);
+}
+
+/*------------------------------------------------------------------------*/
+
+// The conflict log is a ring of 'CLOGBUFS' buffers.  The solver encodes
+// events into the buffer at the head and hands it over to a background
+// flusher thread when it is full.  The flusher writes buffers starting at
+// the tail.  The solver only has to wait if all buffers are pending.
+
+static void * lglclogflusher (void * voidptr) {
+  Clog * clog = voidptr;
+  size_t bytes;
+  int idx, ok;
+  pthread_mutex_lock (&clog->lock);
+  for (;;) {
+    while (!clog->pending && !clog->stop)
+      pthread_cond_wait (&clog->cond, &clog->lock);
+    if (!clog->pending) break;
+    idx = clog->tail;
+    bytes = clog->count[idx];
+    pthread_mutex_unlock (&clog->lock);
+    ok = (fwrite (clog->buf[idx], 1, bytes, clog->file) == bytes);
+    pthread_mutex_lock (&clog->lock);
+    if (!ok) clog->failed = 1;
+    clog->count[idx] = 0;
+    clog->tail = (idx + 1) % CLOGBUFS;
+    clog->pending--;
+    pthread_cond_broadcast (&clog->cond);
+  }
+  pthread_mutex_unlock (&clog->lock);
+  return 0;
+}
+
+static void lglhandclog (Clog * clog) {
+  assert (clog->count[clog->head]);
+  pthread_mutex_lock (&clog->lock);
+  clog->bytes += clog->count[clog->head];
+  clog->head = (clog->head + 1) % CLOGBUFS;
+  clog->pending++;
+  pthread_cond_signal (&clog->cond);
+  if (clog->pending == CLOGBUFS) {
+    clog->stalls++;
+    while (clog->pending == CLOGBUFS)
+      pthread_cond_wait (&clog->cond, &clog->lock);
+  }
+  pthread_mutex_unlock (&clog->lock);
+}
+
+static void lglflushclog (LGL * lgl) {
+  Clog * clog = lgl->clog;
+  int failed;
+  assert (clog);
+  if (clog->count[clog->head]) lglhandclog (clog);
+  pthread_mutex_lock (&clog->lock);
+  while (clog->pending) pthread_cond_wait (&clog->cond, &clog->lock);
+  failed = clog->failed;
+  pthread_mutex_unlock (&clog->lock);
+  if (fflush (clog->file)) failed = 1;
+  if (failed) lglwrn (lgl, "writing conflict log failed");
+}
+
+static void lglputclog (Clog * clog, uint64_t u) {
+  unsigned char * p = clog->buf[clog->head] + clog->count[clog->head];
+  while (u & ~(uint64_t) 0x7f) {
+    *p++ = (u & 0x7f) | 0x80;
+    u >>= 7;
+  }
+  *p++ = u;
+  clog->count[clog->head] = p - clog->buf[clog->head];
+}
+
+static void lglclogevent (LGL * lgl, int event, int args, ...) {
+  Clog * clog = lgl->clog;
+  int64_t confs;
+  va_list ap;
+  int i, arg;
+  if (!clog || !lgl->opts->clog.val) return;
+  assert (0 <= event && event < LCL_NEVENTS);
+  assert (args <= LCLMAXARGS);
+  if (clog->count[clog->head] + 10 * (LCLMAXARGS + 2) > CLOGBUFSIZE)
+    lglhandclog (clog);
+  confs = lgl->stats->confs;
+  clog->buf[clog->head][clog->count[clog->head]++] = event;
+  lglputclog (clog, confs >= clog->confs ? confs - clog->confs : 0);
+  clog->confs = confs;
+  va_start (ap, args);
+  for (i = 0; i < args; i++) {
+    arg = va_arg (ap, int);
+    lglputclog (clog, arg < 0 ? 0 : (unsigned) arg);
+  }
+  va_end (ap);
+  clog->events++;
+}
+
+void lglsetclog (LGL * lgl, FILE * file) {
+  const unsigned char magic[] = LCLMAGIC;
+  Clog * clog;
+  int i;
+  REQINITNOTFORKED ();
+  ABORTIF (!file, "zero conflict log file");
+  ABORTIF (lgl->clog, "can only write one conflict log");
+  NEW (clog, 1);
+  for (i = 0; i < CLOGBUFS; i++) NEW (clog->buf[i], CLOGBUFSIZE);
+  clog->file = file;
+  memcpy (clog->buf[0], magic, sizeof magic);
+  clog->count[0] = sizeof magic;
+  lglputclog (clog, LCLVERSION);
+  pthread_mutex_init (&clog->lock, 0);
+  pthread_cond_init (&clog->cond, 0);
+  if (pthread_create (&clog->thread, 0, lglclogflusher, clog)) {
+    lglwrn (lgl, "can not start conflict log flusher");
+    pthread_cond_destroy (&clog->cond);
+    pthread_mutex_destroy (&clog->lock);
+    for (i = 0; i < CLOGBUFS; i++) DEL (clog->buf[i], CLOGBUFSIZE);
+    DEL (clog, 1);
+    return;
+  }
+  lgl->clog = clog;
+}
+
+static void lglrelclog (LGL * lgl) {
+  Clog * clog = lgl->clog;
+  int i;
+  if (!clog) return;
+  lglflushclog (lgl);
+  pthread_mutex_lock (&clog->lock);
+  clog->stop = 1;
+  pthread_cond_signal (&clog->cond);
+  pthread_mutex_unlock (&clog->lock);
+  pthread_join (clog->thread, 0);
+  pthread_cond_destroy (&clog->cond);
+  pthread_mutex_destroy (&clog->lock);
+  lglprt (lgl, 1,
+    "conflict log: %lld events, %lld bytes, %lld stalls",
+    (LGLL) clog->events, (LGLL) clog->bytes, (LGLL) clog->stalls);
+  for (i = 0; i < CLOGBUFS; i++) DEL (clog->buf[i], CLOGBUFSIZE);
+  DEL (clog, 1);
+  lgl->clog = 0;
 }
 
 /*------------------------------------------------------------------------*/
@@ -1813,7 +2760,7 @@ void lglgetenv (LGL * lgl, Opt * opt, const char * lname) {
   if (newval > opt->max) newval = opt->max;
   if (newval == oldval) return;
   opt->val = newval;
-  TRAPI ("option %s %d", lname, newval);
+  TRAPI (option, lname, newval);
   COVER (lgl->clone);
   if (lgl->clone) lglsetopt (lgl->clone, lname, newval);
 }
@@ -1850,6 +2797,7 @@ do { \
 
 static void lglforcedruplig (LGL * lgl, int val) {
   SETDRUP (bca);
+  SETDRUP (bva);
   SETDRUP (card);
   SETDRUP (gauss);
   SETDRUP (smallve);
@@ -1865,6 +2813,7 @@ static void lglsetdruplig (LGL * lgl, int val) {
 
 static void lglsetplain (LGL * lgl, int val) {
   SETPLAIN (bca);
+  SETPLAIN (bva);
   SETPLAIN (block);
   SETPLAIN (card);
   SETPLAIN (cce);
@@ -1874,6 +2823,7 @@ static void lglsetplain (LGL * lgl, int val) {
   SETPLAIN (locs);
   SETPLAIN (probe);
   SETPLAIN (quatres);
+  SETPLAIN (subsume);
   SETPLAIN (sweep);
   SETPLAIN (ternres);
   SETPLAIN (transred);
@@ -1890,6 +2840,7 @@ do { \
 static void lglsetwait (LGL * lgl, int val) {
   SETWAIT (batewait);
   SETWAIT (bcawait);
+  SETWAIT (bvawait);
   SETWAIT (blockwait);
   SETWAIT (ccewait);
   SETWAIT (elmblkwait);
@@ -1912,6 +2863,7 @@ static LGL * lglnewlgl (void * mem,
 
   lgl->mem = alloc ? alloc (mem, sizeof *lgl->mem) : malloc (sizeof *lgl->mem);
   ABORTIF (!lgl->mem, "out of memory allocating memory manager object");
+  CLRPTR (lgl->mem);
 
   lgl->mem->state = mem;
   lgl->mem->alloc = alloc;
@@ -1926,10 +2878,10 @@ static LGL * lglnewlgl (void * mem,
   ABORTIF (!lgl->stats, "out of memory allocating statistic counters");
   CLRPTR (lgl->stats);
 
-  lglinc (lgl, sizeof *lgl);
-  lglinc (lgl, sizeof *lgl->mem);
-  lglinc (lgl, sizeof *lgl->opts);
-  lglinc (lgl, sizeof *lgl->stats);
+  lglinc (lgl, MEM_core, sizeof *lgl);
+  lglinc (lgl, MEM_core, sizeof *lgl->mem);
+  lglinc (lgl, MEM_core, sizeof *lgl->opts);
+  lglinc (lgl, MEM_core, sizeof *lgl->stats);
 
   return lgl;
 }
@@ -2035,6 +2987,8 @@ LGL * lglminit (void * mem,
 static void lglcopyclonenfork (LGL * dst, LGL * src) {
   memcpy (dst->opts, src->opts, sizeof *src->opts);
   dst->out = src->out;
+  dst->timeline = src->timeline;
+  dst->timelined = 0;
   if (dst->prefix) lgldelstr (dst, dst->prefix);
   dst->prefix = lglstrdup (dst, src->prefix);
   if (src->cbs) {
@@ -2054,25 +3008,26 @@ LGL * lglmclone (LGL * orig,
 		 lglalloc alloc,
 		 lglrealloc realloc,
 		 lgldealloc dealloc) {
-  size_t max_bytes, current_bytes;
+  MemCnt bytes, cnts[NMEMCATS];
   LGL * lgl = orig;
-  int glue;
+  int glue, cat;
 
   if (!orig) return 0;
   lglcompact (orig);
   LOG (1, "cloning");
   lgl = lglnewlgl (mem, alloc, realloc, dealloc);
   memcpy (lgl, orig, ((char*)&orig->mem) - (char*) orig);
-  max_bytes = lgl->stats->bytes.max;
-  current_bytes = lgl->stats->bytes.current;
+  bytes = lgl->stats->bytes;
+  memcpy (cnts, lgl->stats->mem, sizeof cnts);
   memcpy (lgl->stats, orig->stats, sizeof *orig->stats);
-  lgl->stats->bytes.current = current_bytes;
-  lgl->stats->bytes.max = max_bytes;
+  lgl->stats->bytes = bytes;
+  memcpy (lgl->stats->mem, cnts, sizeof cnts);
   lglcopyclonenfork (lgl, orig);
 
   CLONE (limits, 1);
   CLONE (times, 1);
   CLONE (timers, 1);		assert (!lgl->timers->nest);
+  lgl->timers->perf = 0;	// counters are not cloned (see 'lglstart')
   CLONE (fltstr, 1);
   CLONE (ext, orig->szext);
   CLONE (i2e, orig->szvars);
@@ -2099,6 +3054,9 @@ LGL * lglmclone (LGL * orig,
   CLONESTK (clause);
   CLONESTK (eclause);
   CLONESTK (extend);
+  CLONESTK (extseg);
+  CLONESTK (exthead);
+  CLONESTK (extlim);
   CLONESTK (irr);
   CLONESTK (trail);
   CLONESTK (frames);
@@ -2124,6 +3082,11 @@ LGL * lglmclone (LGL * orig,
   assert (lgl->stats->bytes.current == orig->stats->bytes.current);
   assert (lgl->stats->bytes.max <= orig->stats->bytes.max);
   lgl->stats->bytes.max = orig->stats->bytes.max;
+  for (cat = 0; cat < NMEMCATS; cat++) {
+    assert (lgl->stats->mem[cat].current == orig->stats->mem[cat].current);
+    assert (lgl->stats->mem[cat].max <= orig->stats->mem[cat].max);
+    lgl->stats->mem[cat].max = orig->stats->mem[cat].max;
+  }
   return lgl;
 }
 
@@ -2140,7 +3103,286 @@ LGL * lglclone (LGL * lgl) {
 
 void lglchkclone (LGL * lgl) {
   REQINITNOTFORKED ();
-  TRAPI ("chkclone");
+  TRAPI (chkclone);
+}
+
+/*------------------------------------------------------------------------*/
+// Snapshots are raw binary dumps of the same state 'lglmclone' copies.
+// They are only portable between binaries compiled from the same sources
+// with the same configuration, which is checked through the layout
+// signature following the magic number.  Compression is left to the
+// caller, who can pass a pipe to an external compressor.
+
+#define SNAPSHOTVERSION 1
+
+static const unsigned char lglsnapmagic[4] = { 0x8e, 'L', 'S', 'N' };
+
+#define SNAPSHOTLAYOUT 19
+
+static void lglsnaplayout (size_t * layout) {
+  int i = 0;
+  layout[i++] = SNAPSHOTVERSION;
+  layout[i++] = sizeof (LGL);
+  layout[i++] = sizeof (Opts);
+  layout[i++] = sizeof (Stats);
+  layout[i++] = sizeof (Times);
+  layout[i++] = sizeof (Timers);
+  layout[i++] = sizeof (Limits);
+  layout[i++] = sizeof (FltStr);
+  layout[i++] = sizeof (Ext);
+  layout[i++] = sizeof (DVar);
+  layout[i++] = sizeof (QVar);
+  layout[i++] = sizeof (AVar);
+  layout[i++] = sizeof (Val);
+  layout[i++] = sizeof (TD);
+  layout[i++] = sizeof (Ctr);
+  layout[i++] = sizeof (Wchs);
+  layout[i++] = MAXGLUE;
+#ifndef NDEBUG
+  layout[i++] = 1;
+#else
+  layout[i++] = 0;
+#endif
+#ifndef NCHKSOL
+  layout[i++] = 1;
+#else
+  layout[i++] = 0;
+#endif
+  assert (i == SNAPSHOTLAYOUT);
+}
+
+static int lglnopts (LGL * lgl) {
+  int res = 0;
+  Opt * o;
+  for (o = FIRSTOPT (lgl); o <= LASTOPT (lgl); o++) res++;
+  return res;
+}
+
+static int lglsnapwr (FILE * file, const void * ptr, size_t bytes) {
+  return fwrite (ptr, 1, bytes, file) == bytes;
+}
+
+static int lglsnaprd (FILE * file, void * ptr, size_t bytes) {
+  return fread (ptr, 1, bytes, file) == bytes;
+}
+
+#define SNAPSHOT(FIELD,SIZE) \
+do { \
+  if (ok) \
+    ok = lglsnapwr (file, lgl->FIELD, (SIZE) * sizeof *(lgl->FIELD)); \
+} while (0)
+
+#define SNAPSHOTSTK(NAME) \
+do { \
+  size_t COUNTSIZE[2]; \
+  COUNTSIZE[0] = lgl->NAME.top - lgl->NAME.start; \
+  COUNTSIZE[1] = lgl->NAME.end - lgl->NAME.start; \
+  if (ok) ok = lglsnapwr (file, COUNTSIZE, sizeof COUNTSIZE); \
+  if (ok) \
+    ok = lglsnapwr (file, lgl->NAME.start, \
+                    COUNTSIZE[0] * sizeof *lgl->NAME.start); \
+} while (0)
+
+// Restored arrays are always allocated, even after a read error, such
+// that a partially restored solver can still be released.
+
+#define RESTORE(FIELD,SIZE) \
+do { \
+  NEW (lgl->FIELD, (SIZE)); \
+  if (ok) \
+    ok = lglsnaprd (file, lgl->FIELD, (SIZE) * sizeof *(lgl->FIELD)); \
+} while (0)
+
+#define RESTORESTK(NAME) \
+do { \
+  size_t COUNTSIZE[2]; \
+  if (ok) ok = lglsnaprd (file, COUNTSIZE, sizeof COUNTSIZE); \
+  if (ok) ok = (COUNTSIZE[0] <= COUNTSIZE[1]); \
+  if (ok && COUNTSIZE[1]) { \
+    NEW (lgl->NAME.start, COUNTSIZE[1]); \
+    lgl->NAME.top = lgl->NAME.start + COUNTSIZE[0]; \
+    lgl->NAME.end = lgl->NAME.start + COUNTSIZE[1]; \
+    ok = lglsnaprd (file, lgl->NAME.start, \
+                    COUNTSIZE[0] * sizeof *lgl->NAME.start); \
+  } \
+} while (0)
+
+int lglsnapshot (LGL * lgl, FILE * file) {
+  size_t layout[SNAPSHOTLAYOUT];
+  int ok = 1, glue, nopts, * vals;
+  Opt * o;
+  REQINITNOTFORKED ();
+  ABORTIF (!file, "can not write snapshot to zero file");
+  ABORTIF (lgl->opts->druplig.val,
+    "can not snapshot if Druplig checking is enabled");
+  lglcompact (lgl);
+  assert (!lgl->timers->nest);
+  LOG (1, "snapshot");
+  lglsnaplayout (layout);
+  ok = lglsnapwr (file, lglsnapmagic, sizeof lglsnapmagic);
+  if (ok) ok = lglsnapwr (file, layout, sizeof layout);
+  if (ok) ok = lglsnapwr (file, lgl, ((char*)&lgl->mem) - (char*) lgl);
+  nopts = lglnopts (lgl);
+  NEW (vals, nopts);
+  for (o = FIRSTOPT (lgl); o <= LASTOPT (lgl); o++)
+    vals[o - FIRSTOPT (lgl)] = o->val;
+  if (ok) ok = lglsnapwr (file, vals, nopts * sizeof *vals);
+  DEL (vals, nopts);
+
+  SNAPSHOT (stats, 1);
+  SNAPSHOT (limits, 1);
+  SNAPSHOT (times, 1);
+  SNAPSHOT (timers, 1);
+  SNAPSHOT (fltstr, 1);
+  SNAPSHOT (ext, lgl->szext);
+  SNAPSHOT (i2e, lgl->szvars);
+  SNAPSHOT (doms, 2*lgl->szvars);
+  SNAPSHOT (dvars, lgl->szvars);
+  SNAPSHOT (qvars, lgl->szvars);
+  SNAPSHOT (avars, lgl->szvars);
+  SNAPSHOT (vals, lgl->szvars);
+  SNAPSHOT (jwh, 2*lgl->szvars);
+  SNAPSHOT (drail, lgl->szdrail);
+
+  for (glue = 0; glue <= MAXGLUE; glue++) SNAPSHOTSTK (red[glue]);
+
+  SNAPSHOT (wchs, 1);
+  SNAPSHOTSTK (wchs->stk);
+
+  SNAPSHOTSTK (control);
+#ifndef NDEBUG
+  SNAPSHOTSTK (prevclause);
+  if (ok) ok = lglsnapwr (file, &lgl->prevglue, sizeof lgl->prevglue);
+#endif
+  SNAPSHOTSTK (clause);
+  SNAPSHOTSTK (eclause);
+  SNAPSHOTSTK (extend);
+  SNAPSHOTSTK (extseg);
+  SNAPSHOTSTK (exthead);
+  SNAPSHOTSTK (extlim);
+  SNAPSHOTSTK (irr);
+  SNAPSHOTSTK (trail);
+  SNAPSHOTSTK (frames);
+  SNAPSHOTSTK (promote);
+  SNAPSHOTSTK (eassume);
+  SNAPSHOTSTK (assume);
+  SNAPSHOTSTK (learned);
+  SNAPSHOTSTK (dsched);
+
+  SNAPSHOTSTK (queue.stk);
+  if (ok) ok = lglsnapwr (file, &lgl->queue.mt, sizeof lgl->queue.mt);
+  if (ok) ok = lglsnapwr (file, &lgl->queue.next, sizeof lgl->queue.next);
+
+#ifndef NCHKSOL
+  SNAPSHOTSTK (orig);
+#endif
+  if (ok) ok = !fflush (file);
+  if (!ok) lglwrn (lgl, "failed to write snapshot");
+  return ok;
+}
+
+LGL * lglrestore (FILE * file) {
+  size_t layout[SNAPSHOTLAYOUT], expected[SNAPSHOTLAYOUT];
+  unsigned char magic[sizeof lglsnapmagic];
+  MemCnt bytes, cnts[NMEMCATS];
+  int ok, glue, nopts, * vals;
+  LGL * lgl, tmp;
+  Stats * stats;
+  Opt * o;
+
+  if (!file) return 0;
+  if (!lglsnaprd (file, magic, sizeof magic)) return 0;
+  if (memcmp (magic, lglsnapmagic, sizeof magic)) return 0;
+  if (!lglsnaprd (file, layout, sizeof layout)) return 0;
+  lglsnaplayout (expected);
+  if (memcmp (layout, expected, sizeof layout)) return 0;
+  if (!lglsnaprd (file, &tmp, ((char*)&tmp.mem) - (char*) &tmp)) return 0;
+
+  lgl = lglnewlgl (0, 0, 0, 0);
+  memcpy (lgl, &tmp, ((char*)&tmp.mem) - (char*) &tmp);
+  lgl->parent = 0;
+  lgl->forked = 0;
+  lgl->out = stdout;
+  lgl->prefix = lglstrdup (lgl, "c ");
+  lglinitopts (lgl, lgl->opts);
+
+  nopts = lglnopts (lgl);
+  NEW (vals, nopts);
+  ok = lglsnaprd (file, vals, nopts * sizeof *vals);
+  if (ok)
+    for (o = FIRSTOPT (lgl); o <= LASTOPT (lgl); o++)
+      o->val = vals[o - FIRSTOPT (lgl)];
+  DEL (vals, nopts);
+
+  NEW (stats, 1);
+  if (ok) ok = lglsnaprd (file, stats, sizeof *stats);
+
+  RESTORE (limits, 1);
+  RESTORE (times, 1);
+  RESTORE (timers, 1);
+  RESTORE (fltstr, 1);
+  RESTORE (ext, lgl->szext);
+  RESTORE (i2e, lgl->szvars);
+  RESTORE (doms, 2*lgl->szvars);
+  RESTORE (dvars, lgl->szvars);
+  RESTORE (qvars, lgl->szvars);
+  RESTORE (avars, lgl->szvars);
+  RESTORE (vals, lgl->szvars);
+  RESTORE (jwh, 2*lgl->szvars);
+  RESTORE (drail, lgl->szdrail);
+
+  NEW (lgl->red, MAXGLUE+1);
+  for (glue = 0; glue <= MAXGLUE; glue++) RESTORESTK (red[glue]);
+
+  RESTORE (wchs, 1);
+  CLR (lgl->wchs->stk);
+  RESTORESTK (wchs->stk);
+
+  RESTORESTK (control);
+#ifndef NDEBUG
+  RESTORESTK (prevclause);
+  if (ok) ok = lglsnaprd (file, &lgl->prevglue, sizeof lgl->prevglue);
+#endif
+  RESTORESTK (clause);
+  RESTORESTK (eclause);
+  RESTORESTK (extend);
+  RESTORESTK (extseg);
+  RESTORESTK (exthead);
+  RESTORESTK (extlim);
+  RESTORESTK (irr);
+  RESTORESTK (trail);
+  RESTORESTK (frames);
+  RESTORESTK (promote);
+  RESTORESTK (eassume);
+  RESTORESTK (assume);
+  RESTORESTK (learned);
+  RESTORESTK (dsched);
+
+  RESTORESTK (queue.stk);
+  if (ok) ok = lglsnaprd (file, &lgl->queue.mt, sizeof lgl->queue.mt);
+  if (ok) ok = lglsnaprd (file, &lgl->queue.next, sizeof lgl->queue.next);
+
+#ifndef NCHKSOL
+  RESTORESTK (orig);
+#endif
+
+  if (ok) ok = !lgl->timers->nest;
+  lgl->timers->perf = 0;	// counters are not restored (see 'lglstart')
+
+  if (!ok) {
+    DEL (stats, 1);
+    lglrelease (lgl);
+    return 0;
+  }
+
+  bytes = lgl->stats->bytes;
+  memcpy (cnts, lgl->stats->mem, sizeof cnts);
+  memcpy (lgl->stats, stats, sizeof *stats);
+  lgl->stats->bytes = bytes;
+  memcpy (lgl->stats->mem, cnts, sizeof cnts);
+  DEL (stats, 1);
+  LOG (1, "restored");
+  return lgl;
 }
 
 LGL * lglinit (void) { return lglminit (0, 0, 0, 0); }
@@ -2177,12 +3419,18 @@ static int lglstrhasprefix (const char * str, const char * prefix) {
 
 static int lglignopt (const char * name) {
   if (!strcmp (name, "abstime")) return 1;
+  if (lglstrhasprefix (name, "bincnf")) return 1;
   if (!strcmp (name, "check")) return 1;
+  if (!strcmp (name, "clog")) return 1;
   if (lglstrhasprefix (name, "drup")) return 1;
   if (!strcmp (name, "exitonabort")) return 1;
+  if (lglstrhasprefix (name, "lazyext")) return 1;
   if (!strcmp (name, "log")) return 1;
+  if (!strcmp (name, "perf")) return 1;
   if (!strcmp (name, "sleeponabort")) return 1;
+  if (!strcmp (name, "timer")) return 1;
   if (!strcmp (name, "verbose")) return 1;
+  if (lglstrhasprefix (name, "warm")) return 1;
   if (!strcmp (name, "witness")) return 1;
   return 0;
 }
@@ -2306,7 +3554,7 @@ void lglsetopt (LGL * lgl, const char * opt, int val) {
   }
   if (o == &lgl->opts->phase && val != oldval) lgl->flushphases = 1;
   if (lgl->state == UNUSED) TRANS (OPTSET);
-  TRAPI ("option %s %d", opt, val);
+  TRAPI (option, opt, val);
 
   if (lgl->opts->druplig.val)
     lglforcedruplig (lgl, 1);
@@ -2817,14 +4065,14 @@ static int lglsgn (int lit) { return (lit < 0) ? -1 : 1; }
 
 static Ext * lglelit2ext (LGL * lgl, int elit) {
   int idx = abs (elit);
-  assert (0 < idx), assert (idx <= lgl->maxext);
+  assert (0 < idx), assert (idx <= lgl->maxext + lgl->ndefs);
   return lgl->ext + idx;
 }
 
 static int lglerepr (LGL * lgl, int elit) {
   int res, next, tmp;
   Ext * ext;
-  assert (0 < abs (elit)), assert (abs (elit) <= lgl->maxext);
+  assert (0 < abs (elit)), assert (abs (elit) <= lgl->maxext + lgl->ndefs);
   res = elit;
   for (;;) {
     ext = lglelit2ext (lgl, res);
@@ -2876,11 +4124,41 @@ static void lglmelter (LGL * lgl) {
   LOG (2, "melted solver");
 }
 
+// Extension variables introduced by the solver itself (during bounded
+// variable addition) are kept after the user variables in 'ext'.  Their
+// internal to external mapping 'i2e' has the 'def' bit set and is relative
+// to 'maxext'.  So if the user adds new variables, their external records
+// have to be moved up and all external references to them shifted.
+
+static void lglmovedefs (LGL * lgl, int newmaxext) {
+  int oldmaxext = lgl->maxext, delta = newmaxext - oldmaxext, eidx;
+  int * p;
+  Ext * ext;
+  assert (delta > 0), assert (lgl->ndefs > 0);
+  if (newmaxext + lgl->ndefs >= lgl->szext)
+    lgladjext (lgl, newmaxext + lgl->ndefs);
+  memmove (lgl->ext + newmaxext + 1, lgl->ext + oldmaxext + 1,
+           lgl->ndefs * sizeof *lgl->ext);
+  memset (lgl->ext + oldmaxext + 1, 0, delta * sizeof *lgl->ext);
+  for (eidx = 1; eidx <= newmaxext + lgl->ndefs; eidx++) {
+    ext = lgl->ext + eidx;
+    if (!ext->equiv || abs (ext->repr) <= oldmaxext) continue;
+    ext->repr += (ext->repr < 0) ? -delta : delta;
+  }
+  for (p = lgl->extend.start; p < lgl->extend.top; p++)
+    if (abs (*p) > oldmaxext) *p += (*p < 0) ? -delta : delta;
+  lglclnstk (&lgl->exthead);
+  lglclnstk (&lgl->extseg);
+  lgl->extidxed = 0;
+  LOG (2, "moved %d extension variables by %d", lgl->ndefs, delta);
+}
+
 static int lglimportaux (LGL * lgl, int elit) {
   int res, repr, eidx = abs (elit);
   Ext * ext;
   assert (elit);
-  if (eidx >= lgl->szext) lgladjext (lgl, eidx);
+  if (eidx > lgl->maxext && lgl->ndefs) lglmovedefs (lgl, eidx);
+  else if (eidx >= lgl->szext) lgladjext (lgl, eidx);
   if (eidx > lgl->maxext) {
     lgl->maxext = eidx;
     lglmelter (lgl);
@@ -2914,16 +4192,43 @@ static int lglimport (LGL * lgl, int elit) {
   return lglimportaux (lgl, elit);
 }
 
-static Stk * lglidx2stk (LGL * lgl, int red, int lidx) {
-  int glue = 0;
-  Stk * s;
-  assert (red == 0 || red == REDCS);
-  assert (0 <= lidx);
-  if (!red) s = &lgl->irr;
-  else {
-    glue = lidx & GLUEMASK;
-    lidx >>= GLUESHFT;
-    assert (lidx <= MAXREDLIDX);
+static int lglnewdef (LGL * lgl) {
+  int res, eidx = lgl->maxext + lgl->ndefs + 1;
+  Ext * ext;
+  if (eidx >= lgl->szext) lgladjext (lgl, eidx);
+  res = lglnewvar (lgl);
+  lgl->ndefs++;
+  ext = lglelit2ext (lgl, eidx);
+  assert (!ext->imported);
+  ext->repr = res;
+  ext->imported = 1;
+  lgl->i2e[res] = 2*lgl->ndefs + 1;
+  LOG (2, "new extension variable %d as external %d", res, eidx);
+  return res;
+}
+
+static int lglisdef (LGL * lgl, int ilit) {
+  int iidx = abs (ilit);
+  assert (2 <= iidx), assert (iidx < lgl->nvars);
+  return lgl->i2e[iidx] & 1;
+}
+
+static int lglhasdef (LGL * lgl, const int * c) {
+  const int * p;
+  for (p = c; *p; p++) if (lglisdef (lgl, *p)) return 1;
+  return 0;
+}
+
+static Stk * lglidx2stk (LGL * lgl, int red, int lidx) {
+  int glue = 0;
+  Stk * s;
+  assert (red == 0 || red == REDCS);
+  assert (0 <= lidx);
+  if (!red) s = &lgl->irr;
+  else {
+    glue = lidx & GLUEMASK;
+    lidx >>= GLUESHFT;
+    assert (lidx <= MAXREDLIDX);
     s = &lgl->red[glue];
   }
   return s;
@@ -3302,7 +4607,7 @@ static void lglassign (LGL * lgl, int lit, int r0, int r1) {
     lgl->stats->irrprgss++;
     td->rsn[0] = UNITCS | RMSHFTLIT (lit);
     td->rsn[1] = 0;
-    if (lgl->cbs && lgl->cbs->units.produce.fun) {
+    if (lgl->cbs && lgl->cbs->units.produce.fun && !lglisdef (lgl, lit)) {
       LOG (2, "trying to export internal unit %d external %d\n",
 	   lgl->tid, lit, lglexport (lgl, lit));
       lgl->stats->sync.units.produced++;
@@ -4707,9 +6012,13 @@ static void lgliadd (LGL * lgl, int ilit) {
 }
 
 static void lgleunassignall (LGL * lgl) {
+  Ext * ext;
   int eidx;
-  for (eidx = 1; eidx <= lgl->maxext; eidx++)
-    lglelit2ext (lgl, eidx)->val = 0;
+  for (eidx = 1; eidx <= lgl->maxext + lgl->ndefs; eidx++) {
+    ext = lglelit2ext (lgl, eidx);
+    ext->val = 0;
+    ext->extended = 0;
+  }
 }
 
 static void lglchkeassumeclean (LGL * lgl) {
@@ -4817,9 +6126,8 @@ static void lglupdatealiased (LGL * lgl, int elit) {
   ext->aliased = 1;
 }
 
-static void lgleadd (LGL * lgl, int elit) {
+static void lgleaddlit (LGL * lgl, int elit) {
   int ilit;
-  lglreset (lgl);
   if (elit) {
     lglupdatealiased (lgl, elit);
     ilit = lglimport (lgl, elit);
@@ -4835,11 +6143,16 @@ static void lgleadd (LGL * lgl, int elit) {
 #endif
 }
 
+static void lgleadd (LGL * lgl, int elit) {
+  lglreset (lgl);
+  lgleaddlit (lgl, elit);
+}
+
 void lgladd (LGL * lgl, int elit) {
   int eidx = abs (elit);
   Ext * ext;
   REQINITNOTFORKED ();
-  TRAPI ("add %d", elit);
+  TRAPI (add, elit);
   if (0 < eidx && eidx <= lgl->maxext) {
     ext = lglelit2ext (lgl, elit);
     ABORTIF (ext->melted, "adding melted literal %d", elit);
@@ -4868,7 +6181,7 @@ static void lglesetphase (LGL * lgl, int elit, int phase) {
 
 void lglsetphase (LGL * lgl, int elit) {
   REQINITNOTFORKED ();
-  TRAPI ("setphase %d", elit);
+  TRAPI (setphase, elit);
   ABORTIF (!elit, "invalid literal argument");
   if (elit < 0) lglesetphase (lgl, -elit, -1);
   else lglesetphase (lgl, elit, 1);
@@ -4877,7 +6190,7 @@ void lglsetphase (LGL * lgl, int elit) {
 
 void lglresetphase (LGL * lgl, int elit) {
   REQINITNOTFORKED ();
-  TRAPI ("resetphase %d", elit);
+  TRAPI (resetphase, elit);
   ABORTIF (!elit, "invalid literal argument");
   lglesetphase (lgl, elit, 0);
   if (lgl->clone) lglresetphase (lgl->clone, elit);
@@ -4901,19 +6214,18 @@ static void lglesetimportant (LGL * lgl, int elit) {
 
 void lglsetimportant (LGL * lgl, int elit) {
   REQINITNOTFORKED ();
-  TRAPI ("setimportant %d", elit);
+  TRAPI (setimportant, elit);
   ABORTIF (!elit, "invalid literal argument");
   if (elit < 0) lglesetphase (lgl, -elit, -1);
   else lglesetimportant (lgl, elit);
   if (lgl->clone) lglsetimportant (lgl->clone, elit);
 }
 
-static void lgleassume (LGL * lgl, int elit) {
+static void lgleassumelit (LGL * lgl, int elit) {
   int ilit, val;
   unsigned bit;
   AVar * av;
   Ext * ext;
-  lglreset (lgl);
   ilit = lglimport (lgl, elit);
   LOG (2, "assuming external literal %d", elit);
   bit = 1u << (elit < 0);
@@ -4951,6 +6263,11 @@ static void lgleassume (LGL * lgl, int elit) {
   }
 }
 
+static void lgleassume (LGL * lgl, int elit) {
+  lglreset (lgl);
+  lgleassumelit (lgl, elit);
+}
+
 static void lglecassume (LGL * lgl, int elit) {
   LOG (2, "adding external literal %d to assumed clause", elit);
   (void) lgl;
@@ -4961,7 +6278,7 @@ void lglassume (LGL * lgl, int elit) {
   int eidx = abs (elit);
   Ext * ext;
   REQINITNOTFORKED ();
-  TRAPI ("assume %d", elit);
+  TRAPI (assume, elit);
   lgl->stats->calls.assume++;
   ABORTIF (!elit, "can not assume invalid literal 0");
   if (0 < eidx && eidx <= lgl->maxext) {
@@ -4978,7 +6295,7 @@ void lglcassume (LGL * lgl, int elit) {
   int eidx = abs (elit);
   Ext * ext;
   REQINITNOTFORKED ();
-  TRAPI ("cassume %d", elit);
+  TRAPI (cassume, elit);
   lgl->stats->calls.cassume++;
   if (0 < eidx && eidx <= lgl->maxext) {
     ext = lglelit2ext (lgl, elit);
@@ -4989,11 +6306,68 @@ void lglcassume (LGL * lgl, int elit) {
   if (lgl->clone) lglcassume (lgl->clone, elit);
 }
 
+// The bulk versions of 'lgladd' and 'lglassume' check the API state,
+// reset the solver, update statistics and forward to the clone only once
+// per call.  Only the trace records and the melted checks remain per
+// literal.
+
+void lgladdclauses (LGL * lgl, const int * lits, size_t n) {
+  const int * p, * end = lits + n;
+  int elit, eidx;
+  Ext * ext;
+  REQINITNOTFORKED ();
+  ABORTIF (n && !lits, "zero literals pointer");
+  if (!n) return;
+  if (lgl->apitrace)
+    for (p = lits; p < end; p++)
+      lgltrapi (lgl, LTR_add, *p);
+  lgl->stats->calls.add += n;
+  lglreset (lgl);
+  for (p = lits; p < end; p++) {
+    elit = *p;
+    eidx = abs (elit);
+    if (0 < eidx && eidx <= lgl->maxext) {
+      ext = lglelit2ext (lgl, elit);
+      ABORTIF (ext->melted, "adding melted literal %d", elit);
+    }
+    lgleaddlit (lgl, elit);
+  }
+  lgluse (lgl);
+  if (lgl->clone) lgladdclauses (lgl->clone, lits, n);
+}
+
+void lglassumeall (LGL * lgl, const int * lits, size_t n) {
+  const int * p, * end = lits + n;
+  int elit, eidx;
+  Ext * ext;
+  REQINITNOTFORKED ();
+  ABORTIF (n && !lits, "zero literals pointer");
+  if (!n) return;
+  if (lgl->apitrace)
+    for (p = lits; p < end; p++)
+      lgltrapi (lgl, LTR_assume, *p);
+  lgl->stats->calls.assume += n;
+  lglreset (lgl);
+  for (p = lits; p < end; p++) {
+    elit = *p;
+    ABORTIF (!elit, "can not assume invalid literal 0");
+    eidx = abs (elit);
+    if (eidx <= lgl->maxext) {
+      ext = lglelit2ext (lgl, elit);
+      ABORTIF (ext->melted, "assuming melted literal %d", elit);
+    }
+    lgleassumelit (lgl, elit);
+  }
+  lgluse (lgl);
+  lglmelter (lgl);
+  if (lgl->clone) lglassumeall (lgl->clone, lits, n);
+}
+
 void lglfixate (LGL * lgl) {
   const int  * p;
   Stk eassume;
   REQINITNOTFORKED ();
-  TRAPI ("fixate");
+  TRAPI (fixate);
   if (lgl->mt) return;
   CLR (eassume);
   for (p = lgl->eassume.start; p < lgl->eassume.top; p++)
@@ -5298,6 +6672,20 @@ static void lglrmlwch (LGL * lgl, int lit, int red, int lidx) {
   lglshrinkhts (lgl, hts, q - w - 2);
 }
 
+#ifdef LGLSHAPE
+static int lglshapebucket (int64_t n) {
+  int res = 0;
+  while (n > 0 && res + 1 < SHAPEBUCKETS) n >>= 1, res++;
+  return res;
+}
+
+static void lglshapewchs (LGL * lgl, int count, int visits) {
+  int bucket = lglshapebucket (count);
+  lgl->stats->shape.wchs[bucket].props++;
+  lgl->stats->shape.wchs[bucket].visits += visits;
+}
+#endif
+
 static void lglpropsearch (LGL * lgl, int lit) {
   int * q, * eos, blit, other, other2, other3, red, prev;
   int tag, val, val2, lidx, * c, * l;
@@ -5331,7 +6719,7 @@ static void lglpropsearch (LGL * lgl, int lit) {
     other = (blit >> RMSHFT);
     assert (abs (other) != abs (lit));
     val = lglval (lgl, other);
-    if (val > 0) continue;
+    if (val > 0) { SHAPEINC (blocked.blit[tag]); continue; }
     red = blit & REDCS;
     if (tag == BINCS) {
       if (val < 0) { lglbonflict (lgl, -lit, blit); p++; break; }
@@ -5362,6 +6750,7 @@ static void lglpropsearch (LGL * lgl, int lit) {
 	val = lglval (lgl, other);
 	if (val > 0) {
 	  q[-2] = LRGCS | RMSHFTLIT (other2) | red;
+	  SHAPEINC (blocked.updated);
 	  continue;
 	}
       }
@@ -5399,6 +6788,9 @@ static void lglpropsearch (LGL * lgl, int lit) {
     }
   }
   while (p < eos) *q++ = *p++;
+#ifdef LGLSHAPE
+  lglshapewchs (lgl, hts->count, visits);
+#endif
   lglshrinkhts (lgl, hts, hts->count - (p - q));
   assert (!lgl->simp);
 
@@ -6062,6 +7454,17 @@ double lglmb (LGL * lgl) {
   return (lgl->stats->bytes.current + sizeof *lgl) / (double)(1<<20);
 }
 
+void lglmemtrav (LGL * lgl, void * state,
+                 void (*trav)(void *, const char *, size_t, size_t)) {
+  MemCnt * cnt;
+  int cat;
+  REQINIT ();
+  for (cat = 0; cat < NMEMCATS; cat++) {
+    cnt = lgl->stats->mem + cat;
+    trav (state, memcatnames[cat], cnt->current, cnt->max);
+  }
+}
+
 static double lglavg (double n, double d) {
   return d != 0 ? n / d : 0.0;
 }
@@ -6228,16 +7631,25 @@ static void lglinitredl (LGL * lgl) {
 }
 
 static int lglmemout (LGL * lgl) {
+  MemCnt * mem = lgl->stats->mem;
+  int res, cat, max;
   size_t cur;
-  int res;
   if (lgl->opts->memlim.val < 0) return 0;
   cur = lgl->stats->bytes.current;
   cur >>= 20;
   res = (cur >= (size_t) lgl->opts->memlim.val);
-  if (res)
-    lglprt (lgl, 2, "memory limit of %d MB hit after allocating %lld MB",
-      lgl->opts->memlim.val, (LGLL) cur);
-  return res;
+  if (!res) return 0;
+  lglprt (lgl, 2, "memory limit of %d MB hit after allocating %lld MB",
+    lgl->opts->memlim.val, (LGLL) cur);
+  max = 0;
+  for (cat = 1; cat < NMEMCATS; cat++)
+    if (mem[cat].current > mem[max].current) max = cat;
+  lglprt (lgl, 2,
+    "%.1f MB redundant, %.1f MB watches, largest '%s' with %.1f MB",
+    mem[MEM_redundant].current / (double)(1<<20),
+    mem[MEM_watches].current / (double)(1<<20),
+    memcatnames[max], mem[max].current / (double)(1<<20));
+  return 1;
 }
 
 static Val lgliphase (LGL * lgl, int lit) {
@@ -6540,6 +7952,8 @@ static void lglreduce (LGL * lgl, int forced) {
   lgl->stats->red.lrg -= sumcollected + sumretired;
   lgl->stats->reduced.collected += sumcollected;
   lgl->stats->reduced.retired += sumretired;
+  lglclogevent (lgl, LCL_reduce, 3,
+    sumcollected, sumretired, lgl->stats->red.lrg);
   nunlocked = 0;
   for (idx = 2; idx < lgl->nvars; idx++) {
     if (!lglval (lgl, idx)) continue;
@@ -6650,7 +8064,7 @@ NOINC:
 
 void lglreducecache (LGL * lgl) {
   REQINITNOTFORKED ();
-  TRAPI ("reduce");
+  TRAPI (reduce);
   if (lgl->mt) return;
   lglinitredl (lgl);
   lglreduce (lgl, 1);
@@ -6744,7 +8158,7 @@ static void lgliflushcache (LGL * lgl, int keep) {
 
 void lglflushcache (LGL * lgl) {
   REQINITNOTFORKED ();
-  TRAPI ("flush");
+  TRAPI (flush);
   if (lgl->mt) return;
   lglinitredl (lgl);
   lgliflushcache (lgl, 3);
@@ -7832,7 +9246,7 @@ static void lglrndcls (LGL * lgl, int len, int prune) {
 static int lglana (LGL * lgl) {
   int open, resolved, tag, lit, uip, r0, r1, other, other2, * p, * q, lidx;
   int size, savedsize, resolventsize, level, red, glue, realglue;
-  int jlevel, mlevel, nmlevel, origsize, redsize, tlevel;
+  int jlevel, mlevel, nmlevel, origsize, redsize, tlevel, clevel;
   int len, * rsn;
 #ifdef RESOLVENT
   AVar * av;
@@ -8102,6 +9516,7 @@ RESTART:
 
   lglbumpscinc (lgl);
 
+  clevel = lgl->level;
   lglbacktrack (lgl, jlevel);
 
   len = lglcntstk (&lgl->clause) - 1;
@@ -8119,6 +9534,8 @@ RESTART:
     lglupdatemacd (lgl, &lgl->stats->jlevel, jlevel);
     LOG (2, "updating EMA trail level");
     lglupdatema (lgl, &lgl->stats->tlevel, tlevel, 1);
+    lglclogevent (lgl, LCL_conflict, 5,
+      clevel, jlevel, realglue, len, tlevel);
     if (lgl->opts->restartblock.val == 1 && lglblockrestart (lgl)) {
       lgl->limits->restart.confs =
         lgl->stats->confs + lgl->opts->restartint.val;
@@ -8202,7 +9619,8 @@ RESTART:
   if (lgl->cbs &&
       lgl->cbs->cls.produce.fun &&
       glue <= lgl->opts->synclsglue.val &&
-      (int) lglcntstk (&lgl->clause) - 1 <= lgl->opts->synclslen.val) {
+      (int) lglcntstk (&lgl->clause) - 1 <= lgl->opts->synclslen.val &&
+      !lglhasdef (lgl, lgl->clause.start)) {
     assert (lglmtstk (&lgl->eclause));
     for (p = lgl->clause.start; *p; p++)
       lglpushstk (lgl, &lgl->eclause, lglexport (lgl, *p));
@@ -8413,6 +9831,7 @@ static void lglrestart (LGL * lgl) {
     lgl->stats->restarts.kept.sum += kept;
     lgl->stats->restarts.kept.count++;
   }
+  lglclogevent (lgl, LCL_restart, 2, lgl->level, level);
   if (level < lgl->level) {
     int oldlevel = lgl->level;
     lglbacktrack (lgl, level);
@@ -8426,6 +9845,7 @@ static void lglrestart (LGL * lgl) {
     lgl->stats->restarts.skipped++;
   }
   lglincrestart (lgl);
+  lgltimelinerestart (lgl);
   lglstop (lgl);
 }
 
@@ -9302,6 +10722,9 @@ static void lglmapvars (LGL * lgl, int * map, int nvars) {
   if (nvars > 2) assert (nvars <= oldnvars);
   else nvars = 0;
 
+  assert (!lgl->memcat);
+  lgl->memcat = MEM_variables;
+
   DEL (lgl->doms, 2*lgl->szvars);
   NEW (lgl->doms, 2*nvars);
 
@@ -9353,6 +10776,8 @@ static void lglmapvars (LGL * lgl, int * map, int nvars) {
   DEL (lgl->avars, lgl->szvars);
   lgl->avars = avars;              // Last since 'lglisfree' depends on it !!!
 
+  lgl->memcat = 0;
+
   lgl->nvars = lgl->szvars = nvars;
   lgl->stats->fixed.current = 0;
 }
@@ -9438,10 +10863,11 @@ static int lglirepr (LGL * lgl, int lit) {
 }
 
 static void lglmapext (LGL * lgl, int * map) {
-  int eidx, ilit, mlit;
+  int eidx, emax, ilit, mlit;
   Ext * ext;
-  for (eidx = 1; eidx <= lgl->maxext; eidx++) (void) lglerepr (lgl, eidx);
-  for (eidx = 1; eidx <= lgl->maxext; eidx++) {
+  emax = lgl->maxext + lgl->ndefs;
+  for (eidx = 1; eidx <= emax; eidx++) (void) lglerepr (lgl, eidx);
+  for (eidx = 1; eidx <= emax; eidx++) {
     ext = lgl->ext + eidx;
     if (!ext->imported) continue;
     if (ext->equiv) {
@@ -9610,6 +11036,7 @@ static int64_t lglsteps (LGL * lgl) {
   // Note, this would be bulky and slow ...
   int64_t steps = 0;
   steps += lgl->stats->bca.steps;
+  steps += lgl->stats->bva.steps;
   steps += lgl->stats->blk.steps;
   steps += lgl->stats->card.steps;
   steps += lgl->stats->cce.steps;
@@ -9624,6 +11051,7 @@ static int64_t lglsteps (LGL * lgl) {
   steps += lgl->stats->props.lkhd;
   steps += lgl->stats->props.search;
   steps += lgl->stats->props.simp;
+  steps += lgl->stats->subs.steps;
   steps += lgl->stats->sweep.steps;
   steps += lgl->stats->trd.steps;
   steps += lgl->stats->ternres.steps;
@@ -9659,10 +11087,18 @@ static void lgltrep (LGL * lgl) {
   lgl->limits->trep.time = i;
 }
 
+static void lglstatsnap (LGL * lgl) {
+  if (!lgl->cbs || !lgl->cbs->statsnap.fun) return;
+  if (lgl->stats->confs < lgl->limits->statsnap.confs) return;
+  lgl->limits->statsnap.confs = lgl->stats->confs + lgl->opts->statsint.val;
+  lgl->cbs->statsnap.fun (lgl->cbs->statsnap.state, lgl);
+}
+
 static int lglterminate (LGL * lgl) {
   int64_t steps;
   int res;
   lgltrep (lgl);
+  lglstatsnap (lgl);
   if (!lgl->cbs) return 0;
   if (!lgl->cbs->term.fun) return 0;
   if (lgl->cbs->term.done) return 1;
@@ -10223,7 +11659,7 @@ static void lglfreezer (LGL * lgl) {
   Ext * ext, * rext;
   int * p, eass;
   if (lgl->frozen) return;
-  for (elit = 1; elit <= lgl->maxext; elit++)
+  for (elit = 1; elit <= lgl->maxext + lgl->ndefs; elit++)
     lgl->ext[elit].tmpfrozen = 0;
   tmpfrozen = frozen = 0;
   if (!lglmtstk (&lgl->eassume)) {
@@ -10691,7 +12127,7 @@ static int lglederef (LGL * lgl, int elit) {
   int ilit, res;
   Ext * ext;
   assert (elit);
-  if (abs (elit) > lgl->maxext) return -1;
+  if (abs (elit) > lgl->maxext + lgl->ndefs) return -1;
   ext = lglelit2ext (lgl, elit);
   if (!(res = ext->val)) {
     assert (!ext->equiv);
@@ -13494,8 +14930,10 @@ static void lglrstecls (LGL * lgl)  {
   lglclnstk (&lgl->elm->noccs);
   lglclnstk (&lgl->elm->mark);
   lglclnstk (&lgl->elm->m2i);
+  lglclnstk (&lgl->elm->gatecls);
   lglpopnunmarkstk (lgl, &lgl->seen);
   lgl->elm->pivot = 0;
+  lgl->elm->gate = 0;
 }
 
 static void lglrelecls (LGL * lgl)  {
@@ -13508,6 +14946,7 @@ static void lglrelecls (LGL * lgl)  {
   lglrelstk (lgl, &lgl->elm->mark);
   lglrelstk (lgl, &lgl->elm->m2i);
   lglrelstk (lgl, &lgl->elm->clv);
+  lglrelstk (lgl, &lgl->elm->gatecls);
 }
 
 static void lglinitecls (LGL * lgl, int idx) {
@@ -14450,16 +15889,216 @@ static int lglforcedve (LGL * lgl, int idx) {
   return -1;
 }
 
+/*------------------------------------------------------------------------*/
+// Gate detection for bounded variable elimination.  If some clauses of
+// the pivot define it as a function of other variables, which is common
+// in circuit derived CNF, it is enough to resolve these gate clauses
+// against the remaining non-gate clauses.  Resolvents of two gate clauses
+// are tautological and those of two non-gate clauses are implied by the
+// gate and non-gate resolvents.  We look for equivalences and AND gates
+// (including OR gates with the negated pivot), then for ITE and finally
+// for XOR gates on the mapped clauses of the pivot.  Gate clauses are
+// flagged in 'gatecls' at the position of their first literal.
+
+static int lglelmsize (LGL * lgl, const int * c) {
+  return lglpeek (&lgl->elm->sizes, c - lgl->elm->lits.start);
+}
+
+static int lglelmisgate (LGL * lgl, const int * c) {
+  if (!lgl->elm->gate) return 0;
+  return lglpeek (&lgl->elm->gatecls, c - lgl->elm->lits.start);
+}
+
+static void lglelmgatecls (LGL * lgl, const int * c) {
+  int lidx = c - lgl->elm->lits.start;
+  assert (*c != REMOVED);
+  while (lglcntstk (&lgl->elm->gatecls) < lglcntstk (&lgl->elm->lits))
+    lglpushstk (lgl, &lgl->elm->gatecls, 0);
+  assert (!lglpeek (&lgl->elm->gatecls, lidx));
+  lglpoke (&lgl->elm->gatecls, lidx, 1);
+  lgl->elm->gate++;
+  LOGMCLS (3, c, "gate clause");
+}
+
+static int lglelmand (LGL * lgl, int mpivot,
+		      const int * sop, const int * eop,
+		      const int * son, const int * eon) {
+  const int * c, * d, * p, * q, * g;
+  int lit, other, ulit;
+  g = 0;
+  for (d = son; d < eon; d = q + 1) {
+    INCSTEPS (elm.steps);
+    for (q = d; *q; q++)
+      ;
+    if (*d == REMOVED || q - d != 2) continue;
+    other = (d[0] == -mpivot) ? d[1] : d[0];
+    lglpoke (&lgl->elm->mark, lglulit (other), 1);
+  }
+  for (c = sop; !g && c < eop; c = p + 1) {
+    INCSTEPS (elm.steps);
+    for (p = c; (lit = *p); p++)
+      if (lit != mpivot &&
+	  (lit == REMOVED || !lglpeek (&lgl->elm->mark, lglulit (-lit))))
+	break;
+    if (!lit && p - c > 1) g = c;
+    while (*p) p++;
+  }
+  if (g) {
+    for (p = g; (lit = *p); p++)
+      if (lit != mpivot) lglpoke (&lgl->elm->mark, lglulit (-lit), 2);
+    lglelmgatecls (lgl, g);
+  }
+  for (d = son; d < eon; d = q + 1) {
+    for (q = d; *q; q++)
+      ;
+    if (*d == REMOVED || q - d != 2) continue;
+    other = (d[0] == -mpivot) ? d[1] : d[0];
+    ulit = lglulit (other);
+    if (lglpeek (&lgl->elm->mark, ulit) == 2) lglelmgatecls (lgl, d);
+    lglpoke (&lgl->elm->mark, ulit, 0);
+  }
+  if (!g) return 0;
+  if (lglelmsize (lgl, g) == 2) {
+    LOG (2, "found equivalence gate for %d", mpivot * lgl->elm->pivot);
+    lgl->stats->elm.gates.equiv++;
+  } else {
+    LOG (2, "found AND gate with %d inputs for %d",
+	 lglelmsize (lgl, g) - 1, mpivot * lgl->elm->pivot);
+    lgl->stats->elm.gates.and++;
+  }
+  return 1;
+}
+
+static const int * lglelmfindtrn (LGL * lgl,
+				  const int * start, const int * end,
+				  int a, int b, int c) {
+  const int * d, * q;
+  int lit;
+  for (d = start; d < end; d = q + 1) {
+    INCSTEPS (elm.steps);
+    for (q = d; (lit = *q); q++)
+      if (lit != a && lit != b && lit != c) break;
+    if (!lit && q - d == 3) return d;
+    while (*q) q++;
+  }
+  return 0;
+}
+
+static int lglelmite (LGL * lgl) {
+  const int * sop, * eop, * son, * eon, * c, * d, * e, * f, * p, * q;
+  int i, j, u, a, b;
+  sop = lgl->elm->lits.start + 1;
+  eop = son = lgl->elm->lits.start + lgl->elm->neglidx;
+  eon = lgl->elm->lits.top;
+  for (c = sop; c < eop; c = p + 1) {
+    for (p = c; *p; p++)
+      ;
+    if (*c == REMOVED || p - c != 3) continue;
+    for (i = 0; i < 3; i++) {
+      if ((u = c[i]) == 1) continue;
+      a = c[0] + c[1] + c[2] - 1 - u;
+      for (d = sop; d < eop; d = q + 1) {
+	INCSTEPS (elm.steps);
+	for (q = d; *q; q++)
+	  ;
+	if (*d == REMOVED || q - d != 3) continue;
+	for (j = 0; j < 3 && d[j] != -u; j++)
+	  ;
+	if (j == 3) continue;
+	b = d[0] + d[1] + d[2] - 1 + u;
+	if (!(e = lglelmfindtrn (lgl, son, eon, -1, u, -a))) continue;
+	if (!(f = lglelmfindtrn (lgl, son, eon, -1, -u, -b))) continue;
+	LOG (2, "found ITE gate for %d", lgl->elm->pivot);
+	lglelmgatecls (lgl, c);
+	lglelmgatecls (lgl, d);
+	lglelmgatecls (lgl, e);
+	lglelmgatecls (lgl, f);
+	lgl->stats->elm.gates.ite++;
+	return 1;
+      }
+      if (lgl->limits->elm.steps <= lgl->stats->elm.steps) return 0;
+    }
+  }
+  return 0;
+}
+
+static int lglelmxor (LGL * lgl) {
+  const int * sop, * eop, * eon, * c, * d, * p, * q, * cls[64];
+  int size, lit, pos, parity, cparity, pattern, found, n, i;
+  uint64_t seen;
+  sop = lgl->elm->lits.start + 1;
+  eop = lgl->elm->lits.start + lgl->elm->neglidx;
+  eon = lgl->elm->lits.top;
+  for (c = sop; c < eop; c = p + 1) {
+    for (p = c; *p; p++)
+      ;
+    size = p - c;
+    if (*c == REMOVED || size < 3) continue;
+    if (size > lgl->opts->elmgatexor.val) continue;
+    n = size - 1;
+    pos = cparity = 0;
+    for (q = c; (lit = *q); q++) {
+      if (lit < 0) cparity = !cparity;
+      if (abs (lit) != 1) lglpoke (&lgl->elm->mark, abs (lit), ++pos);
+    }
+    assert (pos == n);
+    seen = 0, found = 0;
+    for (d = sop; found < (1 << n) && d < eon; d = q + 1) {
+      INCSTEPS (elm.steps);
+      for (q = d; *q; q++)
+	;
+      if (*d == REMOVED || q - d != size) continue;
+      pattern = parity = 0;
+      for (q = d; (lit = *q); q++) {
+	if (lit < 0) parity = !parity;
+	if (abs (lit) == 1) continue;
+	if (!(pos = lglpeek (&lgl->elm->mark, abs (lit)))) break;
+	if (lit < 0) pattern |= 1 << (pos - 1);
+      }
+      if (lit) { while (*q) q++; continue; }
+      if (parity != cparity) continue;
+      if (seen & (1ull << pattern)) continue;
+      seen |= 1ull << pattern;
+      cls[found++] = d;
+    }
+    for (q = c; (lit = *q); q++)
+      lglpoke (&lgl->elm->mark, abs (lit), 0);
+    if (found == (1 << n)) {
+      LOG (2, "found XOR gate with %d inputs for %d", n, lgl->elm->pivot);
+      for (i = 0; i < found; i++) lglelmgatecls (lgl, cls[i]);
+      lgl->stats->elm.gates.xor++;
+      return 1;
+    }
+    if (lgl->limits->elm.steps <= lgl->stats->elm.steps) return 0;
+  }
+  return 0;
+}
+
+static void lglelmgate (LGL * lgl) {
+  const int * sop, * eop, * son, * eon;
+  assert (lgl->elm->pivot);
+  assert (!lgl->elm->gate);
+  if (!lgl->opts->elmgate.val) return;
+  sop = lgl->elm->lits.start + 1;
+  eop = son = lgl->elm->lits.start + lgl->elm->neglidx;
+  eon = lgl->elm->lits.top;
+  if (lglelmand (lgl, 1, sop, eop, son, eon)) return;
+  if (lglelmand (lgl, -1, son, eon, sop, eop)) return;
+  if (lglelmite (lgl)) return;
+  (void) lglelmxor (lgl);
+}
+
 static int lgltrylargeve (LGL * lgl) {
   const int * c, * d, * sop, * eop, * son, * eon, * p, * q, * start, * end;
   int lit, idx, sgn, tmp, ip, ilit, npocc, nnocc, limit, count, i, res;
-  int clen, dlen, reslen, maxreslen;
+  int clen, dlen, reslen, maxreslen, gate, cgate;
   ip = lgl->elm->pivot;
   assert (ip);
   if ((res = lglforcedve (lgl, ip))) return res > 0;
   sop = lgl->elm->lits.start + 1;
   eop = son = lgl->elm->lits.start + lgl->elm->neglidx;
   eon = lgl->elm->lits.top;
+  gate = lgl->elm->gate;
   npocc = lglpeek (&lgl->elm->noccs, lglulit (1));
   nnocc = lglpeek (&lgl->elm->noccs, lglulit (-1));
   limit = npocc + nnocc;
@@ -14488,6 +16127,7 @@ static int lgltrylargeve (LGL * lgl) {
       continue;
     }
     assert (lglmtstk (&lgl->resolvent));
+    cgate = lglelmisgate (lgl, c);
     clen = 0;
     for (p = c; (lit = *p); p++) {
       if (lit == 1) continue;
@@ -14502,7 +16142,7 @@ static int lgltrylargeve (LGL * lgl) {
     }
     for (d = son; limit >= 0 && d < eon; d = q + 1) {
       INCSTEPS (elm.steps);
-      if (*d == REMOVED) {
+      if (*d == REMOVED || (gate && lglelmisgate (lgl, d) == cgate)) {
 	for (q = d + 1; *q; q++)
 	  ;
 	continue;
@@ -14568,13 +16208,14 @@ static int lgltrylargeve (LGL * lgl) {
 static void lgldolargeve (LGL * lgl) {
   const int * c, * d, * sop, * eop, * son, * eon, * p, * q, * start, * end;
   int lit, idx, sgn, tmp, ip, ilit, mp, npocc, nnocc;
-  int clen, dlen, reslen;
+  int clen, dlen, reslen, gate, cgate;
   Val val;
   ip = lgl->elm->pivot;
   assert (ip);
   sop = lgl->elm->lits.start + 1;
   eop = son = lgl->elm->lits.start + lgl->elm->neglidx;
   eon = lgl->elm->lits.top;
+  gate = lgl->elm->gate;
   npocc = lglpeek (&lgl->elm->noccs, lglulit (1));
   nnocc = lglpeek (&lgl->elm->noccs, lglulit (-1));
   LOG (2, "(large) variable elimination of %d", lgl->elm->pivot);
@@ -14607,6 +16248,7 @@ static void lgldolargeve (LGL * lgl) {
       continue;
     }
     assert (lglmtstk (&lgl->resolvent));
+    cgate = lglelmisgate (lgl, c);
     clen = 0;
     for (p = c; (lit = *p); p++) {
       if (lit == 1) continue;
@@ -14621,7 +16263,7 @@ static void lgldolargeve (LGL * lgl) {
     }
     for (d = son; d < eon; d = q + 1) {
       INCSTEPS (elm.steps);
-      if (*d == REMOVED) {
+      if (*d == REMOVED || (gate && lglelmisgate (lgl, d) == cgate)) {
 	for (q = d + 1; *q; q++)
 	  ;
 	continue;
@@ -14693,6 +16335,7 @@ static void lglelimlitaux (LGL * lgl, int idx) {
   lglelmsub (lgl);
   if (lglelmstr (lgl)) return;
   lglelmfre (lgl);
+  lglelmgate (lgl);
   if (lgltrylargeve (lgl)) lgldolargeve (lgl);
   (void) idx;
 }
@@ -14714,178 +16357,125 @@ static int lgls2m (LGL * lgl, int ilit) {
   return res;
 }
 
-static void lglvar2funaux (int v, Fun res, int negate) {
-  uint64_t tmp;
-  int i, j, p;
+// Function tables of candidates with 'n' variables only need the first
+// '2^(n-6)' of the 'FUNQUADS' words, since the remaining words just repeat
+// them.  Thus all operations below take the number of used words 'nq' as
+// first argument and are simple loops over these words, which compilers
+// can vectorize.  Small functions become much cheaper this way and larger
+// ones affordable.
+
+static int lglfunquads (int nvars) {
+  assert (0 <= nvars && nvars <= FUNVAR);
+  return nvars <= 6 ? 1 : (1 << (nvars - 6));
+}
+
+static uint64_t lglvar2quad (int v, int i) {
   assert (0 <= v && v < FUNVAR);
-  if (v < 6) {
-    tmp = lglbasevar2funtab[v];
-    if (negate) tmp = ~tmp;
-    for (i = 0; i < FUNQUADS; i++)
-      res[i] = tmp;
-  } else {
-    tmp = negate ? ~0ull : 0ull;
-    p = 1 << (v - 6);
-    j = 0;
-    for (i = 0; i < FUNQUADS; i++) {
-      res[i] = tmp;
-      if (++j < p) continue;
-      tmp = ~tmp;
-      j = 0;
-    }
-  }
+  if (v < 6) return lglbasevar2funtab[v];
+  return ((i >> (v - 6)) & 1) ? ~0ull : 0ull;
+}
+
+// With 'FUNVAR' variables a function table takes 'FUNQUADS' words, which
+// is too large for keeping the temporaries of the recursive functions
+// below on the stack.  They are taken from a stack of tables allocated
+// once per elimination instead.  The recursion depth of 'lglsmallipos' is
+// bounded by the number of variables plus one and each level needs six
+// tables.  The other functions need at most five more.
+
+#define MAXFUNS (6*(FUNVAR + 2) + 5)
+
+static uint64_t * lglpushfun (LGL * lgl) {
+  Elm * elm = lgl->elm;
+  if (!elm->funs) NEW (elm->funs, MAXFUNS);
+  assert (elm->nfuns < MAXFUNS);
+  return elm->funs[elm->nfuns++];
 }
 
-static void lglvar2fun (int v, Fun res) {
-  lglvar2funaux (v, res, 0);
+static void lglpopfuns (LGL * lgl, int n) {
+  assert (n <= lgl->elm->nfuns);
+  lgl->elm->nfuns -= n;
 }
 
-static void lglnegvar2fun (int v, Fun res) {
-  lglvar2funaux (v, res, 1);
+static void lglrelfuns (LGL * lgl) {
+  assert (!lgl->elm->nfuns);
+  if (lgl->elm->funs) DEL (lgl->elm->funs, MAXFUNS);
 }
 
-static void lglfuncpy (Fun dst, const Fun src) {
+static void lglorvar2fun (int nq, int v, Fun res, int negate) {
+  uint64_t neg = negate ? ~0ull : 0ull;
   int i;
-  for (i = 0; i < FUNQUADS; i++)
-    dst[i] = src[i];
+  assert (v < 6 || (1 << (v - 6)) < nq);
+  for (i = 0; i < nq; i++)
+    res[i] |= neg ^ lglvar2quad (v, i);
 }
 
-static void lglfalsefun (Fun res) {
+static void lglfalsefun (int nq, Fun res) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     res[i] = (uint64_t)0;
 }
 
-static void lgltruefun (Fun res) {
+static void lgltruefun (int nq, Fun res) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     res[i] = ~(uint64_t)0;
 }
 
-static int lglisfalsefun (const Fun f) {
+static int lglisfalsefun (int nq, const Fun f) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     if (f[i] != (uint64_t)0) return 0;
   return 1;
 }
 
-static int lglistruefun (const Fun f) {
+static int lglistruefun (int nq, const Fun f) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     if (f[i] != ~(uint64_t)0) return 0;
   return 1;
 }
 
-static void lglorfun (Fun a, const Fun b) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    a[i] |= b[i];
-}
-
-static void lglornegfun (Fun a, const Fun b) {
+static void lglor3fun (int nq, Fun a, const Fun b, const Fun c) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
-    a[i] |= ~b[i];
-}
-
-static void lglor3fun (Fun a, const Fun b, const Fun c) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     a[i] = b[i] | c[i];
 }
 
-static void lglor3negfun (Fun a, const Fun b, const Fun c) {
+static void lglor3negfun (int nq, Fun a, const Fun b, const Fun c) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     a[i] = b[i] | ~c[i];
 }
 
-static void lglandornegfun (Fun a, const Fun b, const Fun c) {
+static void lglandornegfun (int nq, Fun a, const Fun b, const Fun c) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     a[i] &= b[i] | ~c[i];
 }
 
-static void lglandfun (Fun a, const Fun b) {
+static void lglandfun (int nq, Fun a, const Fun b) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     a[i] &= b[i];
 }
 
-static void lgland3fun (Fun a, const Fun b, const Fun c) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    a[i] = b[i] & c[i];
-}
-
-static void lgland3negfun (Fun a, const Fun b, const Fun c) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    a[i] = b[i] & ~c[i];
-}
-
-static void lglsrfun (Fun a, int shift) {
-  uint64_t rest, tmp;
-  int i, j, q, b, l;
-  assert (0 <= shift);
-  b = shift & 63;
-  q = shift >> 6;
-  j = 0;
-  i = q;
-  assert (i >= 0);
-  l = 64 - b;
-  while (j < FUNQUADS) {
-    if (i < FUNQUADS) {
-      tmp = a[i] >> b;
-      rest = (b && i+1 < FUNQUADS) ? (a[i+1] << l) : 0ull;
-      a[j] = rest | tmp;
-    } else a[j] = 0ull;
-    i++, j++;
-  }
-}
-
-static void lglslfun (Fun a, int shift) {
-  uint64_t rest, tmp;
-  int i, j, q, b, l;
-  assert (0 <= shift);
-  b = shift & 63;
-  q = shift >> 6;
-  j = FUNQUADS - 1;
-  i = j - q;
-  l = 64 - b;
-  while (j >= 0) {
-    if (i >= 0) {
-      tmp = a[i] << b;
-      rest = (b && i > 0) ? (a[i-1] >> l) : 0;
-      a[j] = rest | tmp;
-    } else a[j] = 0;
-    i--, j--;
-  }
-}
-
-static void lgls2fun (int mlit, Fun res) {
+static void lglors2fun (int nq, int mlit, Fun res) {
   int midx = abs (mlit), sidx = midx - 2;
   assert (0 <= sidx && sidx < FUNVAR);
-  if (mlit < 0) lglnegvar2fun (sidx, res);
-  else lglvar2fun (sidx, res);
+  lglorvar2fun (nq, sidx, res, mlit < 0);
 }
 
-static int lglinitsmallve (LGL * lgl, int lit, Fun res) {
-  int blit, tag, red, other, other2, lidx, mlit;
+static int lglmapsmallve (LGL * lgl, int lit) {
+  int blit, tag, red, other, lidx;
   const int * p, * w, * eow, * c, * q;
-  Fun cls, tmp;
   HTS * hts;
-  Val val;
-  assert (!lglval (lgl, lit));
-  LOG (3, "initializing small variable eliminiation for %d", lit);
 #ifndef NDEBUG
-  mlit =
+  int mlit =
 #endif
   lgls2m (lgl, lit);
   assert (abs (mlit) == 1);
   hts = lglhts (lgl, lit);
-  lgltruefun (res);
-  if (!hts->count) goto DONE;
+  if (!hts->count) return 1;
   w = lglhts2wchs (lgl, hts);
   eow = w + hts->count;
   for (p = w; p < eow; p++) {
@@ -14896,27 +16486,58 @@ static int lglinitsmallve (LGL * lgl, int lit, Fun res) {
     if (tag == LRGCS) continue;
     red = blit & REDCS;
     if (red) continue;
-    lglfalsefun (cls);
+    if (tag == BINCS || tag == TRNCS) {
+      other = blit >> RMSHFT;
+      if (!lglval (lgl, other) && !lgls2m (lgl, other)) return 0;
+      if (tag == BINCS) continue;
+      other = *p;
+      if (!lglval (lgl, other) && !lgls2m (lgl, other)) return 0;
+    } else {
+      assert (tag == OCCS);
+      lidx = blit >> RMSHFT;
+      c = lglidx2lits (lgl, 0, lidx);
+      for (q = c; (other = *q); q++)
+	if (other != lit && !lglval (lgl, other) && !lgls2m (lgl, other))
+	  return 0;
+    }
+  }
+  return 1;
+}
+
+static void lglinitsmallve (LGL * lgl, int lit, Fun res) {
+  const int nq = lgl->elm->funquads;
+  int blit, tag, red, other, other2, lidx;
+  const int * p, * w, * eow, * c, * q;
+  uint64_t * cls;
+  HTS * hts;
+  Val val;
+  assert (!lglval (lgl, lit));
+  assert (lglavar (lgl, lit)->mark == 1);
+  LOG (3, "initializing small variable eliminiation for %d", lit);
+  hts = lglhts (lgl, lit);
+  lgltruefun (nq, res);
+  if (!hts->count) return;
+  cls = lglpushfun (lgl);
+  w = lglhts2wchs (lgl, hts);
+  eow = w + hts->count;
+  for (p = w; p < eow; p++) {
+    blit = *p;
+    tag = blit & MASKCS;
+    if (tag == TRNCS || tag == LRGCS) p++;
+    if (tag == LRGCS) continue;
+    red = blit & REDCS;
+    if (red) continue;
+    lglfalsefun (nq, cls);
     if (tag == BINCS || tag == TRNCS) {
       other = blit >> RMSHFT;
       val = lglval (lgl, other);
       assert (val <= 0);
-      if (!val) {
-	mlit = lgls2m (lgl, other);
-	if (!mlit) return 0;
-	lgls2fun (mlit, tmp);
-	lglorfun (cls, tmp);
-      }
+      if (!val) lglors2fun (nq, lgls2m (lgl, other), cls);
       if (tag == TRNCS) {
 	other2 = *p;
 	val = lglval (lgl, other2);
 	assert (val <= 0);
-	if (!val) {
-	  mlit = lgls2m (lgl, other2);
-	  if (!mlit) return 0;
-	  lgls2fun (mlit, tmp);
-	  lglorfun (cls, tmp);
-	}
+	if (!val) lglors2fun (nq, lgls2m (lgl, other2), cls);
       }
     } else {
       assert (tag == OCCS);
@@ -14927,21 +16548,15 @@ static int lglinitsmallve (LGL * lgl, int lit, Fun res) {
 	assert (other != -lit);
 	val = lglval (lgl, other);
 	assert (val <= 0);
-	if (!val) {
-	  mlit = lgls2m (lgl, other);
-	  if (!mlit) return 0;
-	  lgls2fun (mlit, tmp);
-	  lglorfun (cls, tmp);
-	}
+	if (!val) lglors2fun (nq, lgls2m (lgl, other), cls);
       }
     }
-    assert (!lglisfalsefun (cls));
-    assert (!lglistruefun (cls));
-    lglandfun (res, cls);
+    assert (!lglisfalsefun (nq, cls));
+    assert (!lglistruefun (nq, cls));
+    lglandfun (nq, res, cls);
     INCSTEPS (elm.copies);
   }
-DONE:
-  return 1;
+  lglpopfuns (lgl, 1);
 }
 
 static void lglresetsmallve (LGL * lgl) {
@@ -14950,18 +16565,12 @@ static void lglresetsmallve (LGL * lgl) {
   lglpopnunmarkstk (lgl, &lgl->seen);
 }
 
-static void lglsmallevalcls (unsigned cls, Fun res) {
-  Fun tmp;
+static void lglsmallevalcls (int nq, unsigned cls, Fun res) {
   int v;
-  lglfalsefun (res);
+  lglfalsefun (nq, res);
   for (v = 0; v < FUNVAR; v++) {
-    if (cls & (1 << (2*v + 1))) {
-      lglvar2fun (v, tmp);
-      lglornegfun (res, tmp);
-    } else if (cls & (1 << (2*v))) {
-      lglvar2fun (v, tmp);
-      lglorfun (res, tmp);
-    }
+    if (cls & (1 << (2*v + 1))) lglorvar2fun (nq, v, res, 1);
+    else if (cls & (1 << (2*v))) lglorvar2fun (nq, v, res, 0);
   }
 }
 
@@ -14975,104 +16584,91 @@ static Cnf lglcnf (int pos, int size) {
 }
 
 static void lglsmallevalcnf (LGL * lgl, Cnf cnf, Fun res) {
-  Fun tmp;
+  const int nq = lgl->elm->funquads;
+  uint64_t * tmp = lglpushfun (lgl);
   int i, n, p, cls;
   p = lglcnf2pos (cnf);
   n = lglcnf2size (cnf);
-  lgltruefun (res);
+  lgltruefun (nq, res);
   for (i = 0; i < n; i++) {
     cls = lglpeek (&lgl->elm->clv, p + i);
-    lglsmallevalcls (cls, tmp);
-    lglandfun (res, tmp);
+    lglsmallevalcls (nq, cls, tmp);
+    lglandfun (nq, res, tmp);
   }
+  lglpopfuns (lgl, 1);
 }
 
-static void lglnegcofactorfun (const Fun f, int v, Fun res) {
-  Fun mask, masked;
-  lglvar2fun (v, mask);
-  lgland3negfun (masked, f, mask);
-  lglfuncpy (res, masked);
-  lglslfun (masked, (1 << v));
-  lglorfun (res, masked);
-}
-
-static void lglposcofactorfun (const Fun f, int v, Fun res) {
-  Fun mask, masked;
-  lglvar2fun (v, mask);
-  lgland3fun (masked, f, mask);
-  lglfuncpy (res, masked);
-  lglsrfun (masked, (1 << v));
-  lglorfun (res, masked);
-}
-
-static int lglsmallfundeps0 (const Fun f) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    if (((f[i] & 0xaaaaaaaaaaaaaaaaull)>>1) !=
-         (f[i] & 0x5555555555555555ull)) return 1;
-  return 0;
-}
-
-static int lglsmallfundeps1 (const Fun f) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    if (((f[i] & 0xccccccccccccccccull)>>2) !=
-         (f[i] & 0x3333333333333333ull)) return 1;
-  return 0;
-}
-
-static int lglsmallfundeps2 (const Fun f) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    if (((f[i] & 0xf0f0f0f0f0f0f0f0ull)>>4) !=
-         (f[i] & 0x0f0f0f0f0f0f0f0full)) return 1;
-  return 0;
-}
+// The cofactors are computed in one pass.  For 'v < 6' the half of each
+// word where 'v' has the requested value is copied into the other half,
+// otherwise whole words are copied.
 
-static int lglsmallfundeps3 (const Fun f) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    if (((f[i] & 0xff00ff00ff00ff00ull)>>8) !=
-         (f[i] & 0x00ff00ff00ff00ffull)) return 1;
-  return 0;
+static void lglnegcofactorfun (int nq, const Fun f, int v, Fun res) {
+  uint64_t mask, tmp;
+  int i, p;
+  if (v < 6) {
+    mask = lglbasevar2funtab[v];
+    for (i = 0; i < nq; i++) {
+      tmp = f[i] & ~mask;
+      res[i] = tmp | (tmp << (1 << v));
+    }
+  } else {
+    p = 1 << (v - 6);
+    assert (p < nq);
+    for (i = 0; i < nq; i++)
+      res[i] = f[i & ~p];
+  }
 }
 
-static int lglsmallfundeps4 (const Fun f) {
-  int i;
-  for (i = 0; i < FUNQUADS; i++)
-    if (((f[i] & 0xffff0000ffff0000ull)>>16) !=
-         (f[i] & 0x0000ffff0000ffffull)) return 1;
-  return 0;
+static void lglposcofactorfun (int nq, const Fun f, int v, Fun res) {
+  uint64_t mask, tmp;
+  int i, p;
+  if (v < 6) {
+    mask = lglbasevar2funtab[v];
+    for (i = 0; i < nq; i++) {
+      tmp = f[i] & mask;
+      res[i] = tmp | (tmp >> (1 << v));
+    }
+  } else {
+    p = 1 << (v - 6);
+    assert (p < nq);
+    for (i = 0; i < nq; i++)
+      res[i] = f[i | p];
+  }
 }
 
-static int lglsmallfundeps5 (const Fun f) {
+static int lglsmallfundeps (int nq, const Fun f, int v) {
+  const uint64_t mask = lglbasevar2funtab[v];
+  const int shift = 1 << v;
   int i;
-  for (i = 0; i < FUNQUADS; i++)
-    if (((f[i] & 0xffffffff00000000ull)>>32) !=
-         (f[i] & 0x00000000ffffffffull)) return 1;
+  assert (0 <= v && v < 6);
+  for (i = 0; i < nq; i++)
+    if (((f[i] & mask) >> shift) != (f[i] & ~mask)) return 1;
   return 0;
 }
 
-static int lglsmallfundepsgen (const Fun f, int min) {
+static int lglsmallfundepsgen (int nq, const Fun f, int min) {
   const int c = (1 << (min - 6));
   int i, j;
   assert (min >= 6);
-  for (i = 0; i < FUNQUADS; i += (1 << (min - 5)))
+  assert (2*c <= nq);
+  for (i = 0; i < nq; i += (1 << (min - 5)))
     for (j = 0; j < c; j++)
       if (f[i + j] != f[i + c + j]) return 1;
   return 0;
 }
 
-static int lglsmalltopvar (const Fun f, int min) {
+// Functions passed to this function do not depend on variables smaller
+// than 'min' (see 'lglsmallipos'), thus the first variable they depend
+// on is returned.  The last variable of the table is not checked.
+
+static int lglsmalltopvar (int nq, const Fun f, int min) {
   int i;
-  if (min == 0 && lglsmallfundeps0 (f)) return 0;
-  if (min == 1 && lglsmallfundeps1 (f)) return 1;
-  if (min == 2 && lglsmallfundeps2 (f)) return 2;
-  if (min == 3 && lglsmallfundeps3 (f)) return 3;
-  if (min == 4 && lglsmallfundeps4 (f)) return 4;
-  if (min == 5 && lglsmallfundeps5 (f)) return 5;
-  for (i = lglmax (6, min); i <= FUNVAR - 2; i++)
-    if (lglsmallfundepsgen (f, i)) return i;
+  for (i = min; i < 6; i++) {
+    if (nq == 1 && i == 5) return 5;
+    if (lglsmallfundeps (nq, f, i)) return i;
+  }
+  for (i = lglmax (6, min); (2 << (i - 6)) < nq; i++)
+    if (lglsmallfundepsgen (nq, f, i)) return i;
   return i;
 }
 
@@ -15094,9 +16690,9 @@ static Cnf lglsmalladdlit2cnf (LGL * lgl, Cnf cnf, int lit) {
 }
 
 #ifndef NDEBUG
-static int lglefun (const Fun a, const Fun b) {
+static int lglefun (int nq, const Fun a, const Fun b) {
   int i;
-  for (i = 0; i < FUNQUADS; i++)
+  for (i = 0; i < nq; i++)
     if (a[i] & ~b[i]) return 0;
   return 1;
 }
@@ -15109,32 +16705,37 @@ static int lglefun (const Fun a, const Fun b) {
 // maps and plain CNFs stored as lists of clauses instead.
 
 static Cnf lglsmallipos (LGL * lgl, const Fun U, const Fun L, int min) {
-  Fun U0, U1, L0, L1, Unew, ftmp;
+  const int nq = lgl->elm->funquads;
+  uint64_t * U0, * U1, * L0, * L1, * Unew, * ftmp;
   Cnf c0, c1, cstar, ctmp, res;
   int x, y, z;
-  assert (lglefun (L, U));
-  if (lglistruefun (U)) return TRUECNF;
-  if (lglisfalsefun (L)) return FALSECNF;
+  assert (lglefun (nq, L, U));
+  if (lglistruefun (nq, U)) return TRUECNF;
+  if (lglisfalsefun (nq, L)) return FALSECNF;
+  U0 = lglpushfun (lgl), U1 = lglpushfun (lgl);
+  L0 = lglpushfun (lgl), L1 = lglpushfun (lgl);
+  Unew = lglpushfun (lgl), ftmp = lglpushfun (lgl);
   lgl->stats->elm.ipos++;
   assert (min < (int) lglcntstk (&lgl->elm->m2i));
-  y = lglsmalltopvar (U, min);
-  z = lglsmalltopvar (L, min);
+  y = lglsmalltopvar (nq, U, min);
+  z = lglsmalltopvar (nq, L, min);
   INCSTEPS (elm.steps);
   x = (y < z) ? y : z;
   assert (x < FUNVAR);
-  lglnegcofactorfun (U, x, U0); lglposcofactorfun (U, x, U1);
-  lglnegcofactorfun (L, x, L0); lglposcofactorfun (L, x, L1);
-  lglor3negfun (ftmp, U0, L1);
+  lglnegcofactorfun (nq, U, x, U0); lglposcofactorfun (nq, U, x, U1);
+  lglnegcofactorfun (nq, L, x, L0); lglposcofactorfun (nq, L, x, L1);
+  lglor3negfun (nq, ftmp, U0, L1);
   c0 = lglsmallipos (lgl, ftmp, L0, min+1);
-  lglor3negfun (ftmp, U1, L0);
+  lglor3negfun (nq, ftmp, U1, L0);
   c1 = lglsmallipos (lgl, ftmp, L1, min+1);
   lglsmallevalcnf (lgl, c0, ftmp);
-  lglor3negfun (Unew, U0, ftmp);
+  lglor3negfun (nq, Unew, U0, ftmp);
   lglsmallevalcnf (lgl, c1, ftmp);
-  lglandornegfun (Unew, U1, ftmp);
-  lglor3fun (ftmp, L0, L1);
+  lglandornegfun (nq, Unew, U1, ftmp);
+  lglor3fun (nq, ftmp, L0, L1);
   cstar = lglsmallipos (lgl, Unew, ftmp, min+1);
   assert (cstar != FALSECNF);
+  lglpopfuns (lgl, 6);
   ctmp = lglsmalladdlit2cnf (lgl, c1, (1 << (2*x + 1)));
   res = lglcnf2pos (ctmp);
   ctmp = lglsmalladdlit2cnf (lgl, c0, (1 << (2*x)));
@@ -15206,7 +16807,7 @@ static int lglsmallcnfunits (LGL * lgl, Cnf cnf) {
 
 static int lgltrysmallve (LGL * lgl, int idx) {
   int res, new, old, units;
-  Fun pos, neg, fun;
+  uint64_t * pos, * neg, * fun;
   EVar * ev;
   Cnf cnf;
   assert (lglmtstk (&lgl->elm->m2i));
@@ -15217,9 +16818,14 @@ static int lgltrysmallve (LGL * lgl, int idx) {
   lglpushstk (lgl, &lgl->elm->m2i, 0);
   lglpushstk (lgl, &lgl->elm->clv, 0);
   res = 0;
-  if (lglinitsmallve (lgl, idx, pos) && lglinitsmallve (lgl, -idx, neg)) {
-    lglor3fun (fun, pos, neg);
+  if (lglmapsmallve (lgl, idx) && lglmapsmallve (lgl, -idx)) {
+    lgl->elm->funquads = lglfunquads (lglcntstk (&lgl->seen) - 1);
+    pos = lglpushfun (lgl), neg = lglpushfun (lgl), fun = lglpushfun (lgl);
+    lglinitsmallve (lgl, idx, pos);
+    lglinitsmallve (lgl, -idx, neg);
+    lglor3fun (lgl->elm->funquads, fun, pos, neg);
     cnf = lglsmallipos (lgl, fun, fun, 0);
+    lglpopfuns (lgl, 3);
     new = lglcnf2size (cnf);
     units = lglsmallcnfunits (lgl, cnf);
     assert (units <= new);
@@ -16916,20 +18522,363 @@ static void lglreltouched (LGL * lgl) {
   DEL (lgl->elm->touched.pos, lgl->elm->touched.nvars);
 }
 
-static int lglelim (LGL * lgl) {
-  int res = 1, idx, elmd, oldnvars, sched, success, all, rem;
-  int oldrem = lgl->elmrem, oldall = lgl->elmall, resched;
-  assert (lgl->opts->elim.val);
-  assert (!lgl->mt);
-  assert (lgl->nvars > 2);
-  assert (!lgl->eliminating);
-  assert (!lgl->simp);
-  assert (!lgl->occs);
-  lglstart (lgl, &lgl->times->elim);
-  lgl->stats->elm.count++;
-  lgl->eliminating = lgl->simp = lgl->occs = 1;
-  NEW (lgl->elm, 1);
-  lgl->elm->oldelmd = lgl->stats->elm.elmd;
+/*------------------------------------------------------------------------*/
+// Parallel bounded variable elimination ('elmpar' worker threads).  The
+// main thread pops a batch of up to 'elmparbatch' candidates from the
+// elimination schedule, such that the variables occurring together with
+// one candidate in irredundant clauses are disjoint from those of all
+// other candidates in the batch.  Candidates which are in conflict with
+// an earlier one are rescheduled for the next batch.  The worker threads
+// are started once per elimination and then wait for the next batch.
+// They generate the non-tautological resolvents of each candidate into
+// its own slice of a shared buffer, without modifying any other state,
+// and reject a candidate if it has more resolvents than clauses.  Finally
+// the main thread commits the resolvents of the accepted candidates in
+// schedule order and eliminates them.  Since the neighborhoods are
+// disjoint, eliminating one candidate does not change the clauses of
+// another one in the batch, unless units are derived, in which case the
+// rest of the batch is rescheduled.  Thus the result does not depend on
+// thread scheduling nor on the number of workers.  Unlike in sequential
+// elimination, candidates do not undergo subsumption and strengthening,
+// and only plain clause distribution is used, without gates and truth
+// tables.
+
+enum { ELMPARSKIP = 0, ELMPARPURE = 1, ELMPARRES = 2 };
+
+// Maximum size of the resolvent buffer slice of a single candidate and of
+// the whole buffer of a batch (in literals).
+
+#define ELMPARMAXLITS (1<<20)
+#define ELMPARBUFLITS (1<<22)
+
+typedef struct ElmParCand {
+  int idx, status, lit, start, cap, size;
+  int64_t steps;
+} ElmParCand;
+
+typedef struct ElmParWorker {
+  struct ElmPar * par;
+  signed char * mark;
+  pthread_t thread;
+} ElmParWorker;
+
+typedef struct ElmPar {
+  LGL * lgl;
+  int nworkers, szcands, ncands, next, batch, round, running, stop;
+  int * stamp, * lits, nlits, szlits;
+  ElmParCand * cands;
+  ElmParWorker * workers;
+  pthread_mutex_t lock;
+  pthread_cond_t go, done;
+} ElmPar;
+
+static const int * lglparelimcls (LGL * lgl, const int ** pptr,
+                                  int * buf) {
+  const int * p = *pptr;
+  int blit = *p, tag = blit & MASKCS;
+  if (tag == TRNCS || tag == LRGCS) *pptr = ++p;
+  if ((blit & REDCS) || tag == LRGCS) return 0;
+  if (tag == OCCS) return lglidx2lits (lgl, 0, blit >> RMSHFT);
+  buf[0] = blit >> RMSHFT;
+  buf[1] = (tag == TRNCS) ? *p : 0;
+  buf[2] = 0;
+  return buf;
+}
+
+static int lglparelimsat (LGL * lgl, const int * c) {
+  const int * l;
+  for (l = c; *l; l++)
+    if (lglval (lgl, *l) > 0) return 1;
+  return 0;
+}
+
+static void lglparelimres (LGL * lgl, signed char * mark,
+                           ElmParCand * cand, int * lits) {
+  const int * p, * q, * w, * eow, * v, * eov, * c, * d, * l;
+  int cbuf[3], dbuf[3], idx, lit, sign, limit, forced, failed, size;
+  int64_t steps = 0;
+  int * res;
+  HTS * hts;
+  idx = cand->idx;
+  cand->status = ELMPARSKIP;
+  if (cand->cap < 0) goto DONE;
+  if (!lglisfree (lgl, idx)) goto DONE;
+  if (lglispure (lgl, idx) || lglispure (lgl, -idx)) {
+    cand->status = ELMPARPURE;
+    cand->lit = lglispure (lgl, idx) ? idx : -idx;
+    goto DONE;
+  }
+  if (!lglchkoccs4elm (lgl, idx)) goto DONE;
+  if ((forced = lglforcedve (lgl, idx)) < 0) goto DONE;
+  limit = 0;
+  for (sign = -1; sign <= 1; sign += 2) {
+    hts = lglhts (lgl, sign * idx);
+    w = lglhts2wchs (lgl, hts);
+    eow = w + hts->count;
+    for (p = w; p < eow; p++) {
+      steps++;
+      if (!(c = lglparelimcls (lgl, &p, cbuf))) continue;
+      if (!lglparelimsat (lgl, c)) limit++;
+    }
+  }
+  hts = lglhts (lgl, idx);
+  w = lglhts2wchs (lgl, hts);
+  eow = w + hts->count;
+  hts = lglhts (lgl, -idx);
+  v = lglhts2wchs (lgl, hts);
+  eov = v + hts->count;
+  res = lits + cand->start;
+  failed = size = 0;
+  for (p = w; !failed && p < eow; p++) {
+    if (!(c = lglparelimcls (lgl, &p, cbuf))) continue;
+    if (lglparelimsat (lgl, c)) continue;
+    for (l = c; (lit = *l); l++)
+      if (lit != idx) mark[abs (lit)] = lglsgn (lit);
+    for (q = v; q < eov; q++) {
+      steps++;
+      if (!(d = lglparelimcls (lgl, &q, dbuf))) continue;
+      if (lglparelimsat (lgl, d)) continue;
+      for (l = d; (lit = *l); l++)
+	if (lit != -idx && mark[abs (lit)] == -lglsgn (lit)) break;
+      if (lit) continue;
+      if (!forced && --limit < 0) { failed = 1; break; }
+      for (l = c; (lit = *l); l++)
+	if (lit != idx && !lglval (lgl, lit)) res[size++] = lit;
+      for (l = d; (lit = *l); l++)
+	if (lit != -idx && !mark[abs (lit)] && !lglval (lgl, lit))
+	  res[size++] = lit;
+      res[size++] = 0;
+      assert (size <= cand->cap);
+    }
+    for (l = c; (lit = *l); l++) mark[abs (lit)] = 0;
+  }
+  if (failed) goto DONE;
+  cand->status = ELMPARRES;
+  cand->size = size;
+DONE:
+  cand->steps = steps;
+}
+
+static void * lglparelimworker (void * ptr) {
+  ElmParWorker * worker = ptr;
+  ElmPar * par = worker->par;
+  int round = 0, i;
+  pthread_mutex_lock (&par->lock);
+  for (;;) {
+    while (!par->stop && par->round == round)
+      pthread_cond_wait (&par->go, &par->lock);
+    if (par->stop) break;
+    round = par->round;
+    while ((i = par->next) < par->ncands) {
+      par->next++;
+      pthread_mutex_unlock (&par->lock);
+      lglparelimres (par->lgl, worker->mark, par->cands + i, par->lits);
+      pthread_mutex_lock (&par->lock);
+    }
+    if (!--par->running) pthread_cond_signal (&par->done);
+  }
+  pthread_mutex_unlock (&par->lock);
+  return 0;
+}
+
+// Stamps the neighborhood of the candidate and reserves the part of the
+// resolvent buffer which its resolvents need in the worst case.
+
+static int lglparelimstamp (ElmPar * par, ElmParCand * cand) {
+  const int * p, * w, * eow, * c, * l;
+  int cbuf[3], sign, lit, pass, len, n[2], m[2];
+  int batch = par->batch, * stamp = par->stamp, idx = cand->idx;
+  LGL * lgl = par->lgl;
+  int64_t cap;
+  HTS * hts;
+  n[0] = n[1] = m[0] = m[1] = 0;
+  for (pass = 0; pass <= 1; pass++) {
+    if (pass && stamp[idx] == batch) return 0;
+    if (pass) stamp[idx] = batch;
+    for (sign = -1; sign <= 1; sign += 2) {
+      hts = lglhts (lgl, sign * idx);
+      w = lglhts2wchs (lgl, hts);
+      eow = w + hts->count;
+      for (p = w; p < eow; p++) {
+	if (!(c = lglparelimcls (lgl, &p, cbuf))) continue;
+	for (l = c, len = 0; (lit = abs (*l)); l++) {
+	  if (!pass && stamp[lit] == batch) return 0;
+	  if (pass) stamp[lit] = batch;
+	  if (lit != idx) len++;
+	}
+	if (pass) continue;
+	n[sign > 0]++;
+	if (len > m[sign > 0]) m[sign > 0] = len;
+      }
+      ADDSTEPS (elm.steps, (eow - w) / 4);
+    }
+    if (pass) continue;
+    cap = n[0] * (int64_t) n[1];
+    if (lglforcedve (lgl, idx) <= 0 && n[0] + n[1] < cap)
+      cap = n[0] + n[1];
+    cap *= m[0] + m[1] + 1;
+    if (cap > ELMPARMAXLITS) cand->cap = -1;
+    else if (par->nlits + cap > ELMPARBUFLITS) return 0;
+    else {
+      cand->start = par->nlits;
+      cand->cap = cap;
+      par->nlits += cap;
+    }
+  }
+  return 1;
+}
+
+static void lglparelimcommit (ElmPar * par, ElmParCand * cand) {
+  const int * p, * eol;
+  LGL * lgl = par->lgl;
+  int idx = cand->idx, lit, trivial;
+  Val val;
+  LOG (2, "parallel elimination of %d", idx);
+  p = par->lits + cand->start;
+  eol = p + cand->size;
+  for (; !lgl->mt && p < eol; p++) {
+    assert (lglmtstk (&lgl->clause));
+    trivial = 0;
+    for (; (lit = *p); p++) {
+      val = lglval (lgl, lit);
+      if (val < 0) continue;
+      if (val > 0) trivial = 1;
+      lglpushstk (lgl, &lgl->clause, lit);
+    }
+    if (!trivial) {
+      INCSTEPS (elm.resolutions);
+      lglpushstk (lgl, &lgl->clause, 0);
+      LOGCLS (3, lgl->clause.start, "parallel elimination resolvent");
+      lgldrupligaddcls (lgl, REDCS);
+      lgladdcls (lgl, 0, 0, 1);
+    }
+    lglclnstk (&lgl->clause);
+  }
+  if (lgl->mt) return;
+  lglepusheliminated (lgl, idx);
+  lglflushclauses (lgl, idx);
+  lglflushclauses (lgl, -idx);
+  lgl->stats->elm.large++;
+}
+
+static void lglinitparelim (LGL * lgl, ElmPar * par) {
+  ElmParWorker * worker;
+  int i;
+  CLR (*par);
+  par->lgl = lgl;
+  par->nworkers = lgl->opts->elmpar.val;
+  par->szcands = lgl->opts->elmparbatch.val;
+  if (par->szcands > lgl->nvars) par->szcands = lgl->nvars;
+  NEW (par->stamp, lgl->nvars);
+  NEW (par->cands, par->szcands);
+  NEW (par->workers, par->nworkers);
+  pthread_mutex_init (&par->lock, 0);
+  pthread_cond_init (&par->go, 0);
+  pthread_cond_init (&par->done, 0);
+  for (i = 0; i < par->nworkers; i++) {
+    worker = par->workers + i;
+    worker->par = par;
+    NEW (worker->mark, lgl->nvars);
+    if (pthread_create (&worker->thread, 0, lglparelimworker, worker))
+      lglabort (lgl);
+  }
+}
+
+static void lglrelparelim (ElmPar * par) {
+  LGL * lgl = par->lgl;
+  int i;
+  pthread_mutex_lock (&par->lock);
+  par->stop = 1;
+  pthread_cond_broadcast (&par->go);
+  pthread_mutex_unlock (&par->lock);
+  for (i = 0; i < par->nworkers; i++)
+    pthread_join (par->workers[i].thread, 0);
+  pthread_cond_destroy (&par->done);
+  pthread_cond_destroy (&par->go);
+  pthread_mutex_destroy (&par->lock);
+  for (i = 0; i < par->nworkers; i++)
+    DEL (par->workers[i].mark, lgl->nvars);
+  DEL (par->workers, par->nworkers);
+  DEL (par->lits, par->szlits);
+  DEL (par->cands, par->szcands);
+  DEL (par->stamp, lgl->nvars);
+}
+
+static int lglparelim (ElmPar * par) {
+  int i, idx, ncands, trail, eliminated, res = 1;
+  LGL * lgl = par->lgl;
+  ElmParCand * cand;
+  Stk deferred;
+  CLR (deferred);
+  par->batch++;
+  par->nlits = ncands = 0;
+  while (!lglmtstk (&lgl->esched) && ncands < par->szcands) {
+    idx = lglpopesched (lgl);
+    cand = par->cands + ncands;
+    CLRPTR (cand);
+    cand->idx = idx;
+    if (lglparelimstamp (par, cand)) ncands++;
+    else lglpushstk (lgl, &deferred, idx);
+  }
+  if (par->nlits > par->szlits) {
+    DEL (par->lits, par->szlits);
+    par->szlits = par->nlits;
+    NEW (par->lits, par->szlits);
+  }
+  pthread_mutex_lock (&par->lock);
+  par->ncands = ncands;
+  par->next = 0;
+  par->running = par->nworkers;
+  par->round++;
+  pthread_cond_broadcast (&par->go);
+  while (par->running)
+    pthread_cond_wait (&par->done, &par->lock);
+  pthread_mutex_unlock (&par->lock);
+  trail = lglcntstk (&lgl->trail);
+  eliminated = 0;
+  for (i = 0; i < ncands; i++) {
+    cand = par->cands + i;
+    if (!res || lgl->limits->elm.steps <= lgl->stats->elm.steps ||
+	(int) lglcntstk (&lgl->trail) > trail) {
+      lglpushstk (lgl, &deferred, cand->idx);
+      continue;
+    }
+    ADDSTEPS (elm.steps, cand->steps);
+    lglavar (lgl, cand->idx)->donotelm = 1;
+    if (cand->status == ELMPARSKIP) continue;
+    eliminated++;
+    if (cand->status == ELMPARPURE) (void) lglpurelit (lgl, cand->lit);
+    else lglparelimcommit (par, cand);
+    res = lglflush (lgl);
+    assert (res || lgl->mt);
+  }
+  lgl->stats->elm.par.batches++;
+  lgl->stats->elm.par.cands += ncands;
+  lgl->stats->elm.par.passed += eliminated;
+  lgl->stats->elm.par.deferred += lglcntstk (&deferred);
+  LOG (2, "parallel elimination batch %d with %d candidates %d eliminated",
+       par->batch, ncands, eliminated);
+  for (i = 0; i < (int) lglcntstk (&deferred); i++)
+    lglesched (lgl, lglpeek (&deferred, i));
+  lglrelstk (lgl, &deferred);
+  return res;
+}
+
+static int lglelim (LGL * lgl) {
+  int res = 1, idx, elmd, oldnvars, sched, success, all, rem;
+  int oldrem = lgl->elmrem, oldall = lgl->elmall, resched;
+  ElmPar par;
+  assert (lgl->opts->elim.val);
+  assert (!lgl->mt);
+  assert (lgl->nvars > 2);
+  assert (!lgl->eliminating);
+  assert (!lgl->simp);
+  assert (!lgl->occs);
+  lglstart (lgl, &lgl->times->elim);
+  lgl->stats->elm.count++;
+  lgl->eliminating = lgl->simp = lgl->occs = 1;
+  NEW (lgl->elm, 1);
+  lgl->elm->oldelmd = lgl->stats->elm.elmd;
   lgl->elm->round = 1;
   lgl->elm->oldsteps = lgl->stats->elm.steps;
   lgl->stats->elm.rounds++;
@@ -16953,13 +18902,16 @@ static int lglelim (LGL * lgl) {
   lglsetelmlim (lgl, &resched);
   if (!resched) assert (!lgl->donotsched), lgl->donotsched = 1;
   sched = lglcntstk (&lgl->esched);
+  if (lgl->opts->elmpar.val) lglinitparelim (lgl, &par);
   while (res && !lglelmdone (lgl, &all)) {
+    if (lgl->opts->elmpar.val) { res = lglparelim (&par); continue; }
     idx = lglpopesched (lgl);
     lglavar (lgl, idx)->donotelm = 1;
     lglelimlit (lgl, idx);
     res = lglflush (lgl);
     assert (res || lgl->mt);
   }
+  if (lgl->opts->elmpar.val) lglrelparelim (&par);
   assert (lgl->touching), lgl->touching = 0;
   if (!resched) assert (lgl->donotsched), lgl->donotsched = 0;
   rem = lglcntstk (&lgl->esched);
@@ -16979,6 +18931,7 @@ static int lglelim (LGL * lgl) {
   lglrelstk (lgl, &lgl->esched);
   lglreltouched (lgl);
   lglrelecls (lgl);
+  lglrelfuns (lgl);
   lglsparse (lgl);
   lglgc (lgl);
   DEL (lgl->elm, 1);
@@ -17068,6 +19021,7 @@ INCONSISTENT:
   for (elit1 = 1; elit1 <= emax; elit1++) {
     elit2 = lglerepr (lgl, elit1);
     if (elit1 == elit2) continue;
+    if (abs (elit2) > emax) continue;
     assert (elit1 != -elit2);
     erepr1 = lglptrjmp (ereprs, emax, elit1);
     erepr2 = lglptrjmp (ereprs, emax, elit2);
@@ -18175,6 +20129,409 @@ static int lgltrd (LGL * lgl) {
   return !lgl->mt;
 }
 
+/*------------------------------------------------------------------------*/
+// Stand-alone backward subsumption and strengthening ('subsume').  All
+// irredundant clauses act as subsuming clauses and are checked against
+// the large irredundant clauses and, with 'subsumered', the kept large
+// learned clauses.  The clauses are copied and bucketed by size.  Each
+// subsuming clause is watched in one occurrence list only, the one of its
+// literal with the smallest number of occurrences in both phases, and the
+// occurrence lists store 64-bit literal signatures next to the clause
+// references.  A candidate is then checked by traversing the occurrence
+// lists of its literals and their negations up to its own size.  The
+// signatures of a block of entries are filtered in a tight loop, which the
+// compiler can turn into vector instructions, before the remaining
+// entries are checked literal by literal, allowing at most one clashing
+// literal (self-subsuming resolution).  These checks do not modify any
+// shared state and are distributed over 'subsumepar' worker threads in
+// batches of 'subsumebatch' candidates.  The results are applied by the
+// main thread in candidate order, thus independent of scheduling.
+
+#define SUBSUMEBLOCK 64
+
+typedef struct SubParWorker {
+  struct SubPar * par;
+  signed char * mark;
+  pthread_t thread;
+} SubParWorker;
+
+typedef struct SubPar {
+  LGL * lgl;
+  int nworkers, nclauses, ncands, next;
+  int * lits, * pos, * size, * rank, * start, * occs;
+  const int * cands;
+  uint64_t * sigs, * osigs;
+  int * remove;
+  int64_t * steps;
+  SubParWorker * workers;
+  pthread_mutex_t lock;
+} SubPar;
+
+static uint64_t lglsig64 (int lit) {
+  unsigned ulit = lglulit (lit);
+  assert (ulit >= 2);
+  ulit -= 2;
+  return 1ull << (ulit & 63);
+}
+
+static int lglsubsumend (SubPar * par, int begin, int end, int size) {
+  int mid;
+  while (begin < end) {
+    mid = begin + (end - begin)/2;
+    if (par->size[par->occs[mid]] <= size) begin = mid + 1;
+    else end = mid;
+  }
+  return begin;
+}
+
+static int lglsubsumecheck (SubPar * par, signed char * mark,
+                            int cidx, int didx, int64_t * stepsptr) {
+  const int * p;
+  int lit, flip, m;
+  flip = 0;
+  for (p = par->lits + par->pos[cidx]; (lit = *p); p++) {
+    *stepsptr += 1;
+    m = mark[abs (lit)];
+    if (m == lglsgn (lit)) continue;
+    if (!m || flip) return 0;
+    flip = lit;
+  }
+  if (flip) return -flip;
+  if (par->size[cidx] == par->size[didx] &&
+      par->rank[cidx] > par->rank[didx]) return 0;
+  return INT_MAX;
+}
+
+static int lglsubsumetry (SubPar * par, signed char * mark, int didx,
+                          int64_t * stepsptr) {
+  const int * d = par->lits + par->pos[didx], * p;
+  int size = par->size[didx], lit, sign, ulit, i, j, k, n, end, res;
+  uint64_t dsig, nsig, hit[SUBSUMEBLOCK];
+  const uint64_t * sigs;
+  dsig = 0;
+  for (p = d; (lit = *p); p++) {
+    mark[abs (lit)] = lglsgn (lit);
+    dsig |= lglsig64 (lit) | lglsig64 (-lit);
+  }
+  nsig = ~dsig;
+  res = 0;
+  for (p = d; !res && (lit = *p); p++) {
+    for (sign = 1; !res && sign >= -1; sign -= 2) {
+      ulit = lglulit (sign * lit);
+      i = par->start[ulit];
+      end = lglsubsumend (par, i, par->start[ulit + 1], size);
+      *stepsptr += 1;
+      while (!res && i < end) {
+	n = end - i;
+	if (n > SUBSUMEBLOCK) n = SUBSUMEBLOCK;
+	sigs = par->osigs + i;
+	for (j = 0; j < n; j++) hit[j] = sigs[j] & nsig;
+	*stepsptr += (n + 7)/8;
+	for (j = 0; !res && j < n; j++) {
+	  if (hit[j]) continue;
+	  k = par->occs[i + j];
+	  if (k == didx) continue;
+	  res = lglsubsumecheck (par, mark, k, didx, stepsptr);
+	}
+	i += n;
+      }
+    }
+  }
+  for (p = d; (lit = *p); p++) mark[abs (lit)] = 0;
+  return res;
+}
+
+static void * lglsubsumeworker (void * ptr) {
+  SubParWorker * worker = ptr;
+  SubPar * par = worker->par;
+  int i;
+  for (;;) {
+    pthread_mutex_lock (&par->lock);
+    i = par->next++;
+    pthread_mutex_unlock (&par->lock);
+    if (i >= par->ncands) break;
+    par->steps[i] = 0;
+    par->remove[i] = lglsubsumetry (par, worker->mark,
+                                    par->cands[i], par->steps + i);
+  }
+  return 0;
+}
+
+static void lglsetsubsumelim (LGL * lgl) {
+  int64_t limit, irrlim;
+  int pen, szpen;
+  limit = (lgl->opts->subsumereleff.val*lglvisearch (lgl))/1000;
+  if (limit < lgl->opts->subsumemineff.val)
+    limit = lgl->opts->subsumemineff.val;
+  if (lgl->opts->subsumemaxeff.val >= 0 &&
+      limit > lgl->opts->subsumemaxeff.val)
+    limit = lgl->opts->subsumemaxeff.val;
+  limit >>= (pen = lgl->limits->subs.pen + (szpen = lglszpen (lgl)));
+  irrlim = (lgl->stats->irr.clauses.cur) >> szpen;
+  if (lgl->opts->irrlim.val && limit < irrlim) {
+    limit = irrlim;
+    lglprt (lgl, 1,
+  "[subsume-%d] limit %lld based on %d irredundant clauses penalty %d",
+      lgl->stats->subs.count,
+      (LGLL) limit, lgl->stats->irr.clauses.cur, szpen);
+  } else
+    lglprt (lgl, 1, "[subsume-%d] limit %lld with penalty %d = %d + %d",
+      lgl->stats->subs.count, (LGLL) limit,
+      pen, lgl->limits->subs.pen, szpen);
+  lgl->limits->subs.steps = lgl->stats->subs.steps + limit;
+}
+
+static int lglsubsumecopy (LGL * lgl, Stk * lits, Stk * pos,
+                           const int * c) {
+  const int * p;
+  int lit;
+  for (p = c; (lit = *p); p++)
+    if (lglval (lgl, lit)) return 0;
+  lglpushstk (lgl, pos, lglcntstk (lits));
+  for (p = c; (lit = *p); p++) lglpushstk (lgl, lits, lit);
+  lglpushstk (lgl, lits, 0);
+  return 1;
+}
+
+static void lglsubsumeapply (LGL * lgl, int red, int lidx, int remove) {
+  const int druplig = lgl->opts->druplig.val;
+  int * c, * p, lit, glue;
+  c = lglidx2lits (lgl, red, lidx);
+  assert (*c < REMOVED);
+  if (red) lgl->stats->subs.red++;
+  if (remove == INT_MAX) {
+    LOGCLS (2, c, "subsumed %s clause", lglred2str (red));
+    if (druplig) lgldrupligdelclsaux (lgl, c);
+    lglrmlcls (lgl, lidx, red);
+    lgl->stats->subs.subsumed++;
+    lgl->stats->prgss++;
+    return;
+  }
+  LOGCLS (2, c, "removing %d and thus strengthening %s clause",
+          remove, lglred2str (red));
+  assert (lglmtstk (&lgl->clause));
+  for (p = c; (lit = *p); p++)
+    if (lit != remove) lglpushstk (lgl, &lgl->clause, lit);
+  lglpushstk (lgl, &lgl->clause, 0);
+  LOGCLS (2, lgl->clause.start, "strengthened clause");
+  if (druplig) {
+    lgldrupligaddcls (lgl, REDCS);
+    lgldrupligdelclsaux (lgl, c);
+  }
+  glue = red ? lglunscaleglue (lgl, lidx & GLUEMASK) : 0;
+  lglrmlcls (lgl, lidx, red);
+  lgladdcls (lgl, red, glue, 1);
+  lglclnstk (&lgl->clause);
+  lgl->stats->subs.strengthened++;
+}
+
+static void lglsubsume (LGL * lgl) {
+  int idx, sign, lit, blit, tag, red, other, other2, cls[4], glue, maxglue;
+  int i, j, k, n, ncands, nclauses, nworkers, nulits, first, rem, min;
+  int subsumed, strengthened, sizes, small, count, tmp, best;
+  int * buckets, * bucket, * noccs, * order;
+  const int * p, * w, * eow, * c;
+  int64_t steps;
+  Stk lits, pos, cands, lidxs;
+  SubPar par;
+  HTS * hts;
+  Stk * s;
+  if (lgl->nvars <= 2) return;
+  lglstart (lgl, &lgl->times->subsume);
+  lgl->stats->subs.count++;
+  if (lgl->level > 0) lglbacktrack (lgl, 0);
+  assert (!lgl->simp), assert (!lgl->notrim);
+  lgl->simp = lgl->notrim = 1;
+  CLR (lits); CLR (pos); CLR (cands); CLR (lidxs);
+  for (idx = 2; idx < lgl->nvars; idx++)
+    for (sign = -1; sign <= 1; sign += 2) {
+      lit = sign * idx;
+      hts = lglhts (lgl, lit);
+      w = lglhts2wchs (lgl, hts);
+      eow = w + hts->count;
+      for (p = w; p < eow; p++) {
+	blit = *p;
+	tag = blit & MASKCS;
+	if (tag == TRNCS || tag == LRGCS) p++;
+	if (tag == LRGCS) continue;
+	red = blit & REDCS;
+	if (red) continue;
+	other = blit >> RMSHFT;
+	if (abs (other) < idx) continue;
+	if (tag == TRNCS) {
+	  other2 = *p;
+	  if (abs (other2) < idx) continue;
+	} else other2 = 0;
+	cls[0] = lit, cls[1] = other, cls[2] = other2, cls[3] = 0;
+	lglsubsumecopy (lgl, &lits, &pos, cls);
+      }
+      ADDSTEPS (subs.steps, (eow - w)/4);
+    }
+  small = lglcntstk (&pos);
+  for (c = lgl->irr.start; c < lgl->irr.top; c = p + 1) {
+    p = c;
+    if (*c >= REMOVED) continue;
+    while (*p) p++;
+    if (!lglsubsumecopy (lgl, &lits, &pos, c)) continue;
+    lglpushstk (lgl, &lidxs, c - lgl->irr.start);
+  }
+  sizes = lglcntstk (&pos);
+  maxglue = lgl->opts->subsumered.val ?
+              lglscaleglue (lgl, lgl->opts->gluekeep.val) : -1;
+  if (maxglue >= MAXGLUE) maxglue = MAXGLUE - 1;
+  for (glue = 0; glue <= maxglue; glue++) {
+    s = lgl->red + glue;
+    for (c = s->start; c < s->top; c = p + 1) {
+      p = c;
+      if (*c >= REMOVED) continue;
+      assert (lglisact (*c)), c++, p++;
+      while (*p) p++;
+      if (!lglsubsumecopy (lgl, &lits, &pos, c)) continue;
+      lglpushstk (lgl, &lidxs, ((c - s->start) << GLUESHFT) | glue);
+    }
+  }
+  nclauses = lglcntstk (&pos);
+  ADDSTEPS (subs.steps, (lits.top - lits.start)/4);
+  CLR (par);
+  par.lgl = lgl;
+  par.nclauses = nclauses;
+  par.lits = lits.start;
+  par.pos = pos.start;
+  NEW (par.size, nclauses);
+  NEW (par.rank, nclauses);
+  NEW (par.sigs, nclauses);
+  nulits = 2*lgl->nvars;
+  NEW (noccs, nulits);
+  n = 0;
+  for (i = 0; i < nclauses; i++) {
+    for (p = par.lits + par.pos[i]; (lit = *p); p++) {
+      par.sigs[i] |= lglsig64 (lit);
+      if (i >= small) noccs[lglulit (lit)]++;
+    }
+    par.size[i] = p - (par.lits + par.pos[i]);
+    if (par.size[i] > n) n = par.size[i];
+  }
+  NEW (buckets, n + 2);
+  for (i = 0; i < sizes; i++) buckets[par.size[i] + 1]++;
+  for (k = 1; k <= n + 1; k++) buckets[k] += buckets[k-1];
+  NEW (order, sizes);
+  for (i = 0; i < sizes; i++) {
+    bucket = buckets + par.size[i];
+    par.rank[i] = *bucket;
+    order[(*bucket)++] = i;
+  }
+  for (i = sizes; i < nclauses; i++) par.rank[i] = INT_MAX;
+  DEL (buckets, n + 2);
+  NEW (par.start, nulits + 1);
+  NEW (par.occs, sizes);
+  NEW (par.osigs, sizes);
+  NEW (bucket, sizes);
+  for (i = 0; i < sizes; i++) {
+    best = INT_MAX;
+    min = 0;
+    for (p = par.lits + par.pos[i]; (lit = *p); p++) {
+      tmp = noccs[lglulit (lit)] + noccs[lglulit (-lit)];
+      if (tmp >= best) continue;
+      best = tmp, min = lit;
+    }
+    assert (min);
+    bucket[i] = lglulit (min);
+    par.start[bucket[i] + 1]++;
+  }
+  for (k = 1; k <= nulits; k++) par.start[k] += par.start[k-1];
+  for (k = nulits; k > 0; k--) par.start[k] = par.start[k-1];
+  for (j = 0; j < sizes; j++) {
+    i = order[j];
+    k = par.start[bucket[i] + 1]++;
+    par.occs[k] = i;
+    par.osigs[k] = par.sigs[i];
+  }
+  assert (par.start[nulits] == sizes);
+  DEL (bucket, sizes);
+  DEL (order, sizes);
+  DEL (noccs, nulits);
+  ADDSTEPS (subs.steps, nclauses);
+  par.nworkers = nworkers = lgl->opts->subsumepar.val;
+  NEW (par.workers, nworkers ? nworkers : 1);
+  for (i = 0; i < (nworkers ? nworkers : 1); i++) {
+    par.workers[i].par = &par;
+    NEW (par.workers[i].mark, lgl->nvars);
+  }
+  pthread_mutex_init (&par.lock, 0);
+  lglsetsubsumelim (lgl);
+  ncands = nclauses - small;
+  first = ncands ? lglrand (lgl) % (unsigned) ncands : 0;
+  subsumed = lgl->stats->subs.subsumed;
+  strengthened = lgl->stats->subs.strengthened;
+  count = 0;
+  for (rem = ncands; rem > 0; rem -= n) {
+    if (lgl->stats->subs.steps >= lgl->limits->subs.steps) break;
+    if (lglterminate (lgl)) break;
+    n = lgl->opts->subsumebatch.val;
+    if (n > rem) n = rem;
+    lglclnstk (&cands);
+    for (i = 0; i < n; i++) {
+      k = first + count + i;
+      if (k >= ncands) k -= ncands;
+      lglpushstk (lgl, &cands, small + k);
+    }
+    NEW (par.remove, n);
+    NEW (par.steps, n);
+    par.cands = cands.start;
+    par.ncands = n;
+    par.next = 0;
+    k = nworkers < n ? nworkers : n;
+    if (!k) lglsubsumeworker (par.workers);
+    for (i = 0; i < k; i++)
+      if (pthread_create (&par.workers[i].thread, 0,
+                          lglsubsumeworker, par.workers + i))
+	lglabort (lgl);
+    for (i = 0; i < k; i++)
+      pthread_join (par.workers[i].thread, 0);
+    steps = 0;
+    for (i = 0; i < n; i++) {
+      steps += par.steps[i];
+      if (!par.remove[i]) continue;
+      j = lglpeek (&cands, i) - small;
+      red = (j + small < sizes) ? 0 : REDCS;
+      if (!red && par.remove[i] != INT_MAX && !lglsmallirr (lgl)) continue;
+      lglsubsumeapply (lgl, red, lglpeek (&lidxs, j), par.remove[i]);
+    }
+    ADDSTEPS (subs.steps, steps);
+    DEL (par.steps, n);
+    DEL (par.remove, n);
+    count += n;
+  }
+  lgl->stats->subs.clauses += count;
+  pthread_mutex_destroy (&par.lock);
+  for (i = 0; i < (nworkers ? nworkers : 1); i++)
+    DEL (par.workers[i].mark, lgl->nvars);
+  DEL (par.workers, nworkers ? nworkers : 1);
+  DEL (par.osigs, sizes);
+  DEL (par.occs, sizes);
+  DEL (par.start, nulits + 1);
+  DEL (par.sigs, nclauses);
+  DEL (par.rank, nclauses);
+  DEL (par.size, nclauses);
+  lglrelstk (lgl, &lidxs);
+  lglrelstk (lgl, &cands);
+  lglrelstk (lgl, &pos);
+  lglrelstk (lgl, &lits);
+  subsumed = lgl->stats->subs.subsumed - subsumed;
+  strengthened = lgl->stats->subs.strengthened - strengthened;
+  LGLUPDPEN (subs, subsumed + strengthened);
+  lglprt (lgl, 1,
+    "[subsume-%d] checked %d of %d clauses %.0f%% with %d subsuming",
+    lgl->stats->subs.count, count, ncands, lglpcnt (count, ncands), sizes);
+  lglprt (lgl, 1,
+    "[subsume-%d] subsumed %d and strengthened %d clauses",
+    lgl->stats->subs.count, subsumed, strengthened);
+  assert (lgl->simp), assert (lgl->notrim);
+  lgl->simp = lgl->notrim = 0;
+  lglrep (lgl, 2, 'S');
+  lglstop (lgl);
+}
+
 static int lglunhdhasbins (LGL * lgl, const DFPR * dfpr,
 			   int lit, int irronly) {
   int blit, tag, other, val, red, ulit;
@@ -21391,62 +23748,430 @@ DONE:
 }
 
 /*------------------------------------------------------------------------*/
-
-static int lgltreducing (LGL * lgl) {
-  if (lgldelaying (lgl, "transred", &lgl->limits->trd.del.rem)) return 0;
-  if (lglwaiting (lgl, "transred", lgl->opts->transredwait.val)) return 0;
-  return lgl->opts->transred.val;
+// Bounded variable addition (BVA) as in 'SimpleBVA'.  For a pivot literal
+// it greedily collects a set of literals 'mlits' (starting with the pivot)
+// and a set of clauses 'mcls' containing the pivot, such that for every
+// literal 'l' in 'mlits' and clause 'C' in 'mcls' the clause obtained
+// from 'C' by replacing the pivot by 'l' is irredundant.  These clauses
+// are replaced by the clauses
+//
+//   (l | -x) for all 'l' in 'mlits' and (x | C\{pivot}) for all 'C'
+//
+// over a new extension variable 'x' which is kept as long as the number
+// of clauses is reduced.  The original clauses are resolvents on 'x' and
+// setting 'x' to the conjunction of 'mlits' satisfies the new clauses.
+// Thus the formula projected on all other variables does not change.
+// Nothing has to be pushed on the extension stack and frozen variables
+// can take part too.  The extension variable is never exported to the
+// user though (see 'lglnewdef').  Candidate clauses are taken from a
+// snapshot of the irredundant clauses with its own occurrence lists,
+// which is not extended by the added clauses.
+
+typedef struct BVA {
+  Stk lits, mlits, mcls, rows, pairs;
+  int nclauses, nulits, stamp;
+  int * pos, * size, * lidx, * start, * occs, * noccs;
+  int * cnt, * lstamp, * cstamp, * inmlits;
+  char * dead;
+} BVA;
+
+static void lglbvarmcls (LGL * lgl, BVA * bva, int cidx) {
+  const int * c, * p;
+  int lit;
+  assert (0 <= cidx && cidx < bva->nclauses);
+  if (bva->dead[cidx]) return;
+  bva->dead[cidx] = 1;
+  c = bva->lits.start + bva->pos[cidx];
+  for (p = c; (lit = *p); p++) {
+    assert (bva->noccs[lglulit (lit)] > 0);
+    bva->noccs[lglulit (lit)]--;
+  }
+  LOGCLS (2, c, "BVA removing irredundant clause");
+  if (bva->size[cidx] == 2) lglrmbcls (lgl, c[0], c[1], 0);
+  else if (bva->size[cidx] == 3) lglrmtcls (lgl, c[0], c[1], c[2], 0);
+  else lglrmlcls (lgl, bva->lidx[cidx], 0);
+  lgl->stats->bva.removed++;
 }
 
-static int lglunhiding (LGL * lgl) { 
-  if (lgldelaying (lgl, "unhide", &lgl->limits->unhd.del.rem)) return 0;
-  if (lglwaiting (lgl, "unhide", lgl->opts->unhidewait.val)) return 0;
-  return lgl->opts->unhide.val;
+static void lglbvaddcls (LGL * lgl, const int * c, int a, int b) {
+  const int * p;
+  assert (lglmtstk (&lgl->clause));
+  lglpushstk (lgl, &lgl->clause, a);
+  if (c) {
+    for (p = c; *p; p++)
+      if (*p != b) lglpushstk (lgl, &lgl->clause, *p);
+  } else lglpushstk (lgl, &lgl->clause, b);
+  lglpushstk (lgl, &lgl->clause, 0);
+  LOGCLS (2, lgl->clause.start, "BVA adding irredundant clause");
+  lgladdcls (lgl, 0, 0, 1);
+  lglclnstk (&lgl->clause);
+  lgl->stats->bva.added++;
 }
 
-static int lgldecomposing (LGL * lgl) { return lgl->opts->decompose.val; }
+static void lglbvapply (LGL * lgl, BVA * bva, int pivot) {
+  int nlits, ncls, i, j, x, * row;
+  const int * c;
+  nlits = lglcntstk (&bva->mlits);
+  ncls = lglcntstk (&bva->mcls);
+  assert ((int) lglcntstk (&bva->rows) == nlits * ncls);
+  x = lglnewdef (lgl);
+  LOG (2, "BVA replacing %d x %d clauses with pivot %d by %d with %d",
+       nlits, ncls, pivot, nlits + ncls, x);
+  for (i = 0; i < nlits; i++)
+    lglbvaddcls (lgl, 0, lglpeek (&bva->mlits, i), -x);
+  for (j = 0; j < ncls; j++) {
+    c = bva->lits.start + bva->pos[lglpeek (&bva->mcls, j)];
+    lglbvaddcls (lgl, c, x, pivot);
+  }
+  for (j = 0; j < ncls; j++) {
+    row = bva->rows.start + j*nlits;
+    for (i = 0; i < nlits; i++) lglbvarmcls (lgl, bva, row[i]);
+  }
+  lgl->stats->bva.vars++;
+  lgl->stats->prgss++;
+  lgl->stats->irrprgss++;
+}
 
-static int lglblocking (LGL * lgl) {
-  if (!lgl->opts->block.val) return 0;
-  if (lgl->allfrozen) return 0;
-  if (lgldelaying (lgl, "block", &lgl->limits->blk.del.rem)) return 0;
-  if (lgl->opts->blockwait.val && lgl->wait &&
-      (!lgl->opts->elim.val || !lgl->elmrtc)) {
-    lglprt (lgl, 2, 
-      "[block-waiting] for bounded variable elimination to be completed");
-    return 0;
+// Find all clauses 'D' which differ from a clause 'C' in 'mcls' only in
+// the pivot being replaced by another literal and count for each such
+// literal the number of clauses 'C' for which this is possible.
+
+static void lglbvapairs (LGL * lgl, BVA * bva, int pivot) {
+  int j, k, cidx, didx, lit, min, other, size, ncls, umin, ulit;
+  int round, cstamp;
+  const int * c, * d, * p;
+  ncls = lglcntstk (&bva->mcls);
+  lglclnstk (&bva->pairs);
+  round = ++bva->stamp;
+  for (j = 0; j < ncls; j++) {
+    cidx = lglpeek (&bva->mcls, j);
+    c = bva->lits.start + bva->pos[cidx];
+    size = bva->size[cidx];
+    min = 0;
+    for (p = c; (lit = *p); p++) {
+      lglsignedmark (lgl, lit);
+      if (lit == pivot) continue;
+      if (min && bva->noccs[lglulit (lit)] >= bva->noccs[lglulit (min)])
+	continue;
+      min = lit;
+    }
+    assert (min);
+    umin = lglulit (min);
+    cstamp = ++bva->stamp;
+    for (k = bva->start[umin]; k < bva->start[umin + 1]; k++) {
+      didx = bva->occs[k];
+      INCSTEPS (bva.steps);
+      if (didx == cidx) continue;
+      if (bva->dead[didx]) continue;
+      if (bva->size[didx] != size) continue;
+      if (bva->cstamp[didx] == round) continue;
+      d = bva->lits.start + bva->pos[didx];
+      other = 0;
+      for (p = d; (lit = *p); p++) {
+	if (lit == pivot) break;
+	if (lglsignedmarked (lgl, lit)) continue;
+	if (other) break;
+	other = lit;
+      }
+      if (lit || !other) continue;
+      if (abs (other) == abs (pivot)) continue;
+      ulit = lglulit (other);
+      if (bva->inmlits[ulit]) continue;
+      if (bva->lstamp[ulit] == cstamp) continue;
+      bva->lstamp[ulit] = cstamp;
+      bva->cstamp[didx] = round;
+      bva->cnt[ulit]++;
+      lglpushstk (lgl, &bva->pairs, other);
+      lglpushstk (lgl, &bva->pairs, j);
+      lglpushstk (lgl, &bva->pairs, didx);
+    }
+    for (p = c; (lit = *p); p++) lglsignedunmark (lgl, lit);
   }
-  if (!lglsmallirr (lgl)) return 0;
-  if (lgl->nvars <= 2) return 0;
-  if (lgl->mt) return 0;
-  if (lgl->blkrem) return 1;
-  return lgl->stats->irrprgss > lgl->limits->blk.irrprgss;
 }
 
-static int lgleliminating (LGL * lgl) {
-  if (!lgl->opts->elim.val) return 0;
-  if (lgl->allfrozen) return 0;
-  if (lgldelaying (lgl, "elim", &lgl->limits->elm.del.rem)) return 0;
-  if (!lglsmallirr (lgl)) return 0;
-  if (lgl->nvars <= 2) return 0;
-  if (lgl->mt) return 0;
-  if (lgl->elmrem) return 1;
-  return lgl->stats->irrprgss > lgl->limits->elm.irrprgss;
+// Returns non-zero if clauses with the given pivot have been replaced.
+
+static int lglbvalit (LGL * lgl, BVA * bva, int pivot) {
+  int nlits, ncls, red, newred, max, lmax, lit, ulit, i, j, k, res;
+  const int * p;
+  Stk newrows;
+  ulit = lglulit (pivot);
+  if (bva->noccs[ulit] < 2) return 0;
+  assert (lglmtstk (&bva->mlits));
+  lglclnstk (&bva->mcls);
+  lglclnstk (&bva->rows);
+  for (k = bva->start[ulit]; k < bva->start[ulit + 1]; k++) {
+    i = bva->occs[k];
+    if (bva->dead[i]) continue;
+    lglpushstk (lgl, &bva->mcls, i);
+    lglpushstk (lgl, &bva->rows, i);
+  }
+  ADDSTEPS (bva.steps, bva->start[ulit + 1] - bva->start[ulit]);
+  lglpushstk (lgl, &bva->mlits, pivot);
+  bva->inmlits[ulit] = 1;
+  nlits = 1;
+  ncls = lglcntstk (&bva->mcls);
+  red = nlits*ncls - nlits - ncls;
+  CLR (newrows);
+  for (;;) {
+    if (lgl->stats->bva.steps >= lgl->limits->bva.steps) break;
+    lglbvapairs (lgl, bva, pivot);
+    max = lmax = 0;
+    for (p = bva->pairs.start; p < bva->pairs.top; p += 3) {
+      ulit = lglulit (lit = *p);
+      if (bva->cnt[ulit] > max) max = bva->cnt[ulit], lmax = lit;
+    }
+    for (p = bva->pairs.start; p < bva->pairs.top; p += 3)
+      bva->cnt[lglulit (*p)] = 0;
+    if (!lmax) break;
+    newred = (nlits + 1)*max - (nlits + 1) - max;
+    if (newred <= red) break;
+    lglclnstk (&bva->mcls);
+    lglclnstk (&newrows);
+    for (p = bva->pairs.start; p < bva->pairs.top; p += 3) {
+      if (p[0] != lmax) continue;
+      j = p[1];
+      lglpushstk (lgl, &bva->mcls, lglpeek (&bva->rows, j*nlits));
+      for (i = 0; i < nlits; i++)
+	lglpushstk (lgl, &newrows, lglpeek (&bva->rows, j*nlits + i));
+      lglpushstk (lgl, &newrows, p[2]);
+    }
+    SWAP (Stk, bva->rows, newrows);
+    lglpushstk (lgl, &bva->mlits, lmax);
+    bva->inmlits[lglulit (lmax)] = 1;
+    nlits++;
+    ncls = max;
+    assert ((int) lglcntstk (&bva->mcls) == ncls);
+    red = newred;
+  }
+  lglrelstk (lgl, &newrows);
+  res = (red > 0);
+  if (res) lglbvapply (lgl, bva, pivot);
+  while (!lglmtstk (&bva->mlits))
+    bva->inmlits[lglulit (lglpopstk (&bva->mlits))] = 0;
+  return res;
 }
 
-static int lglbcaing (LGL * lgl) {
-  if (!lgl->opts->bca.val) return 0;
-  if (lgl->allfrozen) return 0;
-  if (lgldelaying (lgl, "bca", &lgl->limits->bca.del.rem)) return 0;
-  if (lglwaiting (lgl, "bca", lgl->opts->bcawait.val)) return 0;
-  if (!lglsmallirr (lgl)) return 0;
-  return 1;
+static void lglsetbvalim (LGL * lgl) {
+  int64_t limit;
+  int pen, szpen;
+  limit = (lgl->opts->bvareleff.val*lglvisearch (lgl))/1000;
+  if (limit < lgl->opts->bvamineff.val) limit = lgl->opts->bvamineff.val;
+  if (lgl->opts->bvamaxeff.val >= 0 && limit > lgl->opts->bvamaxeff.val)
+    limit = lgl->opts->bvamaxeff.val;
+  limit >>= (pen = lgl->limits->bva.pen + (szpen = lglszpen (lgl)));
+  lglprt (lgl, 1, "[bva-%d] limit %lld with penalty %d = %d + %d",
+    lgl->stats->bva.count, (LGLL) limit,
+    pen, lgl->limits->bva.pen, szpen);
+  lgl->limits->bva.steps = lgl->stats->bva.steps + limit;
+}
+
+static int lglbvacmp (BVA * bva, int a, int b) {
+  int res = bva->noccs[b] - bva->noccs[a];
+  if (res) return res;
+  return a - b;
 }
 
-static int lglreducing (LGL * lgl) {
-  int reducable;
-  if (!lgl->opts->reduce.val) return 0;
-  reducable = lgl->stats->red.lrg;
+#define LGLBVACMP(A,B) lglbvacmp (&bva, *(A), *(B))
+
+static void lglbva (LGL * lgl) {
+  int idx, sign, lit, blit, tag, red, other, other2, cls[4];
+  int i, k, ulit, ncands, vars, added, removed;
+  const int * p, * w, * eow, * c;
+  Stk pos, lidxs;
+  int * cands;
+  HTS * hts;
+  BVA bva;
+  if (lgl->nvars <= 2) return;
+  lglstart (lgl, &lgl->times->bva);
+  lgl->stats->bva.count++;
+  if (lgl->level > 0) lglbacktrack (lgl, 0);
+  assert (!lgl->dense), assert (!lgl->repr);
+  assert (!lgl->simp), assert (!lgl->notrim);
+  lgl->simp = lgl->notrim = 1;
+  CLR (bva); CLR (pos); CLR (lidxs);
+  for (idx = 2; idx < lgl->nvars; idx++)
+    for (sign = -1; sign <= 1; sign += 2) {
+      lit = sign * idx;
+      hts = lglhts (lgl, lit);
+      w = lglhts2wchs (lgl, hts);
+      eow = w + hts->count;
+      for (p = w; p < eow; p++) {
+	blit = *p;
+	tag = blit & MASKCS;
+	if (tag == TRNCS || tag == LRGCS) p++;
+	if (tag == LRGCS) continue;
+	red = blit & REDCS;
+	if (red) continue;
+	other = blit >> RMSHFT;
+	if (abs (other) < idx) continue;
+	if (tag == TRNCS) {
+	  other2 = *p;
+	  if (abs (other2) < idx) continue;
+	} else other2 = 0;
+	cls[0] = lit, cls[1] = other, cls[2] = other2, cls[3] = 0;
+	if (!lglsubsumecopy (lgl, &bva.lits, &pos, cls)) continue;
+	lglpushstk (lgl, &lidxs, -1);
+      }
+      ADDSTEPS (bva.steps, (eow - w)/4);
+    }
+  for (c = lgl->irr.start; c < lgl->irr.top; c = p + 1) {
+    p = c;
+    if (*c >= REMOVED) continue;
+    while (*p) p++;
+    if (!lglsubsumecopy (lgl, &bva.lits, &pos, c)) continue;
+    lglpushstk (lgl, &lidxs, c - lgl->irr.start);
+  }
+  bva.nclauses = lglcntstk (&pos);
+  ADDSTEPS (bva.steps, (bva.lits.top - bva.lits.start)/4);
+  bva.pos = pos.start;
+  bva.lidx = lidxs.start;
+  bva.nulits = 2*lgl->nvars;
+  NEW (bva.size, bva.nclauses);
+  NEW (bva.dead, bva.nclauses);
+  NEW (bva.cstamp, bva.nclauses);
+  NEW (bva.noccs, bva.nulits);
+  NEW (bva.cnt, bva.nulits);
+  NEW (bva.lstamp, bva.nulits);
+  NEW (bva.inmlits, bva.nulits);
+  NEW (bva.start, bva.nulits + 1);
+  for (i = 0; i < bva.nclauses; i++) {
+    for (p = bva.lits.start + bva.pos[i]; (lit = *p); p++)
+      bva.start[lglulit (lit) + 1]++;
+    bva.size[i] = p - (bva.lits.start + bva.pos[i]);
+  }
+  for (k = 1; k <= bva.nulits; k++) {
+    bva.noccs[k-1] = bva.start[k];
+    bva.start[k] += bva.start[k-1];
+  }
+  NEW (bva.occs, bva.start[bva.nulits]);
+  for (i = 0; i < bva.nclauses; i++)
+    for (p = bva.lits.start + bva.pos[i]; (lit = *p); p++)
+      bva.occs[bva.start[lglulit (lit)]++] = i;
+  for (k = bva.nulits; k > 0; k--) bva.start[k] = bva.start[k-1];
+  bva.start[0] = 0;
+  NEW (cands, bva.nulits);
+  ncands = 0;
+  for (k = 4; k < bva.nulits; k++)
+    if (bva.noccs[k] >= 2) cands[ncands++] = k;
+  SORT (int, cands, ncands, LGLBVACMP);
+  lglsetbvalim (lgl);
+  vars = lgl->stats->bva.vars;
+  added = lgl->stats->bva.added;
+  removed = lgl->stats->bva.removed;
+  for (i = 0; i < ncands; i++) {
+    if (lgl->stats->bva.steps >= lgl->limits->bva.steps) break;
+    if (lglterminate (lgl)) break;
+    if (!lglsmallirr (lgl)) break;
+    ulit = cands[i];
+    lit = (ulit & 1) ? -(ulit/2) : ulit/2;
+    while (lglbvalit (lgl, &bva, lit))
+      ;
+  }
+  DEL (cands, bva.nulits);
+  DEL (bva.occs, bva.start[bva.nulits]);
+  DEL (bva.start, bva.nulits + 1);
+  DEL (bva.inmlits, bva.nulits);
+  DEL (bva.lstamp, bva.nulits);
+  DEL (bva.cnt, bva.nulits);
+  DEL (bva.noccs, bva.nulits);
+  DEL (bva.cstamp, bva.nclauses);
+  DEL (bva.dead, bva.nclauses);
+  DEL (bva.size, bva.nclauses);
+  lglrelstk (lgl, &bva.pairs);
+  lglrelstk (lgl, &bva.rows);
+  lglrelstk (lgl, &bva.mcls);
+  lglrelstk (lgl, &bva.mlits);
+  lglrelstk (lgl, &bva.lits);
+  lglrelstk (lgl, &lidxs);
+  lglrelstk (lgl, &pos);
+  vars = lgl->stats->bva.vars - vars;
+  added = lgl->stats->bva.added - added;
+  removed = lgl->stats->bva.removed - removed;
+  LGLUPDPEN (bva, vars);
+  lglprt (lgl, 1,
+    "[bva-%d] added %d variables in %d candidate literals",
+    lgl->stats->bva.count, vars, ncands);
+  lglprt (lgl, 1,
+    "[bva-%d] replaced %d by %d irredundant clauses (%d fewer)",
+    lgl->stats->bva.count, removed, added, removed - added);
+  assert (lgl->simp), assert (lgl->notrim);
+  lgl->simp = lgl->notrim = 0;
+  lglrep (lgl, 2, 'A');
+  lglstop (lgl);
+}
+
+/*------------------------------------------------------------------------*/
+
+static int lgltreducing (LGL * lgl) {
+  if (lgldelaying (lgl, "transred", &lgl->limits->trd.del.rem)) return 0;
+  if (lglwaiting (lgl, "transred", lgl->opts->transredwait.val)) return 0;
+  return lgl->opts->transred.val;
+}
+
+static int lglsubsuming (LGL * lgl) {
+  if (lgldelaying (lgl, "subsume", &lgl->limits->subs.del.rem)) return 0;
+  return lgl->opts->subsume.val;
+}
+
+static int lglunhiding (LGL * lgl) { 
+  if (lgldelaying (lgl, "unhide", &lgl->limits->unhd.del.rem)) return 0;
+  if (lglwaiting (lgl, "unhide", lgl->opts->unhidewait.val)) return 0;
+  return lgl->opts->unhide.val;
+}
+
+static int lgldecomposing (LGL * lgl) { return lgl->opts->decompose.val; }
+
+static int lglblocking (LGL * lgl) {
+  if (!lgl->opts->block.val) return 0;
+  if (lgl->allfrozen) return 0;
+  if (lgldelaying (lgl, "block", &lgl->limits->blk.del.rem)) return 0;
+  if (lgl->opts->blockwait.val && lgl->wait &&
+      (!lgl->opts->elim.val || !lgl->elmrtc)) {
+    lglprt (lgl, 2, 
+      "[block-waiting] for bounded variable elimination to be completed");
+    return 0;
+  }
+  if (!lglsmallirr (lgl)) return 0;
+  if (lgl->nvars <= 2) return 0;
+  if (lgl->mt) return 0;
+  if (lgl->blkrem) return 1;
+  return lgl->stats->irrprgss > lgl->limits->blk.irrprgss;
+}
+
+static int lgleliminating (LGL * lgl) {
+  if (!lgl->opts->elim.val) return 0;
+  if (lgl->allfrozen) return 0;
+  if (lgldelaying (lgl, "elim", &lgl->limits->elm.del.rem)) return 0;
+  if (!lglsmallirr (lgl)) return 0;
+  if (lgl->nvars <= 2) return 0;
+  if (lgl->mt) return 0;
+  if (lgl->elmrem) return 1;
+  return lgl->stats->irrprgss > lgl->limits->elm.irrprgss;
+}
+
+static int lglbcaing (LGL * lgl) {
+  if (!lgl->opts->bca.val) return 0;
+  if (lgl->allfrozen) return 0;
+  if (lgldelaying (lgl, "bca", &lgl->limits->bca.del.rem)) return 0;
+  if (lglwaiting (lgl, "bca", lgl->opts->bcawait.val)) return 0;
+  if (!lglsmallirr (lgl)) return 0;
+  return 1;
+}
+
+static int lglbvaing (LGL * lgl) {
+  if (!lgl->opts->bva.val) return 0;
+  if (lgl->opts->druplig.val) return 0;
+  if (lgldelaying (lgl, "bva", &lgl->limits->bva.del.rem)) return 0;
+  if (lglwaiting (lgl, "bva", lgl->opts->bvawait.val)) return 0;
+  if (!lglsmallirr (lgl)) return 0;
+  return 1;
+}
+
+static int lglreducing (LGL * lgl) {
+  int reducable;
+  if (!lgl->opts->reduce.val) return 0;
+  reducable = lgl->stats->red.lrg;
   assert (reducable >= lgl->lrgluereasons);
   reducable -= lgl->lrgluereasons;
   assert (reducable >= lgl->stats->lir[0].clauses);
@@ -22890,6 +25615,356 @@ static void lglinitsweep (LGL * lgl) {
     rem, lglpcnt (rem, lgl->nvars - 2), ret);
 }
 
+/*------------------------------------------------------------------------*/
+// Before the first SAT query of a sweeping round the initial class is
+// refined by random simulation.  AND gates 'g = a_1 & ... & a_k' are
+// extracted from a base clause '(g | -a_1 | ... | -a_k)' and binary clauses
+// '(-g | a_i)'.  The gates are evaluated in topological order on
+// 'sweepsimwords' 64-bit words of random input patterns.  Gates on cycles
+// are treated as inputs.  Simulation is skipped unless 'sweepsimgates'
+// percent of the scheduled variables are defined by gates, since after
+// variable elimination for instance the remaining clauses often constrain
+// variables which would otherwise be simulated as inputs.
+//
+// Patterns which falsify an irredundant clause are masked out unless this
+// would remove all patterns, which for instance happens for unsatisfiable
+// miters.  Then, as in classical functional sweeping of circuits, all
+// patterns are used and literals equivalent in all models might be
+// separated, which only means that this equivalence is missed.  Literals
+// are normalized such that their first valid pattern bit is false and only
+// literals with identical signatures on valid patterns remain in the same
+// class.  All equivalences are still proven by SAT queries.
+
+static uint64_t lglsweepsimword (LGL * lgl, int lit, int word) {
+  uint64_t res;
+  res = lgl->swp->sim.vals[(size_t) abs (lit) * lgl->swp->sim.words + word];
+  return lit < 0 ? ~res : res;
+}
+
+static int lglsweepsimcmp (LGL * lgl, int a, int b) {
+  uint64_t u, v;
+  int i;
+  for (i = 0; i < lgl->swp->sim.words; i++) {
+    u = lglsweepsimword (lgl, a, i) & lgl->swp->sim.mask[i];
+    v = lglsweepsimword (lgl, b, i) & lgl->swp->sim.mask[i];
+    if (u < v) return -1;
+    if (u > v) return 1;
+  }
+  return abs (a) - abs (b);
+}
+
+#define LGLSWEEPSIMCMP(A,B) lglsweepsimcmp (lgl, *(A), *(B))
+
+static int lglsweepsimequal (LGL * lgl, int a, int b) {
+  int i;
+  for (i = 0; i < lgl->swp->sim.words; i++)
+    if ((lglsweepsimword (lgl, a, i) ^ lglsweepsimword (lgl, b, i)) &
+        lgl->swp->sim.mask[i])
+      return 0;
+  return 1;
+}
+
+static void lglsweepsimarkbins (LGL * lgl, int lit, int mark) {
+  const int * p, * w, * eow;
+  int blit, tag, other;
+  HTS * hts;
+  hts = lglhts (lgl, lit);
+  w = lglhts2wchs (lgl, hts);
+  eow = w + hts->count;
+  for (p = w; p < eow; p++) {
+    blit = *p;
+    tag = blit & MASKCS;
+    if (tag == TRNCS || tag == LRGCS) p++;
+    if (tag != BINCS) continue;
+    other = blit >> RMSHFT;
+    if (mark) lglsignedmark (lgl, other);
+    else lglsignedunmark (lgl, other);
+  }
+  ADDSTEPS (sweep.steps, eow - w);
+}
+
+static void lglsweepsimgate (LGL * lgl, int g, const int * c,
+                             Stk * gates, int * gate) {
+  const int * p;
+  int res;
+  if (gate[abs (g)]) return;
+  if (!lglisfree (lgl, g)) return;
+  lglsweepsimarkbins (lgl, -g, 1);
+  res = 1;
+  for (p = c; res && *p; p++)
+    if (*p != g) res = lglsignedmarked (lgl, -*p);
+  lglsweepsimarkbins (lgl, -g, 0);
+  if (!res) return;
+  LOG (3, "sweep simulation found AND gate with output %d", g);
+  gate[abs (g)] = lglcntstk (gates) + 1;
+  lglpushstk (lgl, gates, g);
+  for (p = c; *p; p++)
+    if (*p != g) lglpushstk (lgl, gates, -*p);
+  lglpushstk (lgl, gates, 0);
+}
+
+static int lglsweepsimextract (LGL * lgl, Stk * gates, int * gate) {
+  int idx, sign, lit, blit, tag, red, trn[4], count = 0;
+  const int * p, * q, * c, * w, * eow;
+  HTS * hts;
+  for (idx = 2; idx < lgl->nvars; idx++) {
+    if (lgl->stats->sweep.steps > lgl->limits->sweep.steps) return 0;
+    for (sign = -1; sign <= 1; sign += 2) {
+      lit = sign * idx;
+      hts = lglhts (lgl, lit);
+      w = lglhts2wchs (lgl, hts);
+      eow = w + hts->count;
+      for (p = w; p < eow; p++) {
+	blit = *p;
+	tag = blit & MASKCS;
+	if (tag == TRNCS || tag == LRGCS) p++;
+	if (tag != TRNCS) continue;
+	red = blit & REDCS;
+	if (red) continue;
+	trn[0] = lit, trn[1] = blit >> RMSHFT, trn[2] = *p, trn[3] = 0;
+	lglsweepsimgate (lgl, lit, trn, gates, gate);
+      }
+    }
+  }
+  for (c = lgl->irr.start; c < lgl->irr.top; c = q + 1) {
+    if (lgl->stats->sweep.steps > lgl->limits->sweep.steps) return 0;
+    if (*(q = c) >= REMOVED) continue;
+    for (q = c; *q; q++)
+      lglsweepsimgate (lgl, *q, c, gates, gate);
+  }
+  for (idx = 2; idx < lgl->nvars; idx++)
+    if (gate[idx]) count++;
+  return count;
+}
+
+static void lglsweepsimorder (LGL * lgl, Stk * gates, int * gate,
+                              Stk * order) {
+  int root, idx, input, cyclic;
+  const int * p;
+  signed char * state;
+  Stk work;
+  NEW (state, lgl->nvars);
+  CLR (work);
+  for (root = 2; root < lgl->nvars; root++) {
+    if (!gate[root] || state[root]) continue;
+    lglpushstk (lgl, &work, root);
+    while (!lglmtstk (&work)) {
+      idx = lgltopstk (&work);
+      if (state[idx] == 2) { (void) lglpopstk (&work); continue; }
+      p = gates->start + gate[idx];
+      if (!state[idx]) {
+	state[idx] = 1;
+	for (; (input = abs (*p)); p++)
+	  if (gate[input] && !state[input])
+	    lglpushstk (lgl, &work, input);
+	continue;
+      }
+      (void) lglpopstk (&work);
+      cyclic = 0;
+      for (; !cyclic && (input = abs (*p)); p++)
+	cyclic = gate[input] && state[input] != 2;
+      state[idx] = 2;
+      if (cyclic) gate[idx] = 0;
+      else lglpushstk (lgl, order, idx);
+    }
+    ADDSTEPS (sweep.steps, 1);
+  }
+  lglrelstk (lgl, &work);
+  DEL (state, lgl->nvars);
+}
+
+static void lglsweepsimulate (LGL * lgl, Stk * gates, int * gate,
+                              Stk * order) {
+  int words = lgl->swp->sim.words, idx, i, g;
+  uint64_t * vals, * v, w;
+  const int * p, * q;
+  vals = lgl->swp->sim.vals;
+  for (idx = 2; idx < lgl->nvars; idx++) {
+    v = vals + (size_t) idx * words;
+    for (i = 0; i < words; i++) {
+      w = lglrand (lgl);
+      w = (w << 32) | lglrand (lgl);
+      v[i] = w;
+    }
+  }
+  for (p = order->start; p < order->top; p++) {
+    idx = *p;
+    q = gates->start + gate[idx] - 1;
+    g = *q++;
+    assert (abs (g) == idx);
+    v = vals + (size_t) idx * words;
+    for (i = 0; i < words; i++) v[i] = ~(uint64_t) 0;
+    for (; *q; q++)
+      for (i = 0; i < words; i++)
+	v[i] &= lglsweepsimword (lgl, *q, i);
+    if (g < 0)
+      for (i = 0; i < words; i++) v[i] = ~v[i];
+    ADDSTEPS (sweep.steps, (q - (gates->start + gate[idx])));
+  }
+}
+
+static void lglsweepsimaskcls (LGL * lgl, const int * c) {
+  int words = lgl->swp->sim.words, i;
+  uint64_t * mask = lgl->swp->sim.mask;
+  const int * p;
+  uint64_t sat;
+  for (i = 0; i < words; i++) {
+    if (!mask[i]) continue;
+    sat = 0;
+    for (p = c; *p; p++) sat |= lglsweepsimword (lgl, *p, i);
+    mask[i] &= sat;
+  }
+  ADDSTEPS (sweep.steps, 1);
+}
+
+static int64_t lglsweepsimask (LGL * lgl) {
+  int idx, sign, lit, blit, tag, red, other, other2, cls[4], i;
+  const int * p, * q, * c, * w, * eow;
+  int64_t res;
+  uint64_t m;
+  HTS * hts;
+  for (i = 0; i < lgl->swp->sim.words; i++)
+    lgl->swp->sim.mask[i] = ~(uint64_t) 0;
+  for (idx = 2; idx < lgl->nvars; idx++)
+    for (sign = -1; sign <= 1; sign += 2) {
+      lit = sign * idx;
+      hts = lglhts (lgl, lit);
+      w = lglhts2wchs (lgl, hts);
+      eow = w + hts->count;
+      for (p = w; p < eow; p++) {
+	blit = *p;
+	tag = blit & MASKCS;
+	if (tag == TRNCS || tag == LRGCS) p++;
+	if (tag == LRGCS) continue;
+	red = blit & REDCS;
+	if (red) continue;
+	other = blit >> RMSHFT;
+	if (abs (other) < idx) continue;
+	cls[0] = lit, cls[1] = other;
+	if (tag == TRNCS) {
+	  other2 = *p;
+	  if (abs (other2) < idx) continue;
+	  cls[2] = other2, cls[3] = 0;
+	} else cls[2] = 0;
+	lglsweepsimaskcls (lgl, cls);
+      }
+    }
+  for (c = lgl->irr.start; c < lgl->irr.top; c = q + 1) {
+    if (*(q = c) >= REMOVED) continue;
+    while (*q) q++;
+    lglsweepsimaskcls (lgl, c);
+  }
+  res = 0;
+  for (i = 0; i < lgl->swp->sim.words; i++)
+    for (m = lgl->swp->sim.mask[i]; m; m &= m - 1)
+      res++;
+  if (!res)
+    for (i = 0; i < lgl->swp->sim.words; i++)
+      lgl->swp->sim.mask[i] = ~(uint64_t) 0;
+  return res;
+}
+
+static int lglsweepsimfirst (LGL * lgl, int lit) {
+  int i;
+  uint64_t m;
+  for (i = 0; !(m = lgl->swp->sim.mask[i]); i++)
+    assert (i + 1 < lgl->swp->sim.words);
+  return (lglsweepsimword (lgl, lit, i) & m & -m) != 0;
+}
+
+static void lglsweepsimrefine (LGL * lgl) {
+  int count, lit, size, newpartitions, i, j, classes;
+  const int * p, * q, * eop;
+  Stk newpartition, tmp;
+  CLR (newpartition);
+  CLR (tmp);
+  newpartitions = classes = 0;
+  eop = lgl->swp->partition.top;
+  for (p = lgl->swp->partition.start; p < eop; p = q + 1) {
+    for (q = p; (lit = *q); q++) {
+      if (lglsweepsimfirst (lgl, lit)) lit = -lit;
+      lglpushstk (lgl, &tmp, lit);
+    }
+    count = lglcntstk (&tmp);
+    SORTSTK (int, &tmp, LGLSWEEPSIMCMP);
+    ADDSTEPS (sweep.steps, count);
+    for (i = 0; i < count; i = j) {
+      lit = lglpeek (&tmp, i);
+      for (j = i + 1; j < count; j++)
+	if (!lglsweepsimequal (lgl, lit, lglpeek (&tmp, j))) break;
+      size = j - i;
+      if (size < 2) continue;
+      while (i < j) lglpushstk (lgl, &newpartition, lglpeek (&tmp, i++));
+      lglpushstk (lgl, &newpartition, 0);
+      newpartitions++;
+    }
+    lglclnstk (&tmp);
+    classes++;
+  }
+  lglrelstk (lgl, &tmp);
+  lgl->stats->sweep.sim.classes += newpartitions;
+  lgl->stats->sweep.sim.refined += lglcntstk (&lgl->swp->partition) -
+    lgl->swp->partitions - (lglcntstk (&newpartition) - newpartitions);
+  lglprt (lgl, 1,
+    "[sweep-%d-%d] simulation refined %d into %d classes with %d vars",
+    lgl->stats->sweep.count, lgl->swp->round, classes, newpartitions,
+    (int) lglcntstk (&newpartition) - newpartitions);
+  lglfitstk (lgl, &newpartition);
+  lglrelstk (lgl, &lgl->swp->partition);
+  lgl->swp->partition = newpartition;
+  lgl->swp->partitions = newpartitions;
+}
+
+static void lglsweepsim (LGL * lgl) {
+  int * gate, count, scheduled, defined;
+  Stk gates, order;
+  const int * p;
+  int64_t valid;
+  size_t size;
+  if (!lgl->opts->sweepsim.val) return;
+  if (lglmtstk (&lgl->swp->partition)) return;
+  NEW (gate, lgl->nvars);
+  CLR (gates);
+  CLR (order);
+  count = lglsweepsimextract (lgl, &gates, gate);
+  lglprt (lgl, 2,
+    "[sweep-%d-%d] extracted %d AND gates for simulation",
+    lgl->stats->sweep.count, lgl->swp->round, count);
+  if (!count) goto DONE;
+  lglsweepsimorder (lgl, &gates, gate, &order);
+  count = lglcntstk (&order);
+  scheduled = defined = 0;
+  for (p = lgl->swp->partition.start; p < lgl->swp->partition.top; p++)
+    if (*p) scheduled++, defined += (gate[abs (*p)] > 0);
+  if (100ll*defined < (int64_t) lgl->opts->sweepsimgates.val*scheduled) {
+    lglprt (lgl, 1,
+      "[sweep-%d-%d] only %d of %d scheduled variables %.0f%% "
+      "defined by AND gates (no simulation)",
+      lgl->stats->sweep.count, lgl->swp->round,
+      defined, scheduled, lglpcnt (defined, scheduled));
+    goto DONE;
+  }
+  lgl->stats->sweep.sim.count++;
+  lgl->stats->sweep.sim.gates += count;
+  lgl->swp->sim.words = lgl->opts->sweepsimwords.val;
+  size = (size_t) lgl->nvars * lgl->swp->sim.words;
+  NEW (lgl->swp->sim.vals, size);
+  NEW (lgl->swp->sim.mask, lgl->swp->sim.words);
+  lglsweepsimulate (lgl, &gates, gate, &order);
+  valid = lglsweepsimask (lgl);
+  lglprt (lgl, 1,
+    "[sweep-%d-%d] simulated %d AND gates on %lld of %d patterns",
+    lgl->stats->sweep.count, lgl->swp->round, count,
+    (LGLL) valid, 64 * lgl->swp->sim.words);
+  lglsweepsimrefine (lgl);
+  DEL (lgl->swp->sim.mask, lgl->swp->sim.words);
+  DEL (lgl->swp->sim.vals, size);
+DONE:
+  lglrelstk (lgl, &order);
+  lglrelstk (lgl, &gates);
+  DEL (gate, lgl->nvars);
+}
+
 static double lglsweepavgpartitionsize (LGL * lgl) {
   int count, n;
   double res;
@@ -23408,6 +26483,7 @@ RESTART:
   NEW (lgl->swp, 1);
   lgl->swp->round = round;
   lglinitsweep (lgl);
+  lglsweepsim (lgl);
   for (lgl->swp->query = 1;
     !lgl->mt &&
       !lglmtstk (&lgl->swp->partition) &&
@@ -23687,7 +26763,8 @@ static void lglshowfeatures (LGL * lgl) {
   lglmsgend (lgl);
 
 #ifdef LGLSC14CLASSIFY
-  if (lgl->opts->classify.val && lgl->stats->features == 1) {
+  if (lgl->opts->classify.val && lgl->stats->features == 1 &&
+      !(lgl->classifier && lgl->opts->presetclassify.val)) {
     const char * bucket =
       sc14classify (
 	f.vo, f.vc, f.co, f.cc, f.b, f.t, f.q,
@@ -23735,27 +26812,260 @@ DO_NOT_COMBINE_OPTIONS:
 }
 
 /*------------------------------------------------------------------------*/
+// Classifiers map the features of the formula to one of several option
+// presets, and are read from a file with one of the following entries
+// per line ('#' starts a comment):
+//
+//   preset <name> <option>=<value> ...
+//   point <preset> <feature>=<value> ...
+//   node <feature> <threshold> <below> <above>
+//
+// If there are 'node' lines they form a decision tree rooted at the first
+// node.  A feature value below the threshold continues with '<below>' and
+// otherwise with '<above>', which are either node numbers (counting from
+// zero in the order of the file) or preset names.  Otherwise the preset of
+// the nearest 'point' is selected, where the distance is measured on a
+// logarithmic scale over the features given for this point.  Presets
+// have to be defined before they are used.  A preset only changes options
+// which still have their default value and thus explicitly set options
+// take precedence.  Settings are stored as option offset and value pairs
+// terminated by '-1', nodes as four integers with preset children encoded
+// as '-1-<preset>', and points as preset followed by 'NFEATURES' values
+// with '-1' for unused features.
+
+static int lglfindpreset (Classifier * c, const char * name) {
+  int res;
+  for (res = 0; res < c->npresets; res++)
+    if (!strcmp (c->names[res], name)) return res;
+  return -1;
+}
 
-static int lglisimp (LGL * lgl) {
-  if (!lgl->opts->simplify.val) return 1;
+static int lglfindfeature (const char * name) {
+  int res;
+  for (res = 0; res < NFEATURES; res++)
+    if (!strcmp (featurenames[res], name)) return res;
+  return -1;
+}
 
-  if (lglquatresolving (lgl)) lglquatres (lgl);
-  if (lglterminate (lgl)) return 1;
-  assert (!lgl->mt);
+static int lglisnumstr (const char * str) {
+  const char * p = str;
+  if (*p == '-') p++;
+  if (!isdigit ((int) *p)) return 0;
+  while (isdigit ((int) *p)) p++;
+  return !*p;
+}
 
-  if (lglternresolving (lgl) && !lglternres (lgl)) return 0;
-  if (lglterminate (lgl)) return 1;
-  assert (!lgl->mt);
+static void lglrelclassifier (LGL * lgl) {
+  Classifier * c = lgl->classifier;
+  int i;
+  if (!c) return;
+  for (i = 0; i < c->npresets; i++) lgldelstr (lgl, c->names[i]);
+  DEL (c->names, c->szpresets);
+  lglrelstk (lgl, &c->settings);
+  lglrelstk (lgl, &c->nodes);
+  lglrelstk (lgl, &c->points);
+  DEL (c, 1);
+  lgl->classifier = 0;
+}
+
+static const char * lglparseclassifier (LGL * lgl, char * line) {
+  Classifier * c = lgl->classifier;
+  char * tok, * arg, * save;
+  int i, feature, preset;
+  const char * err = 0;
+  int64_t threshold;
+  size_t pos;
+  Opt * o;
+  if ((tok = strchr (line, '#'))) *tok = 0;
+  if (!(tok = strtok_r (line, " \t\r\n", &save))) return 0;
+  if (!strcmp (tok, "preset")) {
+    if (!(arg = strtok_r (0, " \t\r\n", &save))) return "preset name missing";
+    if (isdigit ((int) *arg)) return "preset name starts with digit";
+    if (lglfindpreset (c, arg) >= 0) return "preset defined twice";
+    if (c->npresets == c->szpresets) {
+      int newsz = c->szpresets ? 2*c->szpresets : 4;
+      RSZ (c->names, c->szpresets, newsz);
+      c->szpresets = newsz;
+    }
+    c->names[c->npresets++] = lglstrdup (lgl, arg);
+    while ((arg = strtok_r (0, " \t\r\n", &save))) {
+      if (!(tok = strchr (arg, '=')) || !lglisnumstr (tok + 1))
+	return "expected '<option>=<value>'";
+      *tok++ = 0;
+      for (o = FIRSTOPT (lgl); o <= LASTOPT (lgl); o++)
+	if (!strcmp (o->lng, arg)) break;
+      if (o > LASTOPT (lgl)) return "invalid option in preset";
+      lglpushstk (lgl, &c->settings, o - FIRSTOPT (lgl));
+      lglpushstk (lgl, &c->settings, atoi (tok));
+    }
+    lglpushstk (lgl, &c->settings, -1);
+  } else if (!strcmp (tok, "point")) {
+    if (!(arg = strtok_r (0, " \t\r\n", &save)) ||
+        (preset = lglfindpreset (c, arg)) < 0)
+      return "undefined or missing preset";
+    pos = lglcntstk (&c->points);
+    lglpushstk (lgl, &c->points, preset);
+    for (i = 0; i < NFEATURES; i++) lglpushstk (lgl, &c->points, -1);
+    while (!err && (arg = strtok_r (0, " \t\r\n", &save))) {
+      if (!(tok = strchr (arg, '=')) || !lglisnumstr (tok + 1) ||
+          tok[1] == '-')
+	err = "expected '<feature>=<non-negative-value>'";
+      else {
+	*tok++ = 0;
+	if ((feature = lglfindfeature (arg)) < 0) err = "invalid feature";
+	else lglpoke (&c->points, pos + 1 + feature, atoi (tok));
+      }
+    }
+    if (err) lglrststk (&c->points, pos);
+  } else if (!strcmp (tok, "node")) {
+    if (!(arg = strtok_r (0, " \t\r\n", &save)) ||
+        (feature = lglfindfeature (arg)) < 0)
+      return "invalid or missing feature";
+    if (!(arg = strtok_r (0, " \t\r\n", &save)) || !lglisnumstr (arg))
+      return "invalid or missing threshold";
+    threshold = strtoll (arg, 0, 10);
+    if (threshold < INT_MIN || threshold > INT_MAX)
+      return "threshold out of range";
+    pos = lglcntstk (&c->nodes);
+    lglpushstk (lgl, &c->nodes, feature);
+    lglpushstk (lgl, &c->nodes, (int) threshold);
+    for (i = 0; !err && i < 2; i++) {
+      if (!(arg = strtok_r (0, " \t\r\n", &save)))
+	err = "child missing";
+      else if (lglisnumstr (arg) && *arg != '-')
+	lglpushstk (lgl, &c->nodes, atoi (arg));
+      else if ((preset = lglfindpreset (c, arg)) >= 0)
+	lglpushstk (lgl, &c->nodes, -1 - preset);
+      else err = "undefined preset";
+    }
+    if (!err && strtok_r (0, " \t\r\n", &save)) err = "trailing token";
+    if (err) lglrststk (&c->nodes, pos);
+  } else return "expected 'preset', 'point' or 'node'";
+  return err;
+}
+
+int lglreadclassifier (LGL * lgl, FILE * file) {
+  const char * err = 0;
+  int lineno, nnodes, i, child;
+  char line[1024];
+  REQINITNOTFORKED ();
+  lglrelclassifier (lgl);
+  NEW (lgl->classifier, 1);
+  lineno = 0;
+  while (!err && fgets (line, sizeof line, file)) {
+    lineno++;
+    if (!strchr (line, '\n') && !feof (file)) err = "line too long";
+    else err = lglparseclassifier (lgl, line);
+  }
+  nnodes = lglcntstk (&lgl->classifier->nodes) / 4;
+  for (i = 0; !err && i < nnodes; i++) {
+    child = lglpeek (&lgl->classifier->nodes, 4*i + 2);
+    if (child >= nnodes) err = "node number out of range";
+    child = lglpeek (&lgl->classifier->nodes, 4*i + 3);
+    if (child >= nnodes) err = "node number out of range";
+    if (err) lineno = 0;
+  }
+  if (!err && !nnodes && lglmtstk (&lgl->classifier->points))
+    err = "no 'node' nor 'point' entries", lineno = 0;
+  if (err) {
+    if (lineno) lglwrn (lgl, "classifier line %d: %s", lineno, err);
+    else lglwrn (lgl, "classifier: %s", err);
+    lglrelclassifier (lgl);
+    return -1;
+  }
+  lglprt (lgl, 1,
+    "[classify] read %d presets, %d nodes and %d points",
+    lgl->classifier->npresets, nnodes,
+    (int) lglcntstk (&lgl->classifier->points) / (NFEATURES + 1));
+  return lgl->classifier->npresets;
+}
 
-  if (lglcarding (lgl) && !lglcard (lgl)) return 0;
-  if (lglterminate (lgl)) return 1;
-  assert (!lgl->mt);
+static int lglclassifytree (LGL * lgl, const int * f) {
+  Classifier * c = lgl->classifier;
+  int node = 0, steps = 0;
+  const int * n;
+  do {
+    n = c->nodes.start + 4*node;
+    node = n[2 + (f[n[0]] >= n[1])];
+    if (steps++ > (int) lglcntstk (&c->nodes) / 4) return -1;   // cycle
+  } while (node >= 0);
+  return -1 - node;
+}
 
-  if (lglgaussing (lgl) && !lglgauss (lgl)) return 0;
-  if (lglterminate (lgl)) return 1;
-  assert (!lgl->mt);
+static int lglclassifynn (LGL * lgl, const int * f) {
+  Classifier * c = lgl->classifier;
+  double dist, min, delta;
+  const int * p;
+  int i, res;
+  res = -1, min = 0;
+  for (p = c->points.start; p < c->points.top; p += NFEATURES + 1) {
+    dist = 0;
+    for (i = 0; i < NFEATURES; i++) {
+      if (p[1 + i] < 0) continue;
+      delta = log2 (1.0 + p[1 + i]) - log2 (1.0 + (f[i] < 0 ? 0 : f[i]));
+      dist += delta * delta;
+    }
+    if (res >= 0 && dist >= min) continue;
+    res = p[0];
+    min = dist;
+  }
+  return res;
+}
 
-  if (lgldecomposing (lgl) && !lgldecomp (lgl)) return 0;
+static void lglclassify (LGL * lgl) {
+  Classifier * c = lgl->classifier;
+  int preset, count, i;
+  const int * p;
+  Features f;
+  Opt * o;
+  if (!c || !lgl->opts->presetclassify.val) return;
+  f = lglfeatures (lgl);
+  if (lglmtstk (&c->nodes)) preset = lglclassifynn (lgl, (int*) &f);
+  else preset = lglclassifytree (lgl, (int*) &f);
+  if (preset < 0) {
+    lglwrn (lgl, "classifier decision tree has a cycle");
+    return;
+  }
+  p = c->settings.start;
+  for (i = 0; i < preset; i++) while (*p++ >= 0) p++;
+  lglprt (lgl, 1, "[classify] selected preset '%s'", c->names[preset]);
+  for (count = 0; *p >= 0; p += 2) {
+    o = FIRSTOPT (lgl) + p[0];
+    if (o->val != o->dflt) {
+      lglprt (lgl, 2,
+        "[classify] keeping '--%s=%d' instead of %d from preset",
+	o->lng, o->val, p[1]);
+      continue;
+    }
+    lglprt (lgl, 1, "[classify] setting '--%s=%d'", o->lng, p[1]);
+    lglsetopt (lgl, o->lng, p[1]);
+    count++;
+  }
+  lglprt (lgl, 1, "[classify] changed %d options", count);
+}
+
+/*------------------------------------------------------------------------*/
+
+static int lglisimp (LGL * lgl) {
+  if (!lgl->opts->simplify.val) return 1;
+
+  if (lglquatresolving (lgl)) lglquatres (lgl);
+  if (lglterminate (lgl)) return 1;
+  assert (!lgl->mt);
+
+  if (lglternresolving (lgl) && !lglternres (lgl)) return 0;
+  if (lglterminate (lgl)) return 1;
+  assert (!lgl->mt);
+
+  if (lglcarding (lgl) && !lglcard (lgl)) return 0;
+  if (lglterminate (lgl)) return 1;
+  assert (!lgl->mt);
+
+  if (lglgaussing (lgl) && !lglgauss (lgl)) return 0;
+  if (lglterminate (lgl)) return 1;
+  assert (!lgl->mt);
+
+  if (lgldecomposing (lgl) && !lgldecomp (lgl)) return 0;
   if (lglterminate (lgl)) return 1;
   assert (!lgl->mt);
 
@@ -23779,6 +27089,10 @@ static int lglisimp (LGL * lgl) {
   if (lglterminate (lgl)) return 1;
   assert (!lgl->mt);
 
+  if (lglsubsuming (lgl)) lglsubsume (lgl);
+  if (lglterminate (lgl)) return 1;
+  assert (!lgl->mt);
+
   if (lgleliminating (lgl) && !lglelim (lgl)) return 0;
   if (lglterminate (lgl)) return 1;
   assert (!lgl->mt);
@@ -23787,6 +27101,10 @@ static int lglisimp (LGL * lgl) {
   if (lglterminate (lgl)) return 1;
   assert (!lgl->mt);
 
+  if (lglbvaing (lgl)) lglbva (lgl);
+  if (lglterminate (lgl)) return 1;
+  assert (!lgl->mt);
+
   if (lglbcaing (lgl)) lglbca (lgl);
   if (lglterminate (lgl)) return 1;
   assert (!lgl->mt);
@@ -24335,6 +27653,8 @@ static void lglincsetup (LGL * lgl) {
   CLR (lgl->limits->ternres.del);
   CLR (lgl->limits->cce.del);
   CLR (lgl->limits->card.del);
+  CLR (lgl->limits->subs.del);
+  CLR (lgl->limits->bva.del);
 
   CLR (lgl->limits->gauss.del);
 
@@ -24347,6 +27667,7 @@ static void lglincsetup (LGL * lgl) {
 
 static void lglsetup (LGL * lgl) {
   if (lgl->setuponce) goto DONE;
+  lglclassify (lgl);
   lgl->limits->dfg = lgl->stats->pshwchs + lgl->opts->defragint.val;
 
   lgl->limits->blk.irrprgss = -1;
@@ -24410,49 +27731,49 @@ static void lglcomputechanged (LGL * lgl) {
   LOG (1, "changed %d assignments in extension", lgl->changed);
 }
 
+// Initial value of an imported external variable before extension, which
+// for non-representative external variables is taken from the initial
+// value of their external representative.
+
+static int lgleinitval (LGL * lgl, int eidx) {
+  int ilit, val, erepr;
+  Ext * ext;
+  ext = lglelit2ext (lgl, eidx);
+  assert (ext->imported);
+  if (ext->equiv) {
+    erepr = lglerepr (lgl, eidx);
+LOG (3, "initializing external %d assignment from external representative %d",
+	 eidx, erepr);
+    assert (erepr != eidx);
+    ext = lglelit2ext (lgl, erepr);
+    ilit = ext->repr;
+    if (ext->imported) val = (ilit && lglcval (lgl, ilit) > 0) ? 1 : -1;
+    else val = ilit ? lglcval (lgl, ilit) : 0;
+    if (erepr < 0) val = -val;
+  } else if ((ilit = ext->repr)) {
+    LOG (3, "using external %d to internal %d mapping", eidx, ilit);
+    val = lglcval (lgl, ilit);
+  } else {
+    LOG (3, "external %d without internal representative", eidx);
+    val = 0;
+  }
+  return val;
+}
+
 static void lglextend (LGL * lgl) {
-  int * p, lit, eidx, ilit, next, satisfied, val, * start, erepr, equiv;
-  Ext * ext, * extrepr;
+  int * p, lit, eidx, next, satisfied, val, * start;
+  Ext * ext;
   assert (lgl->state & SATISFIED);
   assert (!(lgl->state & EXTENDED));
   lgleunassignall (lgl);
-  for (equiv = 0; equiv <= 1; equiv++) {
-    if (equiv)
-      LOG (1, "initializing assignment of non-representative externals");
-    else
-      LOG (1, "initializing assignment of external representatives");
-    for (eidx = 1; eidx <= lgl->maxext; eidx++) {
-      ext = lglelit2ext (lgl, eidx);
-      if (!ext->imported) continue;
-      if (equiv != ext->equiv) continue;
-      assert (!ext->val);
-      if (ext->equiv) {
-	erepr = lglerepr (lgl, eidx);
-LOG (3, "initializing external %d assignment from external representative %d",
-	 eidx, erepr);
-	assert (erepr != eidx);
-	extrepr = lglelit2ext (lgl, erepr);
-	if (!(val = extrepr->val)) {
-	  ilit = extrepr->repr;
-	  if (ilit) {
-	    LOG (3, "using external %d to internal %d mapping",
-		 abs (erepr), ilit);
-	    val = lglcval (lgl, ilit);
-	  } else
-LOG (3, "external %d without internal representative", abs (erepr));
-	}
-	if (erepr < 0) val = -val;
-      } else
-      if ((ilit = ext->repr)) {
-	LOG (3, "using external %d to internal %d mapping", eidx, ilit);
-	val = lglcval (lgl, ilit);
-      } else {
-	LOG (3, "external %d without internal representative", eidx);
-	val = 0;
-      }
-      lit = (val > 0) ? eidx : -eidx;
-      lgleassign (lgl, lit);
-    }
+  LOG (1, "initializing assignment of externals");
+  for (eidx = 1; eidx <= lgl->maxext + lgl->ndefs; eidx++) {
+    ext = lglelit2ext (lgl, eidx);
+    if (!ext->imported) continue;
+    assert (!ext->val);
+    val = lgleinitval (lgl, eidx);
+    lit = (val > 0) ? eidx : -eidx;
+    lgleassign (lgl, lit);
   }
   start = lgl->extend.start;
   p = lgl->extend.top;
@@ -24491,10 +27812,172 @@ SKIP:
   TRANS (EXTENDED);
 }
 
+/*------------------------------------------------------------------------*/
+// Partial extension only assigns the given external variables.  It uses an
+// index from external variables to the sigma clauses on the extension
+// stack in which they are the witness (the first literal), which is
+// updated incrementally since the extension stack only grows.  Starting
+// from the given variables, the closure of sigma clauses on which their
+// final value depends is computed.  A sigma clause depends on the sigma
+// clauses above it (which are processed before) with a witness among its
+// literals.  Only these sigma clauses are then processed top-down as in
+// 'lglextend'.
+
+static void lglidxextend (LGL * lgl) {
+  int pos, top, seg, eidx;
+  top = lglcntstk (&lgl->extend);
+  for (pos = lgl->extidxed; pos < top; pos++) {
+    eidx = abs (lglpeek (&lgl->extend, pos));
+    assert (eidx);
+    while ((int) lglcntstk (&lgl->exthead) <= eidx)
+      lglpushstk (lgl, &lgl->exthead, -1);
+    seg = lglcntstk (&lgl->extseg) / 2;
+    lglpushstk (lgl, &lgl->extseg, pos);
+    lglpushstk (lgl, &lgl->extseg, lglpeek (&lgl->exthead, eidx));
+    lglpoke (&lgl->exthead, eidx, seg);
+    while (lglpeek (&lgl->extend, pos)) pos++;
+  }
+  lgl->extidxed = top;
+}
+
+static int lglcmprevseg (int a, int b) { return (a < b) - (a > b); }
+
+#define LGLCMPREVSEG(P,Q) lglcmprevseg (*(P), *(Q))
+
+static void lglpartextend (LGL * lgl, const int * vars, int n) {
+  int i, eidx, other, seg, lim, lit, val, satisfied;
+  Stk work, touched, needed;
+  const int * p;
+  Ext * ext;
+  assert (lgl->state & SATISFIED);
+  assert (!(lgl->state & EXTENDED));
+  lglidxextend (lgl);
+  while ((int) lglcntstk (&lgl->extlim) <= lgl->maxext + lgl->ndefs)
+    lglpushstk (lgl, &lgl->extlim, INT_MAX);
+  CLR (work); CLR (touched); CLR (needed);
+  for (i = 0; i < n; i++) {
+    eidx = abs (vars[i]);
+    if (!eidx || eidx > lgl->maxext) continue;
+    lglpushstk (lgl, &work, eidx);
+    lglpushstk (lgl, &work, -1);
+  }
+  while (!lglmtstk (&work)) {
+    seg = lglpopstk (&work);
+    eidx = lglpopstk (&work);
+    lim = lglpeek (&lgl->extlim, eidx);
+    if (seg >= lim) continue;
+    if (lim == INT_MAX) lglpushstk (lgl, &touched, eidx);
+    lglpoke (&lgl->extlim, eidx, seg);
+    if (eidx < (int) lglcntstk (&lgl->exthead))
+      i = lglpeek (&lgl->exthead, eidx);
+    else i = -1;
+    while (i > seg) {
+      if (i < lim) {
+	lglpushstk (lgl, &needed, i);
+	p = lgl->extend.start + lglpeek (&lgl->extseg, 2*i);
+	while ((lit = *p++)) {
+	  if ((other = abs (lit)) == eidx) continue;
+	  lglpushstk (lgl, &work, other);
+	  lglpushstk (lgl, &work, i);
+	}
+      }
+      i = lglpeek (&lgl->extseg, 2*i + 1);
+    }
+  }
+  lglrelstk (lgl, &work);
+  for (p = touched.start; p < touched.top; p++) {
+    ext = lglelit2ext (lgl, *p);
+    ext->val = 0;
+    ext->extended = 0;
+    if (!ext->imported) continue;
+    val = lgleinitval (lgl, *p);
+    lgleassign (lgl, (val > 0) ? *p : -*p);
+  }
+  SORTSTK (int, &needed, LGLCMPREVSEG);
+  for (p = needed.start; p < needed.top; p++) {
+    const int * q = lgl->extend.start + lglpeek (&lgl->extseg, 2 * *p);
+    LOGCLS (4, (int *) q, "next sigma clause to consider");
+    satisfied = 0;
+    for (i = 0; !satisfied && (lit = q[i]); i++)
+      if (lglederef (lgl, lit) > 0) {
+	LOG (4, "sigma clause satisfied by %d", lit);
+	satisfied = 1;
+      }
+    if (!satisfied) lgleassign (lgl, q[0]);
+  }
+  lglprt (lgl, 2,
+    "[extend] partial extension of %d variables processed %d of %d clauses",
+    n, lglcntstk (&needed), lglcntstk (&lgl->extseg) / 2);
+  lglrelstk (lgl, &needed);
+  for (p = touched.start; p < touched.top; p++) {
+    eidx = *p;
+    ext = lglelit2ext (lgl, eidx);
+    if (lglpeek (&lgl->extlim, eidx) < 0) ext->extended = 1;
+    else ext->val = 0;
+    lglpoke (&lgl->extlim, eidx, INT_MAX);
+  }
+  lglrelstk (lgl, &touched);
+}
+
+static int lglpartextended (LGL * lgl, int elit) {
+  if (abs (elit) > lgl->maxext) return 1;
+  return lglelit2ext (lgl, elit)->extended;
+}
+
+#ifndef NCHKSOL
+// Partially extend groups of one to four variables in turn, from the
+// largest external index downwards, and compare the values obtained with
+// those of a full extension afterwards.
+
+static void lglchkpartextend (LGL * lgl) {
+  int eidx, vars[4], n, groups, val;
+  signed char * vals;
+  assert (lgl->state & SATISFIED);
+  assert (!(lgl->state & EXTENDED));
+  NEW (vals, lgl->maxext + 1);
+  n = groups = 0;
+  for (eidx = lgl->maxext; eidx >= 1; eidx--) {
+    vars[n++] = eidx;
+    if (eidx > 1 && n < 1 + groups % 4) continue;
+    lglpartextend (lgl, vars, n);
+    while (n > 0) {
+      assert (lglpartextended (lgl, vars[n-1]));
+      vals[vars[n-1]] = lglederef (lgl, vars[n-1]);
+      n--;
+    }
+    groups++;
+  }
+  lglextend (lgl);
+  for (eidx = 1; eidx <= lgl->maxext; eidx++) {
+    val = lglederef (lgl, eidx);
+    if (vals[eidx] == val) continue;
+    lglprt (lgl, 0,
+      "partial extension value %d of %d differs from full extension %d",
+      (int) vals[eidx], eidx, val);
+    assert (vals[eidx] == val);
+    usleep (1000);
+    abort ();	// DITO: not 'lglabort' on purpose !!
+  }
+  DEL (vals, lgl->maxext + 1);
+  lglprt (lgl, 2,
+    "[extend] checked partial extension of %d variables in %d groups",
+    lgl->maxext, groups);
+}
+#endif
+
+void lglextendvars (LGL * lgl, const int * vars, int n) {
+  REQINIT ();
+  ABORTIF (n < 0, "negative number of variables");
+  ABORTIF (n && !vars, "zero variables pointer");
+  REQUIRE (SATISFIED | EXTENDED);
+  if (!(lgl->state & EXTENDED)) lglpartextend (lgl, vars, n);
+  if (lgl->clone) lglextendvars (lgl->clone, vars, n);
+}
+
 void lglsetphases (LGL * lgl) {
   int elit, phase;
   REQINITNOTFORKED ();
-  TRAPI ("setphases");
+  TRAPI (setphases);
   REQUIRE (SATISFIED | EXTENDED);
   if (!(lgl->state & EXTENDED)) lglextend (lgl);
   for (elit = 1; elit <= lgl->maxext; elit++) {
@@ -24505,6 +27988,244 @@ void lglsetphases (LGL * lgl) {
   if (lgl->clone) lglsetphases (lgl->clone);
 }
 
+/*------------------------------------------------------------------------*/
+// Warm start files store the saved phases, the variable order and short
+// learned clauses in terms of external variables such that they can be
+// loaded into a solver for a similar formula.  The format is line based:
+//
+//   p warm <maxvar>
+//   v <var> <phase>		(most active variable first)
+//   l <lit> ... <lit> 0	(learned clause)
+//
+// Comment lines start with 'c'.
+
+#define LGLCMPWARM(A,B) lgldcmp (lgl, *(B), *(A))
+
+static int lglwarmclause (LGL * lgl, const int * c, int * count, FILE * file) {
+  int lit, elit, tmp;
+  const int * p;
+  if (*count >= lgl->opts->warmcls.val) return 0;
+  for (p = c; (lit = *p); p++) {
+    if ((tmp = lglifixed (lgl, lit)) > 0) return 1;
+    if (tmp < 0) continue;
+    if (abs (lglexport (lgl, lit)) > lgl->maxext) return 1;
+  }
+  fputc ('l', file);
+  for (p = c; (lit = *p); p++) {
+    if (lglifixed (lgl, lit)) continue;
+    elit = lglexport (lgl, lit);
+    fprintf (file, " %d", elit);
+  }
+  fputs (" 0\n", file);
+  *count += 1;
+  return 1;
+}
+
+int lglwritewarm (LGL * lgl, FILE * file) {
+  int idx, sign, lit, blit, tag, red, other, glue, count, eidx, c[4];
+  const int maxglue = lgl->opts->warmglue.val;
+  const int * p, * w, * eow, * q;
+  Stk vars;
+  HTS * hts;
+  REQINITNOTFORKED ();
+  ABORTIF (!file, "can not write warm start to zero file");
+  fprintf (file, "c lingeling warm start file\np warm %d\n", lgl->maxext);
+  if (lgl->mt) return !fflush (file);
+  CLR (vars);
+  for (idx = 2; idx < lgl->nvars; idx++) {
+    if (!lglisfree (lgl, idx)) continue;
+    if (lglifixed (lgl, idx)) continue;
+    if (lglexport (lgl, idx) > lgl->maxext) continue;
+    lglpushstk (lgl, &vars, idx);
+  }
+  SORTSTK (int, &vars, LGLCMPWARM);
+  for (p = vars.start; p < vars.top; p++) {
+    idx = *p;
+    eidx = lglexport (lgl, idx);
+    assert (0 < eidx && eidx <= lgl->maxext);
+    fprintf (file, "v %d %d\n", eidx, lglavar (lgl, idx)->phase);
+  }
+  lglrelstk (lgl, &vars);
+  count = 0;
+  // Learned clauses are written if an upper bound on their glue does not
+  // exceed 'warmglue'.  For binary and ternary clauses this is their
+  // size.  Large clauses only keep their scaled glue, which bounds their
+  // original glue by the largest glue mapped to the same stack.
+  for (tag = BINCS; tag <= TRNCS; tag++) {
+    if ((tag == BINCS ? 2 : 3) > maxglue) break;
+    for (idx = 2; idx < lgl->nvars; idx++)
+      for (sign = -1; sign <= 1; sign += 2) {
+	lit = sign * idx;
+	hts = lglhts (lgl, lit);
+	w = lglhts2wchs (lgl, hts);
+	eow = w + hts->count;
+	for (p = w; p < eow; p++) {
+	  blit = *p;
+	  red = blit & REDCS;
+	  if ((blit & MASKCS) == TRNCS || (blit & MASKCS) == LRGCS) p++;
+	  if (!red || (blit & MASKCS) != tag) continue;
+	  other = blit >> RMSHFT;
+	  if (abs (other) < idx) continue;
+	  c[0] = lit, c[1] = other, c[2] = c[3] = 0;
+	  if (tag == TRNCS) {
+	    if (abs (*p) < idx) continue;
+	    c[2] = *p;
+	  }
+	  if (!lglwarmclause (lgl, c, &count, file)) goto DONE;
+	}
+      }
+  }
+  for (glue = 0; glue < MAXGLUE; glue++) {
+    if (lglunscaleglue (lgl, glue + 1) - 1 > maxglue) break;
+    for (q = lgl->red[glue].start; q < lgl->red[glue].top; q = p + 1) {
+      p = q;
+      if (*p >= NOTALIT) continue;
+      if (!lglwarmclause (lgl, q, &count, file)) goto DONE;
+      while (*p) p++;
+    }
+  }
+DONE:
+  lglprt (lgl, 1, "[warm] wrote %d learned clauses", count);
+  return !fflush (file);
+}
+
+static int lglwarmimport (LGL * lgl, int elit) {
+  int erepr, res;
+  Ext * ext;
+  if (!elit || abs (elit) > lgl->maxext) return 0;
+  erepr = lglerepr (lgl, elit);
+  if (abs (erepr) > lgl->maxext) return 0;
+  ext = lglelit2ext (lgl, erepr);
+  if (!ext->imported || lglelitblockingoreliminated (lgl, erepr)) return 0;
+  res = lglimport (lgl, erepr);
+  if (abs (res) <= 1) return res;
+  if (lglifixed (lgl, res)) return lglifixed (lgl, res);
+  if (!lglisfree (lgl, res)) return 0;
+  return res;
+}
+
+static int lglwarmimplied (LGL * lgl) {
+  int lit, val, res = 0;
+  const int * p;
+  assert (!lgl->level);
+  for (p = lgl->clause.start; !res && (lit = *p); p++) {
+    if ((val = lglval (lgl, lit)) > 0) res = 1;
+    else if (!val) {
+      lgliassume (lgl, -lit);
+      if (!lglbcp (lgl)) res = 1;
+    }
+  }
+  if (lgl->level) lglbacktrack (lgl, 0);
+  return res;
+}
+
+static int lglwarmadd (LGL * lgl, const int * c) {
+  int elit, ilit, tmp, res = 0;
+  const int * p;
+  assert (lglmtstk (&lgl->clause));
+  for (p = c; (elit = *p); p++) {
+    if (!(ilit = lglwarmimport (lgl, elit))) break;
+    if (ilit == 1) break;
+    if (ilit == -1) continue;
+    if ((tmp = lglmarked (lgl, ilit)) > 0) continue;
+    if (tmp < 0) break;
+    lglpushstk (lgl, &lgl->clause, ilit);
+    lglmark (lgl, ilit);
+  }
+  for (p = lgl->clause.start; p < lgl->clause.top; p++) lglunmark (lgl, *p);
+  lglpushstk (lgl, &lgl->clause, 0);
+  if (!elit && lglwarmimplied (lgl)) {
+    LOGCLS (2, lgl->clause.start, "adding warm start clause");
+    lgldrupligaddcls (lgl, REDCS);
+    lgladdcls (lgl, REDCS, 0, 0);
+    if (!lgl->mt && !lglbcp (lgl)) lglmt (lgl);
+    res = 1;
+  }
+  lglclnstk (&lgl->clause);
+  return res;
+}
+
+static void lglwarmbump (LGL * lgl, int lit) {
+  lglbumpdlit (lgl, lit);
+  lgl->scinc = lglmulflt (lgl->scinc, lgl->scincf);
+  if (lgl->scinc >= lgl->maxscore) lglrescorevars (lgl);
+}
+
+static int lglwarmint (FILE * file, int * iptr) {
+  int ch, sign = 1, res = 0;
+  while ((ch = getc (file)) == ' ' || ch == '\t')
+    ;
+  if (ch == '-') sign = -1, ch = getc (file);
+  if (!isdigit (ch)) return 0;
+  do {
+    if (res > (INT_MAX - (ch - '0'))/10) return 0;
+    res = 10*res + (ch - '0');
+  } while (isdigit (ch = getc (file)));
+  if (ch != ' ' && ch != '\t' && ch != '\n') return 0;
+  ungetc (ch, file);
+  *iptr = sign * res;
+  return 1;
+}
+
+static void lglwarmload (LGL * lgl, Stk * order, Stk * lits) {
+  int vars, added, ilit;
+  const int * p, * c;
+  lglreset (lgl);
+  if (lgl->level > 0) lglbacktrack (lgl, 0);
+  added = vars = 0;
+  if (!lgl->mt && !lglbcp (lgl)) lglmt (lgl);
+  for (c = lits->start; !lgl->mt && c < lits->top; c = p + 1) {
+    for (p = c; *p; p++)
+      ;
+    added += lglwarmadd (lgl, c);
+  }
+  lglinitscores (lgl);
+  for (p = order->top; !lgl->mt && p > order->start; p -= 2) {
+    ilit = lglwarmimport (lgl, p[-2]);
+    if (abs (ilit) <= 1) continue;
+    if (p[-1]) lglavar (lgl, ilit)->phase = lglsgn (ilit) * p[-1];
+    lglwarmbump (lgl, ilit);
+    vars++;
+  }
+  lglprt (lgl, 1,
+    "[warm] loaded %d variables and %d learned clauses", vars, added);
+  lgluse (lgl);
+}
+
+int lglreadwarm (LGL * lgl, FILE * file) {
+  int ch, lit, phase, lineno, ok;
+  Stk order, lits;
+  REQINITNOTFORKED ();
+  ABORTIF (!file, "can not read warm start from zero file");
+  CLR (order); CLR (lits);
+  ok = lineno = 1;
+  while (ok && (ch = getc (file)) != EOF) {
+    if (ch == 'c' || ch == 'p') {
+      while ((ch = getc (file)) != '\n' && ch != EOF)
+	;
+    } else if (ch == 'v') {
+      ok = lglwarmint (file, &lit) && lit > 0 &&
+           lglwarmint (file, &phase) && abs (phase) <= 1 &&
+	   getc (file) == '\n';
+      if (ok) lglpushstk (lgl, &order, lit), lglpushstk (lgl, &order, phase);
+    } else if (ch == 'l') {
+      do {
+	ok = lglwarmint (file, &lit);
+	if (ok) lglpushstk (lgl, &lits, lit);
+      } while (ok && lit);
+      if (ok) ok = (getc (file) == '\n');
+    } else if (ch != '\n') ok = 0;
+    lineno++;
+  }
+  if (ok) {
+    lglwarmload (lgl, &order, &lits);
+    if (lgl->clone) lglwarmload (lgl->clone, &order, &lits);
+  } else lglwrn (lgl, "invalid warm start file line %d", lineno - 1);
+  lglrelstk (lgl, &order);
+  lglrelstk (lgl, &lits);
+  return ok;
+}
+
 #ifndef NCHKSOL
 #include <signal.h>
 #include <unistd.h>
@@ -24583,7 +28304,7 @@ static void lglnegass (LGL * lgl) {
   const int  * p;
   Stk eassume;
   REQINITNOTFORKED ();
-  TRAPI ("negass");
+  TRAPI (negass);
   if (lgl->mt) return;
   CLR (eassume);
   for (p = lgl->eassume.start; p < lgl->eassume.top; p++)
@@ -24633,8 +28354,11 @@ static int lglisat (LGL * lgl, Lim * lim, int simpits) {
     lglrep (lgl, 1, '0');
   }
   if (reported != lgl->stats->reported) lglflshrep (lgl);
-  if (res == 10) lglextend (lgl);
+  if (res == 10 && !lgl->opts->lazyext.val) lglextend (lgl);
 #ifndef NCHKSOL
+  if (res == 10 && !(lgl->state & EXTENDED) && lgl->opts->lazyextchk.val)
+    lglchkpartextend (lgl);
+  if (res == 10 && !(lgl->state & EXTENDED)) lglextend (lgl);
   if (res == 10) lglchksol (lgl);
 #endif
   return res;
@@ -24712,7 +28436,7 @@ do { \
 
 #define RETURN(FUN,RES) \
 do { \
-  TRAPI ("return %d", (RES)); \
+  TRAPI (return, (RES)); \
   CHKCLONERES (FUN, (RES)); \
 } while (0)
 
@@ -24729,7 +28453,7 @@ do { \
 
 #define RETURNARG(FUN,ARG,RES) \
 do { \
-  TRAPI ("return %d", (RES)); \
+  TRAPI (return, (RES)); \
   CHKCLONEARGRES (FUN, (ARG), (RES)); \
 } while (0)
 
@@ -24782,7 +28506,7 @@ int lglsat (LGL * lgl) {
   int res;
   Lim lim;
   REQINITNOTFORKED ();
-  TRAPI ("sat");
+  TRAPI (sat);
   lglstart (lgl, &lgl->times->all);
   lgl->stats->calls.sat++;
   ABORTIF (!lglmtstk (&lgl->clause), "clause terminating zero missing");
@@ -24797,7 +28521,7 @@ int lglsat (LGL * lgl) {
 int lglookahead (LGL * lgl) {
   int ilit, res;
   REQINITNOTFORKED ();
-  TRAPI ("lkhd");
+  TRAPI (lkhd);
   ABORTIF (!lglmtstk (&lgl->eassume), "imcompatible with 'lglassume'");
   ABORTIF (!lglmtstk (&lgl->clause), "clause terminating zero missing");
   ABORTIF (lgl->opts->druplig.val && lgl->opts->lkhd.val == 2,
@@ -24831,7 +28555,8 @@ int lglookahead (LGL * lgl) {
 	ilit = lglrelevancelook (lgl);
 	break;
     }
-    res = (!lgl->mt && ilit) ? lglexport (lgl, ilit) : 0;
+    res = (!lgl->mt && ilit && !lglisdef (lgl, ilit)) ?
+            lglexport (lgl, ilit) : 0;
     assert (!res || !lglelit2ext (lgl, res)->melted);
   } else lglmt (lgl), res = 0;
   assert (lgl->lkhd);
@@ -24846,8 +28571,9 @@ int lglookahead (LGL * lgl) {
 int lglchanged (LGL * lgl) {
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("changed");
-  REQUIRE (EXTENDED);
+  TRAPI (changed);
+  REQUIRE (SATISFIED | EXTENDED);
+  if (!(lgl->state & EXTENDED)) lglextend (lgl);
   res = lgl->changed;
   RETURN (lglchanged, res);
   return res;
@@ -24857,7 +28583,7 @@ int lglsimp (LGL * lgl, int iterations) {
   Lim lim;
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("simp %d", iterations);
+  TRAPI (simp, iterations);
   ABORTIF (iterations < 0, "negative number of simplification iterations");
   ABORTIF (!lglmtstk (&lgl->clause), "clause terminating zero missing");
   lglstart (lgl, &lgl->times->all);
@@ -24875,7 +28601,7 @@ int lglsimp (LGL * lgl, int iterations) {
 int lglmaxvar (LGL * lgl) {
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("maxvar");
+  TRAPI (maxvar);
   res = lgl->maxext;
   RETURN (lglmaxvar, res);
   return res;
@@ -24884,7 +28610,7 @@ int lglmaxvar (LGL * lgl) {
 int lglincvar (LGL  *lgl) {
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("incvar");
+  TRAPI (incvar);
   res = lgl->maxext + 1;
   (void) lglimport (lgl, res);
   RETURN (lglincvar, res);
@@ -24894,12 +28620,16 @@ int lglincvar (LGL  *lgl) {
 int lglderef (LGL * lgl, int elit) {
   int res;
   REQINIT ();
-  TRAPI ("deref %d", elit);
+  TRAPI (deref, elit);
   lgl->stats->calls.deref++;
   ABORTIF (!elit, "can not deref zero literal");
   REQUIRE (SATISFIED | EXTENDED);
-  if (!(lgl->state & EXTENDED)) lglextend (lgl);
-  res = lglederef (lgl, elit);
+  if (abs (elit) > lgl->maxext) res = -1;
+  else {
+    if (!(lgl->state & EXTENDED) && !lglpartextended (lgl, elit))
+      lglextend (lgl);
+    res = lglederef (lgl, elit);
+  }
   RETURNARG (lglderef, elit, res);
   return res;
 }
@@ -24909,7 +28639,7 @@ int lglfailed (LGL * lgl, int elit) {
   Ext * ext;
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("failed %d", elit);
+  TRAPI (failed, elit);
   lgl->stats->calls.failed++;
   ABORTIF (!elit, "can not check zero failed literal");
   REQUIRE (UNSATISFIED | FAILED);
@@ -24929,9 +28659,99 @@ int lglfailed (LGL * lgl, int elit) {
   return res;
 }
 
+int lglgetmodel (LGL * lgl, signed char * buf, int maxvar) {
+  int idx, ilit, val, max;
+  signed char * other;
+  Ext * ext;
+  REQINIT ();
+  ABORTIF (maxvar < 0, "negative maximum variable");
+  ABORTIF (maxvar && !buf, "zero model buffer");
+  REQUIRE (SATISFIED | EXTENDED);
+  if (!(lgl->state & EXTENDED)) lglextend (lgl);
+  lgl->stats->calls.deref += maxvar;
+  max = maxvar < lgl->maxext ? maxvar : lgl->maxext;
+  if (buf) buf[0] = 0;
+  for (idx = 1; idx <= max; idx++) {
+    ext = lgl->ext + idx;
+    if (!(val = ext->val)) {
+      assert (!ext->equiv);
+      ilit = ext->repr;
+      val = ilit ? lglcval (lgl, ilit) : -1;
+    }
+    buf[idx] = val;
+  }
+  while (idx <= maxvar) buf[idx++] = -1;
+  if (lgl->apitrace)
+    for (idx = 1; idx <= maxvar; idx++) {
+      TRAPI (deref, idx);
+      TRAPI (return, buf[idx]);
+    }
+  if (lgl->clone) {
+    NEW (other, maxvar + 1);
+    lglgetmodel (lgl->clone, other, maxvar);
+    for (idx = 1; idx <= maxvar; idx++)
+      ABORTIF (other[idx] != buf[idx],
+	"lglgetmodel (lgl->clone, ...) differs from lglgetmodel (lgl, ...) "
+	"for variable %d", idx);
+    DEL (other, maxvar + 1);
+  }
+  return lgl->maxext;
+}
+
+int lglgetfailed (LGL * lgl, int * buf, int size) {
+  int elit, res, i, * other;
+  const int * p;
+  unsigned bit;
+  Ext * ext;
+  REQINITNOTFORKED ();
+  ABORTIF (size < 0, "negative failed buffer size");
+  ABORTIF (size && !buf, "zero failed buffer");
+  REQUIRE (UNSATISFIED | FAILED);
+  if (!(lgl->state & FAILED)) {
+    lglstart (lgl, &lgl->times->all);
+    lglanafailed (lgl);
+    lglstop (lgl);
+  }
+  lgl->stats->calls.failed += lglcntstk (&lgl->eassume);
+  res = 0;
+  for (p = lgl->eassume.start; p < lgl->eassume.top; p++) {
+    elit = *p;
+    ext = lglelit2ext (lgl, elit);
+    bit = 1u << (elit < 0);
+    if (!(ext->failed & bit)) continue;
+    if (!(ext->assumed & bit)) continue;	// reported (mark)
+    ext->assumed &= ~bit;
+    if (res < size) buf[res] = elit;
+    res++;
+  }
+  for (p = lgl->eassume.start; p < lgl->eassume.top; p++) {
+    elit = *p;
+    lglelit2ext (lgl, elit)->assumed |= 1u << (elit < 0);
+  }
+  if (lgl->apitrace)
+    for (p = lgl->eassume.start; p < lgl->eassume.top; p++) {
+      elit = *p;
+      ext = lglelit2ext (lgl, elit);
+      bit = 1u << (elit < 0);
+      TRAPI (failed, elit);
+      TRAPI (return, (ext->failed & bit) != 0);
+    }
+  if (lgl->clone) {
+    NEW (other, lglmax (res, 1));
+    ABORTIF (lglgetfailed (lgl->clone, other, res) != res,
+      "lglgetfailed (lgl->clone, ...) differs from lglgetfailed (lgl, ...)");
+    for (i = 0; i < res && i < size; i++)
+      ABORTIF (other[i] != buf[i],
+	"lglgetfailed (lgl->clone, ...) differs from lglgetfailed (lgl, ...) "
+	"at position %d", i);
+    DEL (other, lglmax (res, 1));
+  }
+  return res;
+}
+
 int lglinconsistent (LGL * lgl) {
   int res;
-  TRAPI ("inconsistent");
+  TRAPI (inconsistent);
   res = (lgl->mt != 0);
   RETURN (lglinconsistent, res);
   return res;
@@ -24951,7 +28771,7 @@ static int lglefixed (LGL * lgl, int elit) {
 int lglfixed (LGL * lgl, int elit) {
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("fixed %d", elit);
+  TRAPI (fixed, elit);
   lgl->stats->calls.fixed++;
   ABORTIF (!elit, "can not deref zero literal");
   res = lglefixed (lgl, elit);
@@ -24962,10 +28782,10 @@ int lglfixed (LGL * lgl, int elit) {
 int lglrepr (LGL * lgl, int elit) {
   int res, eidx = abs (elit);
   REQINITNOTFORKED ();
-  TRAPI ("repr %d", elit);
+  TRAPI (repr, elit);
   lgl->stats->calls.repr++;
   if (eidx > lgl->maxext) res = elit;
-  else res = lglerepr (lgl, elit);
+  else if (abs (res = lglerepr (lgl, elit)) > lgl->maxext) res = elit;
   RETURNARG (lglrepr, elit, res);
   return res;
 }
@@ -24973,7 +28793,7 @@ int lglrepr (LGL * lgl, int elit) {
 void lglfreeze (LGL * lgl, int elit) {
   Ext * ext;
   REQINITNOTFORKED ();
-  TRAPI ("freeze %d", elit);
+  TRAPI (freeze, elit);
   lgl->stats->calls.freeze++;
   ABORTIF (!elit, "can not freeze zero literal");
   REQUIRE (UNUSED|OPTSET|USED|RESET|SATISFIED|UNSATISFIED|FAILED|LOOKED|
@@ -24996,7 +28816,7 @@ int lglfrozen (LGL * lgl, int elit) {
   Ext * ext;
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("frozen %d", elit);
+  TRAPI (frozen, elit);
   ABORTIF (!elit, "can not check zero literal for being frozen");
   if (abs (elit) > lgl->maxext) res = INT_MAX;
   else if (!(ext = lglelit2ext (lgl, elit))->imported) res = INT_MAX;
@@ -25009,7 +28829,7 @@ int lglusable (LGL * lgl, int elit) {
   Ext * ext;
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("usable %d", elit);
+  TRAPI (usable, elit);
   ABORTIF (!elit, "can not check zero literal for being usable");
   if (abs (elit) > lgl->maxext) res = 1;
   else if (!(ext = lglelit2ext (lgl, elit))->imported) res = 1;
@@ -25034,7 +28854,7 @@ static int lglereusable (LGL * lgl, int elit) {
 int lglreusable (LGL * lgl, int elit) {
   int res;
   REQINITNOTFORKED ();
-  TRAPI ("reusable %d", elit);
+  TRAPI (reusable, elit);
   ABORTIF (!elit, "can not check zero literal for being reusable");
   res = lglereusable (lgl, elit);
   RETURNARG (lglreusable, elit, res);
@@ -25044,7 +28864,7 @@ int lglreusable (LGL * lgl, int elit) {
 void lglreuse (LGL * lgl, int elit) {
   Ext * ext;
   REQINITNOTFORKED ();
-  TRAPI ("reuse %d", elit);
+  TRAPI (reuse, elit);
   ABORTIF (!elit, "can not reuse zero literal");
   ABORTIF (!lglereusable (lgl, elit), "can not reuse non-reusable literal");
   if (abs (elit) <= lgl->maxext) {
@@ -25068,7 +28888,7 @@ void lglmeltall (LGL * lgl) {
   int idx, melted;
   Ext * ext;
   REQINITNOTFORKED ();
-  TRAPI ("meltall");
+  TRAPI (meltall);
   melted = 0;
   for (idx = 1; idx <= lgl->maxext; idx++) {
     ext = lglelit2ext (lgl, idx);
@@ -25086,7 +28906,7 @@ void lglmeltall (LGL * lgl) {
 void lglmelt (LGL * lgl, int elit) {
   Ext * ext;
   REQINITNOTFORKED ();
-  TRAPI ("melt %d", elit);
+  TRAPI (melt, elit);
   lgl->stats->calls.melt++;
   ABORTIF (!elit, "can not melt zero literal");
   REQUIRE (UNUSED|OPTSET|USED|RESET|
@@ -25104,7 +28924,7 @@ void lglmelt (LGL * lgl, int elit) {
 
 void lglreconstk (LGL * lgl, int ** startptr, int ** toptr) {
   REQINITNOTFORKED ();
-  TRAPI ("reconstk");
+  TRAPI (reconstk);
   lglfitstk (lgl, &lgl->extend);	// 'lglcompact' -> 'lglclone'!!
   if (startptr) *startptr = lgl->extend.start;
   if (toptr) *toptr = lgl->extend.top;
@@ -25272,6 +29092,7 @@ static void lglprofsort (LGL * lgl) {
   INSTN (analysis, analysis);
   INSTN (backward, backward);
   INSTN (bca, bca);
+  INSTN (bva, bva);
   INSTN (block, block);
   INSTN (bump, bump);
   INSTN (card, card);
@@ -25300,6 +29121,7 @@ static void lglprofsort (LGL * lgl) {
   INSTN (showfeatures, showfeatures);
   INSTN (showscoredist, showscoredist);
   INSTN (subl, subl);
+  INSTN (subsume, subsume);
   INSTN (sweep, sweep);
   INSTN (ternres, ternres);
   INSTN (transred, transred);
@@ -25388,6 +29210,217 @@ SHORT:
   lglprs (lgl, "%8.3f %3.0f%% all", t, 100.0);
 }
 
+typedef struct PN { int64_t cycles; int idx; const char * n; } PN;
+
+static int lglcmppn (const PN * a, const PN * b) {
+  if (a->cycles > b->cycles) return -1;
+  if (a->cycles < b->cycles) return 1;
+  return strcmp (a->n, b->n);
+}
+
+#define INSPN(NAME,FIELD) \
+do { \
+  PN * pn; \
+  if (lglignprofptr (lgl, &ts->FIELD)) break; \
+  pn = pns + npns++; \
+  ASSERT (npns <= szpns); \
+  pn->idx = lglprofidx (lgl, &ts->FIELD); \
+  pn->cycles = lgl->perf->ctrs[pn->idx][PERFCYCLES]; \
+  pn->n = # NAME; \
+  if (!pn->cycles) npns--; \
+} while (0)
+
+static void lglperfmisses (LGL * lgl, const char * name,
+                           int64_t * ctrs, int64_t props) {
+  lglprs (lgl,
+    "%.2f cache misses, %.2f branch misses per %s propagation",
+    lglavg (ctrs[PERFCACHE], props),
+    lglavg (ctrs[PERFBRANCH], props), name);
+}
+
+static void lglmemstats (LGL * lgl) {
+  MemCnt * mem = lgl->stats->mem;
+  int cat;
+  for (cat = 0; cat < NMEMCATS; cat++) {
+    if (!mem[cat].max) continue;
+    lglprs (lgl,
+      "mem: %-11s %9.1f MB %3.0f%% current, %9.1f MB %3.0f%% max",
+      memcatnames[cat],
+      mem[cat].current / (double)(1<<20),
+      lglpcnt (mem[cat].current, lgl->stats->bytes.current),
+      mem[cat].max / (double)(1<<20),
+      lglpcnt (mem[cat].max, lgl->stats->bytes.max));
+  }
+}
+
+static void lglperfstats (LGL * lgl) {
+  int64_t * c, search[NPERF], simp[NPERF], all;
+  Times * ts = lgl->times;
+  const int szpns = 100;
+  PN pns[szpns];
+  int i, npns;
+
+  if (!lgl->perf || !lgl->perf->nslots) return;
+  all = lgl->perf->ctrs[0][PERFCYCLES];
+  if (!all) return;
+
+  npns = 0;
+
+  INSPN (all, all);
+  INSPN (search, search);
+  INSPN (preprocessing, preprocessing);
+  INSPN (inprocessing, inprocessing);
+  INSPN (lookahead, lookahead);
+  INSPN (analysis, analysis);
+  INSPN (backward, backward);
+  INSPN (bca, bca);
+  INSPN (bva, bva);
+  INSPN (block, block);
+  INSPN (bump, bump);
+  INSPN (card, card);
+  INSPN (cce, cce);
+  INSPN (decide, decide);
+  INSPN (decompose, decompose);
+  INSPN (defrag, defrag);
+  INSPN (druplig, druplig);
+  INSPN (elim, elim);
+  INSPN (gauss, gauss);
+  INSPN (gc, gc);
+  INSPN (heapdecision, heapdecision);
+  INSPN (locs, locs);
+  INSPN (mincls, mincls);
+  INSPN (phase, phase);
+  INSPN (probe, probe);
+  INSPN (probe-simple, prb.simple);
+  INSPN (probe-basic, prb.basic);
+  INSPN (probe-treelook, prb.treelook);
+  INSPN (prune, prune);
+  INSPN (quatres1, quatres1);
+  INSPN (quatres2, quatres2);
+  INSPN (quatres, quatres);
+  INSPN (queuedecision, queuedecision);
+  INSPN (queuesort, queuesort);
+  INSPN (redcls, redcls);
+  INSPN (reduce, reduce);
+  INSPN (restart, restart);
+  INSPN (showfeatures, showfeatures);
+  INSPN (showscoredist, showscoredist);
+  INSPN (subl, subl);
+  INSPN (subsume, subsume);
+  INSPN (sweep, sweep);
+  INSPN (ternres, ternres);
+  INSPN (transred, transred);
+  INSPN (unhide, unhide);
+
+  ISORT (PN, lglcmppn, pns, npns);
+
+  lglprs (lgl, "%-16s %10s %4s %5s %8s %8s",
+    "perf", "Mcycles", "", "IPC", "cache", "branch");
+  for (i = 0; i < npns; i++) {
+    c = lgl->perf->ctrs[pns[i].idx];
+    lglprs (lgl, "%-16s %10.1f %3.0f%% %5.2f %8.2f %8.2f",
+      pns[i].n, c[PERFCYCLES] / 1e6,
+      lglpcnt (c[PERFCYCLES], all),
+      lglavg (c[PERFINSTRS], c[PERFCYCLES]),
+      lglavg (1e3 * c[PERFCACHE], c[PERFINSTRS]),
+      lglavg (1e3 * c[PERFBRANCH], c[PERFINSTRS]));
+  }
+  lglprs (lgl, "(cache and branch misses per thousand instructions)");
+
+  for (i = 0; i < NPERF; i++) {
+    search[i] = lgl->perf->ctrs[lglprofidx (lgl, &ts->search)][i];
+    search[i] -= lgl->perf->ctrs[lglprofidx (lgl, &ts->inprocessing)][i];
+    simp[i] = lgl->perf->ctrs[lglprofidx (lgl, &ts->preprocessing)][i];
+    simp[i] += lgl->perf->ctrs[lglprofidx (lgl, &ts->inprocessing)][i];
+  }
+  lglperfmisses (lgl, "search", search, lgl->stats->props.search);
+  lglperfmisses (lgl, "simplification", simp, lgl->stats->props.simp);
+}
+
+#ifdef LGLSHAPE
+static void lglshaperange (char * buf, int bucket) {
+  if (!bucket) sprintf (buf, "0");
+  else if (bucket == 1) sprintf (buf, "1");
+  else if (bucket + 1 == SHAPEBUCKETS) sprintf (buf, "%d+", 1<<(bucket-1));
+  else sprintf (buf, "%d-%d", 1<<(bucket-1), (1<<bucket) - 1);
+}
+
+static void lglshapestats (LGL * lgl) {
+  int64_t lits[SHAPEBUCKETS], props, visits, blocked, sizes[SHAPEBUCKETS];
+  int idx, sign, bucket, maxbucket, glue, size;
+  Shape * s = &lgl->stats->shape;
+  const int * c, * p;
+  char range[32];
+  Stk * lir;
+  memset (lits, 0, sizeof lits);
+  for (idx = 2; idx < lgl->nvars; idx++)
+    for (sign = -1; sign <= 1; sign += 2)
+      lits[lglshapebucket (lglhts (lgl, sign*idx)->count)]++;
+  props = visits = 0;
+  for (bucket = 0; bucket < SHAPEBUCKETS; bucket++) {
+    props += s->wchs[bucket].props;
+    visits += s->wchs[bucket].visits;
+  }
+  lglprs (lgl, "shape watches %10s %4s %12s %4s %12s %4s %8s",
+    "lits", "", "props", "", "visits", "", "per prop");
+  lglprsline (lgl);
+  for (bucket = 0; bucket < SHAPEBUCKETS; bucket++) {
+    if (!lits[bucket] && !s->wchs[bucket].props) continue;
+    lglshaperange (range, bucket);
+    lglprs (lgl, "%-13s %10lld %3.0f%% %12lld %3.0f%% %12lld %3.0f%% %8.1f",
+      range,
+      (LGLL) lits[bucket], lglpcnt (lits[bucket], 2*(lgl->nvars - 2)),
+      (LGLL) s->wchs[bucket].props, lglpcnt (s->wchs[bucket].props, props),
+      (LGLL) s->wchs[bucket].visits,
+      lglpcnt (s->wchs[bucket].visits, visits),
+      lglavg (s->wchs[bucket].visits, s->wchs[bucket].props));
+  }
+  lglprsline (lgl);
+  blocked = s->blocked.blit[BINCS] + s->blocked.blit[TRNCS];
+  blocked += s->blocked.blit[LRGCS] + s->blocked.updated;
+  lglprs (lgl,
+    "shape blocked %lld = %.0f%% of %lld visits",
+    (LGLL) blocked, lglpcnt (blocked, visits), (LGLL) visits);
+  lglprs (lgl,
+    "shape blocked %lld bin %.0f%%, %lld trn %.0f%%, "
+    "%lld lrg %.0f%%, %lld updated %.0f%%",
+    (LGLL) s->blocked.blit[BINCS],
+    lglpcnt (s->blocked.blit[BINCS], blocked),
+    (LGLL) s->blocked.blit[TRNCS],
+    lglpcnt (s->blocked.blit[TRNCS], blocked),
+    (LGLL) s->blocked.blit[LRGCS],
+    lglpcnt (s->blocked.blit[LRGCS], blocked),
+    (LGLL) s->blocked.updated,
+    lglpcnt (s->blocked.updated, blocked));
+  lglprsline (lgl);
+  lglprs (lgl, "shape learned size per glue tier");
+  lglprsline (lgl);
+  for (glue = 0; glue <= MAXGLUE; glue++) {
+    lir = lgl->red + glue;
+    memset (sizes, 0, sizeof sizes);
+    maxbucket = 0;
+    for (c = lir->start; c < lir->top; c = p + 1) {
+      p = c;
+      if (*p >= NOTALIT) continue;
+      while (*p) p++;
+      size = p - c;
+      bucket = lglshapebucket (size);
+      if (bucket > maxbucket) maxbucket = bucket;
+      sizes[bucket]++;
+    }
+    if (!maxbucket) continue;
+    for (bucket = 0; bucket <= maxbucket; bucket++) {
+      if (!sizes[bucket]) continue;
+      lglshaperange (range, bucket);
+      lglprs (lgl, "%2d %-10s %10lld %3.0f%%",
+        glue, range, (LGLL) sizes[bucket],
+	lglpcnt (sizes[bucket], lgl->stats->lir[glue].clauses));
+    }
+  }
+  lglprsline (lgl);
+}
+#endif
+
 void lglstats (LGL * lgl) {
   long long visits, min, p, steps, sum;
   int remaining, removed;
@@ -25414,6 +29447,10 @@ void lglstats (LGL * lgl) {
   lglprs (lgl,
     "bcas: %d count, %lld added (%lld skipped), %lld steps",
     s->bca.count, (LGLL) s->bca.added, s->bca.skipped, (LGLL) s->bca.steps);
+  lglprs (lgl,
+    "bvas: %d count, %lld vars, %lld removed, %lld added, %lld steps",
+    s->bva.count, (LGLL) s->bva.vars, (LGLL) s->bva.removed,
+    (LGLL) s->bva.added, (LGLL) s->bva.steps);
 
   lglprs (lgl,
     "bkwd: tried %lld clauses, %lld lits, %.2f lits/clause",
@@ -25542,6 +29579,15 @@ void lglstats (LGL * lgl) {
       lglpcnt (s->elm.small.tried - s->elm.small.failed, s->elm.small.tried),
     s->elm.small.failed,
       lglpcnt (s->elm.small.failed, s->elm.small.tried));
+  lglprs (lgl,
+    "elms: %d equiv, %d and, %d ite, %d xor gates",
+    s->elm.gates.equiv, s->elm.gates.and,
+    s->elm.gates.ite, s->elm.gates.xor);
+  lglprs (lgl,
+    "elms: %lld parallel batches, %lld candidates, %lld passed %.0f%%",
+    (LGLL) s->elm.par.batches, (LGLL) s->elm.par.cands,
+    (LGLL) s->elm.par.passed,
+      lglpcnt (s->elm.par.passed, s->elm.par.cands));
   lglprs (lgl,
     "elms: %d subsumed, %d strengthened, %d blocked",
     s->elm.sub, s->elm.str, s->elm.blkd);
@@ -25840,6 +29886,14 @@ void lglstats (LGL * lgl) {
     s->subl.count, s->subl.tried, lglavg (s->subl.tried, s->subl.count),
     s->subl.sub, s->subl.cands, lglpcnt (s->subl.sub, s->subl.cands));
 
+  lglprs (lgl,
+    "subs: %d subsumption rounds, %lld clauses checked, %lld steps",
+    s->subs.count, (LGLL) s->subs.clauses, (LGLL) s->subs.steps);
+  lglprs (lgl,
+    "subs: %lld subsumed, %lld strengthened, %lld learned",
+    (LGLL) s->subs.subsumed, (LGLL) s->subs.strengthened,
+    (LGLL) s->subs.red);
+
   lglprs (lgl,
     "swps: %d count, %lld rounds, %lld queries (%.1f/round)",
     s->sweep.count, (LGLL) s->sweep.rounds, (LGLL) s->sweep.queries.total,
@@ -25859,6 +29913,10 @@ void lglstats (LGL * lgl) {
   lglprs (lgl,
     "swps: %d failed, %d impls, %d equivs",
     s->sweep.failed, s->sweep.impls, s->sweep.equivs);
+  lglprs (lgl,
+    "swps: %lld simulations, %lld gates, %lld classes, %lld vars refined",
+    (LGLL) s->sweep.sim.count, (LGLL) s->sweep.sim.gates,
+    (LGLL) s->sweep.sim.classes, (LGLL) s->sweep.sim.refined);
 
   lglprs (lgl,
     "swp0: %lld type 0 queries, %lld unsat (%.1f%%), %lld sat (%.1f%%)",
@@ -25972,12 +30030,13 @@ void lglstats (LGL * lgl) {
     s->unhd.str.red, lglpcnt (s->unhd.str.red, sum));
 
   removed = s->fixed.sum + s->elm.elmd + s->equiv.sum;
-  remaining = lgl->maxext - removed;
+  remaining = lgl->maxext + lgl->ndefs - removed;
   assert (remaining >= 0);
   lglprs (lgl,
     "vars: %d remaining %.0f%% and %d removed %.0f%% out of %d",
-    remaining, lglpcnt (remaining, lgl->maxext),
-    removed, lglpcnt (removed, lgl->maxext), lgl->maxext);
+    remaining, lglpcnt (remaining, lgl->maxext + lgl->ndefs),
+    removed, lglpcnt (removed, lgl->maxext + lgl->ndefs),
+    lgl->maxext + lgl->ndefs);
   lglprs (lgl,
     "vars: %d fixed %.0f%%, %d eliminated %.0f%%, %d equivalent %.0f%%",
     s->fixed.sum, lglpcnt (s->fixed.sum, lgl->maxext),
@@ -26001,6 +30060,9 @@ void lglstats (LGL * lgl) {
   lglprsline (lgl);
   lglgluestats (lgl);
   lglprsline (lgl);
+#ifdef LGLSHAPE
+  lglshapestats (lgl);
+#endif
 
 #ifndef NLGLDRUPLIG
   if (lgl->druplig) {
@@ -26012,6 +30074,12 @@ void lglstats (LGL * lgl) {
 SHORT:
   lglprof (lgl);
   lglprsline (lgl);
+  if (lgl->perf && lgl->perf->nslots) {
+    lglperfstats (lgl);
+    lglprsline (lgl);
+  }
+  lglmemstats (lgl);
+  lglprsline (lgl);
   lglprs (lgl,
     "%13lld conflicts,    %10.1f confs/sec",
     (LGLL) s->confs, lglavg (s->confs, t));
@@ -26045,6 +30113,672 @@ SHORT:
   fflush (lgl->out);
 }
 
+/*------------------------------------------------------------------------*/
+// Machine readable statistics.  Every counter in 'Stats', 'Times' and
+// 'Limits' is traversed with a dotted name prefixed by its section.
+// Fixed-point moving averages are converted to floating point.  Checking
+// builds mark the traversed bytes of 'Stats' and assert that only gaps
+// which can be padding are left, which catches counters added to 'Stats'
+// (and reported by 'lglstats') but forgotten here.
+
+#ifndef NDEBUG
+#define STATCOVER(FIELD) \
+  memset (covered + ((char*) &s->FIELD - (char*) s), 1, sizeof s->FIELD)
+#else
+#define STATCOVER(FIELD) do { } while (0)
+#endif
+
+#define STAT(FIELD) \
+do { \
+  STATCOVER (FIELD); \
+  trav (state, "stats." # FIELD, (double) s->FIELD); \
+} while (0)
+#define STATF(NAME,FIELD) \
+do { \
+  STATCOVER (FIELD); \
+  trav (state, "stats." # NAME, s->FIELD / (double)(1ll<<32)); \
+} while (0)
+#define TIME(FIELD) trav (state, "times." # FIELD, ts->FIELD)
+#define LIMIT(FIELD) trav (state, "limits." # FIELD, (double) l->FIELD)
+
+void lglstrav (LGL * lgl, void * state,
+               void (*trav)(void *, const char *, double)) {
+  Stats * s = lgl->stats;
+  Limits * l = lgl->limits;
+  Times * ts = lgl->times;
+  char name[40];
+  int cat, glue;
+#ifndef NDEBUG
+  char covered[sizeof *s];
+  size_t i, gap;
+  memset (covered, 0, sizeof covered);
+#endif
+  REQINIT ();
+  lglflushtimers (lgl);
+  trav (state, "solver.id", lgl->tid);
+  trav (state, "solver.seconds", ts->all);
+  trav (state, "solver.mb", lglmb (lgl));
+  trav (state, "solver.maxmb", lglmaxmb (lgl));
+  trav (state, "solver.vars", lglnvars (lgl));
+  trav (state, "solver.clauses", lglnclauses (lgl));
+  for (cat = 0; cat < NMEMCATS; cat++) {
+    sprintf (name, "memory.%s.current", memcatnames[cat]);
+    trav (state, name, (double) s->mem[cat].current);
+    sprintf (name, "memory.%s.max", memcatnames[cat]);
+    trav (state, name, (double) s->mem[cat].max);
+  }
+  STATCOVER (mem);
+  STAT (agility);
+  STAT (steps);
+  STAT (trims);
+  STAT (bins);
+  STAT (trns);
+  STAT (times);
+  STAT (defrags);
+  STAT (reported);
+  STAT (features);
+  STAT (repcntdown);
+  STAT (gcs);
+  STAT (decomps);
+  STAT (rescored.clauses);
+  STAT (rescored.vars);
+  STAT (restarts.count);
+  STAT (restarts.checked);
+  STAT (restarts.skipped);
+  STAT (restarts.forced);
+  STAT (restarts.agile);
+  STAT (restarts.delayed);
+  STAT (restarts.blocked);
+  STAT (restarts.notforced);
+  STAT (restarts.reused);
+  STAT (restarts.delta.count);
+  STAT (restarts.delta.pen);
+  STAT (restarts.delta.delta);
+  STAT (restarts.kept.count);
+  STAT (restarts.kept.sum);
+  STAT (reduced.count);
+  STAT (reduced.arith);
+  STAT (reduced.memlim);
+  STAT (reduced.reset);
+  STAT (reduced.collected);
+  STAT (reduced.retired);
+  STAT (prune.decs);
+  STAT (prune.pure);
+  STAT (prune.calls);
+  STAT (prune.sat);
+  STAT (prune.uns);
+  STAT (prune.lim);
+  STAT (prune.levels);
+  STAT (prune.child.confs);
+  STAT (prune.child.decs);
+  STAT (prune.child.props);
+  STAT (prgss);
+  STAT (irrprgss);
+  STAT (enlwchs);
+  STAT (pshwchs);
+  STAT (dense);
+  STAT (sparse);
+  STAT (confs);
+  STAT (decisions);
+  STAT (hdecs);
+  STAT (qdecs);
+  STAT (randecs);
+  STAT (randphases);
+  STAT (uips);
+  STAT (decflipped);
+  STATF (glue.fast, glue.fast.val);
+  STATF (glue.slow, glue.slow.val);
+  STATF (jlevel.fast, jlevel.fast.val);
+  STATF (jlevel.slow, jlevel.slow.val);
+  STATF (tlevel, tlevel.val);
+  STATF (avglue, avglue.val);
+  STATF (its.avg.fast, its.avg.fast.val);
+  STATF (its.avg.slow, its.avg.slow.val);
+  STAT (its.count);
+  STAT (irr.clauses.cur);
+  STAT (irr.clauses.max);
+  STAT (irr.clauses.add);
+  STAT (irr.lits.cur);
+  STAT (irr.lits.max);
+  STAT (irr.lits.add);
+  STAT (irr.maxbytes);
+  STAT (calls.sat);
+  STAT (calls.mosat);
+  STAT (calls.simp);
+  STAT (calls.deref);
+  STAT (calls.fixed);
+  STAT (calls.freeze);
+  STAT (calls.lkhd);
+  STAT (calls.melt);
+  STAT (calls.add);
+  STAT (calls.assume);
+  STAT (calls.cassume);
+  STAT (calls.failed);
+  STAT (calls.repr);
+  STAT (props.search);
+  STAT (props.simp);
+  STAT (props.lkhd);
+  STAT (visits.search);
+  STAT (visits.simp);
+  STAT (visits.lkhd);
+  STAT (bytes.current);
+  STAT (bytes.max);
+  STAT (red.bin);
+  STAT (red.trn);
+  STAT (red.lrg);
+  STAT (hbr.cnt);
+  STAT (hbr.simple);
+  STAT (hbr.trn);
+  STAT (hbr.lrg);
+  STAT (hbr.sub);
+  STAT (fixed.current);
+  STAT (fixed.sum);
+  STAT (equiv.current);
+  STAT (equiv.sum);
+  STAT (ternres.count);
+  STAT (ternres.bin);
+  STAT (ternres.trn);
+  STAT (ternres.steps);
+  STAT (blk.count);
+  STAT (blk.clauses);
+  STAT (blk.lits);
+  STAT (blk.pure);
+  STAT (blk.res);
+  STAT (blk.steps);
+  STAT (prb.simple.count);
+  STAT (prb.simple.failed);
+  STAT (prb.simple.eqs);
+  STAT (prb.simple.probed);
+  STAT (prb.simple.steps);
+  STAT (prb.basic.count);
+  STAT (prb.basic.failed);
+  STAT (prb.basic.lifted);
+  STAT (prb.basic.probed);
+  STAT (prb.basic.steps);
+  STAT (prb.basic.lastate);
+  STAT (prb.basic.ate.trnr);
+  STAT (prb.basic.ate.lrg);
+  STAT (prb.basic.ate.count);
+  STAT (prb.treelook.count);
+  STAT (prb.treelook.failed);
+  STAT (prb.treelook.lifted);
+  STAT (prb.treelook.probed);
+  STAT (prb.treelook.steps);
+  STAT (trd.count);
+  STAT (trd.red);
+  STAT (trd.failed);
+  STAT (trd.lits);
+  STAT (trd.bins);
+  STAT (trd.steps);
+  STAT (subs.count);
+  STAT (subs.clauses);
+  STAT (subs.subsumed);
+  STAT (subs.strengthened);
+  STAT (subs.red);
+  STAT (subs.steps);
+  STAT (bindup.removed);
+  STAT (bindup.red);
+  STAT (unhd.count);
+  STAT (unhd.rounds);
+  STAT (unhd.stamp.trds);
+  STAT (unhd.stamp.failed);
+  STAT (unhd.stamp.sccs);
+  STAT (unhd.stamp.sumsccsizes);
+  STAT (unhd.failed.lits);
+  STAT (unhd.failed.bin);
+  STAT (unhd.failed.trn);
+  STAT (unhd.failed.lrg);
+  STAT (unhd.tauts.bin);
+  STAT (unhd.tauts.trn);
+  STAT (unhd.tauts.lrg);
+  STAT (unhd.tauts.red);
+  STAT (unhd.units.bin);
+  STAT (unhd.units.trn);
+  STAT (unhd.units.lrg);
+  STAT (unhd.hbrs.trn);
+  STAT (unhd.hbrs.lrg);
+  STAT (unhd.hbrs.red);
+  STAT (unhd.str.trn);
+  STAT (unhd.str.lrg);
+  STAT (unhd.str.red);
+  STAT (unhd.steps);
+  STAT (elm.count);
+  STAT (elm.elmd);
+  STAT (elm.pure);
+  STAT (elm.large);
+  STAT (elm.sub);
+  STAT (elm.str);
+  STAT (elm.blkd);
+  STAT (elm.rounds);
+  STAT (elm.small.elm);
+  STAT (elm.small.tried);
+  STAT (elm.gates.equiv);
+  STAT (elm.gates.and);
+  STAT (elm.gates.ite);
+  STAT (elm.gates.xor);
+  STAT (elm.par.batches);
+  STAT (elm.par.cands);
+  STAT (elm.par.passed);
+  STAT (elm.par.deferred);
+  STAT (elm.small.failed);
+  STAT (elm.resolutions);
+  STAT (elm.copies);
+  STAT (elm.subchks);
+  STAT (elm.strchks);
+  STAT (elm.ipos);
+  STAT (elm.steps);
+  STAT (bkwd.sub2);
+  STAT (bkwd.sub3);
+  STAT (bkwd.subl);
+  STAT (bkwd.str2);
+  STAT (bkwd.str3);
+  STAT (bkwd.str3self);
+  STAT (bkwd.strl);
+  STAT (bkwd.strlself);
+  STAT (bkwd.tried.lits);
+  STAT (bkwd.tried.clauses);
+  STAT (bkwd.tried.occs);
+  STAT (bkwd.steps);
+  STAT (otfs.sub.irr);
+  STAT (otfs.sub.red);
+  STAT (otfs.sub.bin);
+  STAT (otfs.sub.trn);
+  STAT (otfs.sub.lrg);
+  STAT (otfs.str.irr);
+  STAT (otfs.str.red);
+  STAT (otfs.str.bin);
+  STAT (otfs.str.trn);
+  STAT (otfs.str.lrg);
+  STAT (otfs.driving);
+  STAT (otfs.restarting);
+  STAT (otfs.total);
+  STAT (lits.nonmin);
+  STAT (lits.learned);
+  STAT (clauses.learned);
+  STAT (clauses.glue);
+  STAT (clauses.realglue);
+  STAT (clauses.nonmaxglue);
+  STAT (clauses.scglue);
+  STAT (clauses.maxglue.count);
+  STAT (clauses.maxglue.kept);
+  STAT (phase.count);
+  STAT (phase.set);
+  STAT (phase.pos);
+  STAT (phase.neg);
+  STAT (simp.count);
+  STAT (simp.limhit.confs);
+  STAT (simp.limhit.irr);
+  STAT (simp.limhit.vars);
+  STAT (simp.limhit.its);
+  STAT (simp.limhit.bin);
+  STAT (simp.limhit.trn);
+  STAT (gauss.count);
+  STAT (gauss.gcs);
+  STAT (gauss.units);
+  STAT (gauss.equivs);
+  STAT (gauss.trneqs);
+  STAT (gauss.arity.max.total);
+  STAT (gauss.arity.max.last);
+  STAT (gauss.arity.sum.total);
+  STAT (gauss.arity.sum.exactly1);
+  STAT (gauss.steps.extr);
+  STAT (gauss.steps.elim);
+  STAT (gauss.extracted.total);
+  STAT (gauss.extracted.exactly1);
+  STAT (gauss.extracted.last);
+  STAT (cce.count);
+  STAT (cce.eliminated);
+  STAT (cce.ate);
+  STAT (cce.abce);
+  STAT (cce.failed);
+  STAT (cce.lifted);
+  STAT (cce.steps);
+  STAT (cce.probed);
+  STAT (cce.cache.search);
+  STAT (cce.cache.hits);
+  STAT (cce.cache.cols);
+  STAT (cce.cache.ins);
+  STAT (cce.cache.rsz);
+  STAT (card.count);
+  STAT (card.units);
+  STAT (card.expam1);
+  STAT (card.resched);
+  STAT (card.steps);
+  STAT (card.eliminated);
+  STAT (card.resolved);
+  STAT (card.subsumed);
+  STAT (card.found.am1.total.sum);
+  STAT (card.found.am1.total.cnt);
+  STAT (card.found.am1.total.max);
+  STAT (card.found.am1.last.cnt);
+  STAT (card.found.am1.last.max);
+  STAT (card.found.am2.total.sum);
+  STAT (card.found.am2.total.cnt);
+  STAT (card.found.am2.total.max);
+  STAT (card.found.am2.last.cnt);
+  STAT (card.found.am2.last.max);
+  STAT (card.used.am1.sum);
+  STAT (card.used.am1.cnt);
+  STAT (card.used.am2.sum);
+  STAT (card.used.am2.cnt);
+  STAT (moved.bin);
+  STAT (moved.trn);
+  STAT (bca.count);
+  STAT (bca.added);
+  STAT (bca.skipped);
+  STAT (bca.steps);
+  STAT (bva.count);
+  STAT (bva.vars);
+  STAT (bva.added);
+  STAT (bva.removed);
+  STAT (bva.steps);
+  STAT (sync.cls.produced);
+  STAT (sync.cls.consumed.actual);
+  STAT (sync.cls.consumed.tried);
+  STAT (sync.cls.consumed.calls);
+  STAT (sync.units.produced);
+  STAT (sync.units.consumed.actual);
+  STAT (sync.units.consumed.tried);
+  STAT (sync.units.consumed.calls);
+  STAT (deco.sum.orig);
+  STAT (deco.sum.red);
+  STAT (mincls.min);
+  STAT (mincls.bin);
+  STAT (mincls.size);
+  STAT (mincls.deco);
+  STAT (mincls.poison.search);
+  STAT (mincls.poison.hits);
+  STAT (mincls.usedtwice.search);
+  STAT (mincls.usedtwice.hits);
+  STAT (redcls.cls.tried);
+  STAT (redcls.cls.red);
+  STAT (redcls.cls.sat);
+  STAT (redcls.lits.tried);
+  STAT (redcls.lits.red);
+  STAT (redcls.lits.sat);
+  STAT (redcls.jlevel.red);
+  STAT (redcls.jlevel.sum);
+  STAT (drupped);
+  STAT (druplig);
+  STAT (subl.count);
+  STAT (subl.tried);
+  STAT (subl.cands);
+  STAT (subl.sub);
+  STAT (locs.count);
+  STAT (locs.flips);
+  STAT (locs.mems);
+  STAT (locs.min);
+  STAT (sweep.count);
+  STAT (sweep.failed);
+  STAT (sweep.impls);
+  STAT (sweep.equivs);
+  STAT (sweep.rounds);
+  STAT (sweep.steps);
+  STAT (sweep.cached);
+  STAT (sweep.sat);
+  STAT (sweep.unsat);
+  STAT (sweep.decs);
+  STAT (sweep.confs);
+  STAT (sweep.sumsize.classes);
+  STAT (sweep.sumsize.envs);
+  STAT (sweep.sim.count);
+  STAT (sweep.sim.gates);
+  STAT (sweep.sim.classes);
+  STAT (sweep.sim.refined);
+  STAT (sweep.queries.total);
+  STAT (sweep.queries.type[0].count);
+  STAT (sweep.queries.type[0].sat);
+  STAT (sweep.queries.type[0].unsat);
+  STAT (sweep.queries.type[1].count);
+  STAT (sweep.queries.type[1].sat);
+  STAT (sweep.queries.type[1].unsat);
+  STAT (sweep.queries.type[2].count);
+  STAT (sweep.queries.type[2].sat);
+  STAT (sweep.queries.type[2].unsat);
+  STAT (setscincf.count);
+  STAT (setscincf.max);
+  STAT (setscincf.min);
+  STAT (promote.tried);
+  STAT (promote.locked);
+  STAT (quatres.count);
+  STAT (quatres.quat);
+  STAT (quatres.self1);
+  STAT (quatres.self2);
+  STAT (quatres.dup);
+  STAT (queue.flushed);
+  STAT (queue.sorted);
+  STAT (bump.count);
+  STAT (bump.lits);
+  STAT (stability.count);
+  STATF (stability.avg, stability.avg.val);
+  STATCOVER (glue);
+  STATCOVER (jlevel);
+  STATCOVER (tlevel);
+  STATCOVER (avglue);
+  STATCOVER (its.avg);
+  STATCOVER (stability.avg);
+  STAT (stability.changed);
+  STAT (stability.level);
+  for (glue = 0; glue < POW2GLUE; glue++) {
+#define LIR(FIELD) \
+do { \
+  sprintf (name, "stats.lir.%d." # FIELD, glue); \
+  trav (state, name, (double) s->lir[glue].FIELD); \
+} while (0)
+    LIR (clauses);
+    LIR (added);
+    LIR (reduced);
+    LIR (retired);
+    LIR (resolved);
+    LIR (forcing);
+    LIR (conflicts);
+    LIR (maxbytes);
+#undef LIR
+  }
+  STATCOVER (lir);
+#ifndef NDEBUG
+  for (gap = i = 0; i < sizeof covered; i++)
+    if (!covered[i]) gap++;
+    else assert (!gap || (gap < 8 && !(i % 8))), gap = 0;
+  assert (gap < 8);
+#endif
+  TIME (all);
+  TIME (search);
+  TIME (preprocessing);
+  TIME (inprocessing);
+  TIME (lookahead);
+  TIME (elim);
+  TIME (transred);
+  TIME (subsume);
+  TIME (block);
+  TIME (unhide);
+  TIME (ternres);
+  TIME (gauss);
+  TIME (quatres);
+  TIME (card);
+  TIME (cce);
+  TIME (bca);
+  TIME (bva);
+  TIME (locs);
+  TIME (sweep);
+  TIME (showscoredist);
+  TIME (showfeatures);
+  TIME (prune);
+  TIME (probe);
+  TIME (prb.simple);
+  TIME (prb.basic);
+  TIME (prb.treelook);
+  TIME (quatres1);
+  TIME (quatres2);
+  TIME (gc);
+  TIME (decompose);
+  TIME (queuesort);
+  TIME (phase);
+  TIME (backward);
+  TIME (restart);
+  TIME (defrag);
+  TIME (reduce);
+  TIME (analysis);
+  TIME (decide);
+  TIME (bump);
+  TIME (mincls);
+  TIME (druplig);
+  TIME (redcls);
+  TIME (queuedecision);
+  TIME (heapdecision);
+  TIME (subl);
+  LIMIT (lkhdpen);
+  LIMIT (randec);
+  LIMIT (randphase);
+  LIMIT (dfg);
+  LIMIT (inc.visits);
+  LIMIT (inc.clauses.add);
+  LIMIT (inc.clauses.start);
+  LIMIT (inc.vars.start);
+  LIMIT (rescore.vars.otfs);
+  LIMIT (rescore.vars.confs);
+  LIMIT (elm.pen);
+  LIMIT (elm.del.cur);
+  LIMIT (elm.del.rem);
+  LIMIT (elm.steps);
+  LIMIT (elm.irrprgss);
+  LIMIT (blk.pen);
+  LIMIT (blk.del.cur);
+  LIMIT (blk.del.rem);
+  LIMIT (blk.steps);
+  LIMIT (blk.irrprgss);
+  LIMIT (trd.pen);
+  LIMIT (trd.del.cur);
+  LIMIT (trd.del.rem);
+  LIMIT (trd.steps);
+  LIMIT (subs.pen);
+  LIMIT (subs.del.cur);
+  LIMIT (subs.del.rem);
+  LIMIT (subs.steps);
+  LIMIT (unhd.pen);
+  LIMIT (unhd.del.cur);
+  LIMIT (unhd.del.rem);
+  LIMIT (unhd.steps);
+  LIMIT (ternres.pen);
+  LIMIT (ternres.del.cur);
+  LIMIT (ternres.del.rem);
+  LIMIT (ternres.steps);
+  LIMIT (quatres.pen);
+  LIMIT (quatres.del.cur);
+  LIMIT (quatres.del.rem);
+  LIMIT (quatres.steps);
+  LIMIT (cce.pen);
+  LIMIT (cce.del.cur);
+  LIMIT (cce.del.rem);
+  LIMIT (cce.steps);
+  LIMIT (card.pen);
+  LIMIT (card.del.cur);
+  LIMIT (card.del.rem);
+  LIMIT (card.steps);
+  LIMIT (sweep.pen);
+  LIMIT (sweep.del.cur);
+  LIMIT (sweep.del.rem);
+  LIMIT (sweep.steps);
+  LIMIT (gauss.pen);
+  LIMIT (gauss.del.cur);
+  LIMIT (gauss.del.rem);
+  LIMIT (gauss.steps.extr);
+  LIMIT (gauss.steps.elim);
+  LIMIT (restart.confs);
+  LIMIT (prb.steps);
+  LIMIT (prb.simple.pen);
+  LIMIT (prb.simple.del.cur);
+  LIMIT (prb.simple.del.rem);
+  LIMIT (prb.basic.pen);
+  LIMIT (prb.basic.del.cur);
+  LIMIT (prb.basic.del.rem);
+  LIMIT (prb.treelook.pen);
+  LIMIT (prb.treelook.del.cur);
+  LIMIT (prb.treelook.del.rem);
+  LIMIT (simp.confs);
+  LIMIT (simp.hard);
+  LIMIT (simp.vars);
+  LIMIT (simp.its);
+  LIMIT (simp.bin);
+  LIMIT (simp.trn);
+  LIMIT (simp.cinc);
+  LIMIT (simp.itinc);
+  LIMIT (simp.binc);
+  LIMIT (simp.tinc);
+  LIMIT (sync.steps);
+  LIMIT (sync.confs);
+  LIMIT (term.steps);
+  LIMIT (gc.fixed);
+  LIMIT (bca.del.cur);
+  LIMIT (bca.del.rem);
+  LIMIT (bca.steps);
+  LIMIT (bca.added);
+  LIMIT (bva.pen);
+  LIMIT (bva.del.cur);
+  LIMIT (bva.del.rem);
+  LIMIT (bva.steps);
+  LIMIT (trep.steps);
+  LIMIT (trep.time);
+  LIMIT (locs.confs);
+  LIMIT (locs.inc);
+  LIMIT (locs.vars);
+  LIMIT (reduce.redlarge);
+  LIMIT (reduce.reset);
+  LIMIT (prune.decisions);
+  LIMIT (prune.inc);
+}
+
+#undef STATCOVER
+#undef STAT
+#undef STATF
+#undef TIME
+#undef LIMIT
+
+typedef struct SWr { FILE * file; int count, csv; const char * sec; } SWr;
+
+static void lglwrstatname (void * voidptr, const char * name, double val) {
+  SWr * wr = voidptr;
+  (void) val;
+  if (wr->count++) fputc (',', wr->file);
+  fputs (name, wr->file);
+}
+
+static void lglwrstatval (void * voidptr, const char * name, double val) {
+  SWr * wr = voidptr;
+  const char * key = strchr (name, '.') + 1;
+  int len = key - name;
+  if (wr->csv) {
+    if (wr->count++) fputc (',', wr->file);
+  } else {
+    if (!wr->sec || strncmp (wr->sec, name, len)) {
+      if (wr->sec) fputs ("},", wr->file);
+      fprintf (wr->file, "\"%.*s\":{", len - 1, name);
+      wr->sec = name;
+      wr->count = 0;
+    }
+    if (wr->count++) fputc (',', wr->file);
+    fprintf (wr->file, "\"%s\":", key);
+  }
+  fprintf (wr->file, "%.15g", val);
+}
+
+void lglwritestats (LGL * lgl, FILE * file, int csv) {
+  SWr wr;
+  REQINIT ();
+  memset (&wr, 0, sizeof wr);
+  wr.file = file;
+  wr.csv = csv;
+  if (csv) {
+    lglstrav (lgl, &wr, lglwrstatname);
+    fputc ('\n', file);
+    wr.count = 0;
+  } else fputc ('{', file);
+  lglstrav (lgl, &wr, lglwrstatval);
+  if (!csv) fputs ("}}", file);
+  fputc ('\n', file);
+  fflush (file);
+}
+
 int64_t lglgetprops (LGL * lgl) {
   REQINITNOTFORKED ();
   return lgl->stats->props.search + lgl->stats->props.simp;
@@ -26090,7 +30824,10 @@ void lglrelease (LGL * lgl) {
 
   REQINIT ();
   if (lgl->clone) lglrelease (lgl->clone), lgl->clone = 0;
-  TRAPI ("release");
+  TRAPI (release);
+  lglreltrapi (lgl);
+  lglrelclog (lgl);
+  lglrelclassifier (lgl);
 
 #ifndef NLGLDRUPLIG
   if (lgl->druplig) druplig_reset (lgl->druplig), lgl->druplig = 0;
@@ -26120,6 +30857,9 @@ void lglrelease (LGL * lgl) {
   lglrelstk (lgl, &lgl->eassume);
   lglrelstk (lgl, &lgl->eclause);
   lglrelstk (lgl, &lgl->extend);
+  lglrelstk (lgl, &lgl->extseg);
+  lglrelstk (lgl, &lgl->exthead);
+  lglrelstk (lgl, &lgl->extlim);
   lglrelstk (lgl, &lgl->learned);
   lglrelstk (lgl, &lgl->frames);
   lglrelstk (lgl, &lgl->promote);
@@ -26147,6 +30887,7 @@ void lglrelease (LGL * lgl) {
   DEL (lgl->limits, 1);
   DEL (lgl->times, 1);
   DEL (lgl->timers, 1);
+  lglrelperf (lgl);
   DEL (lgl->red, MAXGLUE+1);
   DEL (lgl->wchs, 1);
 
@@ -26156,10 +30897,11 @@ void lglrelease (LGL * lgl) {
 
   // adjust upfront the mem counters ...
 
-  lgldec (lgl, sizeof *lgl->stats);
-  lgldec (lgl, sizeof *lgl->opts);
-  lgldec (lgl, sizeof *lgl->mem);
-  lgldec (lgl, sizeof *lgl);
+  lglrelmemblks (lgl);
+  lgldec (lgl, MEM_core, sizeof *lgl->stats);
+  lgldec (lgl, MEM_core, sizeof *lgl->opts);
+  lgldec (lgl, MEM_core, sizeof *lgl->mem);
+  lgldec (lgl, MEM_core, sizeof *lgl);
 
   assert (getenv ("LGLEAK") || !lgl->stats->bytes.current);
 
@@ -26278,7 +31020,8 @@ static void lglirrtrav (void * state, int red, int lit) {
   irrtrav->trav (irrtrav->state, lit);
 }
 
-void lglctrav (LGL * lgl, void * state, void (*trav)(void *, int)) {
+static void lglctravaux (LGL * lgl,
+                         void * state, void (*trav)(void *, int)) {
   IrrTrav irrtrav;
   irrtrav.state = state;
   irrtrav.trav = trav;
@@ -26288,9 +31031,136 @@ void lglctrav (LGL * lgl, void * state, void (*trav)(void *, int)) {
   lglictrav (lgl, 0, 0, &irrtrav, lglirrtrav);
 }
 
+// Extension variables introduced by bounded variable addition are not
+// visible to the user.  Clauses traversed with such variables are
+// collected and these variables are then eliminated by clause
+// distribution, which yields the projection of the formula onto the user
+// variables.  Since the distribution can be quadratic, it stops before
+// the collected literals exceed 'bvaproject' times their initial number.
+// The remaining extension variables are then traversed as auxiliary
+// variables 'lglmaxvar (lgl) + 1', 'lglmaxvar (lgl) + 2', ... (see
+// 'lglctrav' in 'lglib.h'), with the clauses which still contain them.
+
+typedef struct DefTrv {
+  LGL * lgl;
+  Stk clause, defs;
+  Trv * trv;
+} DefTrv;
+
+static void lgldeftrav (void * voidptr, int lit) {
+  DefTrv * dt = voidptr;
+  LGL * lgl = dt->lgl;
+  int hasdef = 0;
+  const int * p;
+  lglpushstk (lgl, &dt->clause, lit);
+  if (lit) return;
+  for (p = dt->clause.start; !hasdef && *p; p++)
+    if (abs (*p) > lgl->maxext) hasdef = 1;
+  for (p = dt->clause.start; p < dt->clause.top; p++)
+    if (hasdef) lglpushstk (lgl, &dt->defs, *p);
+    else dt->trv->trav (dt->trv->state, *p);
+  lglclnstk (&dt->clause);
+}
+
+static void lglresolvedef (LGL * lgl, signed char * mark, Stk * res,
+                           const int * c, const int * d, int pivot) {
+  const int * p;
+  int lit, tmp;
+  for (p = c; (lit = *p); p++)
+    if (lit != pivot) mark[abs (lit)] = lglsgn (lit);
+  for (p = d; (lit = *p); p++) {
+    if (lit == -pivot) continue;
+    tmp = mark[abs (lit)];
+    if (tmp == -lglsgn (lit)) break;
+  }
+  if (!lit) {
+    for (p = c; (lit = *p); p++)
+      if (lit != pivot) lglpushstk (lgl, res, lit);
+    for (p = d; (lit = *p); p++)
+      if (lit != -pivot && !mark[abs (lit)]) lglpushstk (lgl, res, lit);
+    lglpushstk (lgl, res, 0);
+  }
+  for (p = c; (lit = *p); p++) mark[abs (lit)] = 0;
+}
+
+static void lglprojectdefs (DefTrv * dt) {
+  int eidx, maxeidx, lit, pos, neg, * c, * d, * p;
+  LGL * lgl = dt->lgl;
+  Stk pcls, ncls, rest;
+  signed char * mark;
+  int64_t limit;
+  maxeidx = lgl->maxext + lgl->ndefs;
+  limit = lgl->opts->bvaproject.val * (int64_t) lglcntstk (&dt->defs);
+  NEW (mark, maxeidx + 1);
+  CLR (pcls); CLR (ncls); CLR (rest);
+  for (eidx = maxeidx; eidx > lgl->maxext; eidx--) {
+    for (c = dt->defs.start; c < dt->defs.top; c = p + 1) {
+      pos = neg = 0;
+      for (p = c; (lit = *p); p++)
+	if (lit == eidx) pos = 1;
+	else if (lit == -eidx) neg = 1;
+      if (pos) lglpushstk (lgl, &pcls, c - dt->defs.start);
+      else if (neg) lglpushstk (lgl, &ncls, c - dt->defs.start);
+      else while (c <= p) lglpushstk (lgl, &rest, *c++);
+    }
+    for (p = pcls.start; p < pcls.top; p++)
+      for (d = ncls.start; (int64_t) lglcntstk (&rest) <= limit &&
+                           d < ncls.top; d++)
+	lglresolvedef (lgl, mark, &rest,
+	  dt->defs.start + *p, dt->defs.start + *d, eidx);
+    lglclnstk (&pcls);
+    lglclnstk (&ncls);
+    if ((int64_t) lglcntstk (&rest) > limit) {
+      lglprt (lgl, 1,
+        "[bva-project] keeping %d extension variables as auxiliary",
+	eidx - lgl->maxext);
+      lglclnstk (&rest);
+      break;
+    }
+    SWAP (Stk, dt->defs, rest);
+    lglclnstk (&rest);
+  }
+  for (p = dt->defs.start; p < dt->defs.top; p++)
+    dt->trv->trav (dt->trv->state, *p);
+  lglrelstk (lgl, &pcls);
+  lglrelstk (lgl, &ncls);
+  lglrelstk (lgl, &rest);
+  DEL (mark, maxeidx + 1);
+}
+
+static void lglinitdeftrav (LGL * lgl, DefTrv * dt, Trv * trv) {
+  CLR (*dt);
+  dt->lgl = lgl;
+  dt->trv = trv;
+}
+
+static void lglreldeftrav (DefTrv * dt) {
+  LGL * lgl = dt->lgl;
+  lglprojectdefs (dt);
+  lglrelstk (lgl, &dt->clause);
+  lglrelstk (lgl, &dt->defs);
+}
+
+void lglctrav (LGL * lgl, void * state, void (*trav)(void *, int)) {
+  DefTrv deftrav;
+  Trv trv;
+  if (!lgl->ndefs) { lglctravaux (lgl, state, trav); return; }
+  trv.state = state;
+  trv.trav = trav;
+  lglinitdeftrav (lgl, &deftrav, &trv);
+  lglctravaux (lgl, &deftrav, lgldeftrav);
+  lglreldeftrav (&deftrav);
+}
+
+// Counts clauses and the maximum variable, which exceeds 'lglmaxvar' if
+// auxiliary variables are traversed (see 'lglprojectdefs').
+
+typedef struct CntTrv { int clauses, maxvar; } CntTrv;
+
 static void lgltravcounter (void * voidptr, int lit) {
-  int * cntptr = voidptr;
-  if (!lit) *cntptr += 1;
+  CntTrv * cnt = voidptr;
+  if (!lit) cnt->clauses++;
+  else if (abs (lit) > cnt->maxvar) cnt->maxvar = abs (lit);
 }
 
 static void lgltravprinter (void * voidptr, int lit) {
@@ -26299,17 +31169,30 @@ static void lgltravprinter (void * voidptr, int lit) {
   else fprintf (out, "0\n");
 }
 
+static void lglprintbcnf (LGL *, FILE *,
+  void (*)(LGL *, void *, void (*)(void *, int)));
+
 void lglprint (LGL * lgl, FILE * file) {
-  int count = 0;
-  lglctrav (lgl, &count, lgltravcounter);
-  fprintf (file, "p cnf %d %d\n", lglmaxvar (lgl), count);
+  CntTrv cnt;
+  if (lgl->opts->bincnf.val) {
+    lglprintbcnf (lgl, file, lglctrav);
+    return;
+  }
+  cnt.clauses = 0, cnt.maxvar = lglmaxvar (lgl);
+  lglctrav (lgl, &cnt, lgltravcounter);
+  fprintf (file, "p cnf %d %d\n", cnt.maxvar, cnt.clauses);
   lglctrav (lgl, file, lgltravprinter);
 }
 
 void lglprintall (LGL * lgl, FILE * file) {
-  int count = 0;
-  lgltravall (lgl, &count, lgltravcounter);
-  fprintf (file, "p cnf %d %d\n", lglmaxvar (lgl), count);
+  CntTrv cnt;
+  if (lgl->opts->bincnf.val) {
+    lglprintbcnf (lgl, file, lgltravall);
+    return;
+  }
+  cnt.clauses = 0, cnt.maxvar = lglmaxvar (lgl);
+  lgltravall (lgl, &cnt, lgltravcounter);
+  fprintf (file, "p cnf %d %d\n", cnt.maxvar, cnt.clauses);
   lgltravall (lgl, file, lgltravprinter);
 }
 
@@ -26344,6 +31227,8 @@ void lglrtrav (LGL * lgl, void * state, void (*trav)(void *, int, int)) {
 	  if (abs (other2) < idx) continue;
 	  assert (!lglval (lgl, other2));
 	} else other2 = 0;
+	if (lglisdef (lgl, lit) || lglisdef (lgl, other)) continue;
+	if (other2 && lglisdef (lgl, other2)) continue;
 	trav (state, lglexport (lgl, lit), 0);
 	trav (state, lglexport (lgl, other), 0);
 	if (other2) trav (state, lglexport (lgl, other2), 0);
@@ -26356,6 +31241,7 @@ void lglrtrav (LGL * lgl, void * state, void (*trav)(void *, int, int)) {
     for (c = lir->start; c < lir->top; c = p + 1) {
       p = c;
       if (*p >= NOTALIT) continue;
+      if (lglhasdef (lgl, c)) { while (*p) p++; continue; }
       while ((other = *p)) {
 	assert (!lglval (lgl, other));
 	trav (state, lglexport (lgl, other), 0);
@@ -26383,12 +31269,21 @@ static void lgltravalle (void * voidptr, int lit, int repr) {
 }
 
 void lgltravall (LGL * lgl, void * state, void (*trav)(void *, int)) {
-  Trv travstate;
+  Trv travstate, trv;
+  DefTrv deftrav;
+  if (lgl->ndefs) {
+    trv.state = state;
+    trv.trav = trav;
+    lglinitdeftrav (lgl, &deftrav, &trv);
+    state = &deftrav;
+    trav = lgldeftrav;
+  }
   travstate.state = state;
   travstate.trav = trav;
   lglutrav (lgl, &travstate, lgltravallu);
   lgletrav (lgl, &travstate, lgltravalle);
-  lglctrav (lgl, state, trav);
+  lglctravaux (lgl, state, trav);
+  if (lgl->ndefs) lglreldeftrav (&deftrav);
 }
 
 #ifndef NDEBUG
@@ -26577,10 +31472,233 @@ static void lglpushbuf (LGL * lgl, Buf * buf, int ch) {
   buf->start[buf->count] = 0;
 }
 
+/*------------------------------------------------------------------------*/
+// Binary CNF format.  After the four byte magic header follow the version,
+// the maximum variable index, the number of clauses and the maximum number
+// of clauses per block, all as unsigned LEB128 'varints'.  Then the
+// clauses are written in blocks.  Each block starts with its number of
+// clauses and its size in bytes, which allows to skip over blocks without
+// decoding them (for instance to decode blocks in parallel).  A clause is
+// encoded as its size followed by its literals mapped to '2*idx+sign',
+// sorted and delta encoded, again everything as varints.
+
+#define BCNFVERSION 1
+
+static const unsigned char lglbcnfmagic[4] = { 0x8c, 'L', 'B', 'C' };
+
+static void lglpushvarint (LGL * lgl, Buf * buf, unsigned u) {
+  while (u & ~0x7fu) {
+    lglpushbuf (lgl, buf, (u & 0x7f) | 0x80);
+    u >>= 7;
+  }
+  lglpushbuf (lgl, buf, u);
+}
+
+static void lglfputvarint (unsigned u, FILE * file) {
+  while (u & ~0x7fu) {
+    putc ((u & 0x7f) | 0x80, file);
+    u >>= 7;
+  }
+  putc (u, file);
+}
+
+static int lglfgetvarint (FILE * file, unsigned * uptr) {
+  unsigned res = 0, shift = 0;
+  int ch;
+  do {
+    if (shift > 28) return 0;
+    if ((ch = getc (file)) == EOF) return 0;
+    res |= (ch & 0x7fu) << shift;
+    shift += 7;
+  } while (ch & 0x80);
+  *uptr = res;
+  return 1;
+}
+
+static const unsigned char *
+lglgetvarint (const unsigned char * p, const unsigned char * end,
+              unsigned * uptr) {
+  unsigned res = 0, shift = 0;
+  int ch;
+  do {
+    if (p == end || shift > 28) return 0;
+    ch = *p++;
+    res |= (ch & 0x7fu) << shift;
+    shift += 7;
+  } while (ch & 0x80);
+  *uptr = res;
+  return p;
+}
+
+static unsigned lglbcnflit2u (int lit) {
+  return 2u*abs (lit) + (lit < 0);
+}
+
+static int lglbcnfu2lit (unsigned u) {
+  int res = u >> 1;
+  return (u & 1) ? -res : res;
+}
+
+static int lglcmpbcnflit (const int * a, const int * b) {
+  unsigned u = lglbcnflit2u (*a), v = lglbcnflit2u (*b);
+  if (u < v) return -1;
+  if (u > v) return 1;
+  return 0;
+}
+
+typedef struct BCNF {
+  LGL * lgl;
+  FILE * file;
+  Stk clause;
+  Buf block;
+  int clauses, blksize;
+} BCNF;
+
+static void lglflushbcnfblock (BCNF * bcnf) {
+#ifndef NLGLOG
+  LGL * lgl = bcnf->lgl;
+#endif
+  if (!bcnf->clauses) return;
+  lglfputvarint (bcnf->clauses, bcnf->file);
+  lglfputvarint (bcnf->block.count, bcnf->file);
+  fwrite (bcnf->block.start, 1, bcnf->block.count, bcnf->file);
+  LOG (2, "wrote binary CNF block of %d clauses with %ld bytes",
+       bcnf->clauses, (long) bcnf->block.count);
+  bcnf->block.count = 0;
+  bcnf->clauses = 0;
+}
+
+static void lglbcnftrav (void * voidptr, int lit) {
+  BCNF * bcnf = voidptr;
+  LGL * lgl = bcnf->lgl;
+  unsigned prev, u;
+  const int * p;
+  if (lit) { lglpushstk (lgl, &bcnf->clause, lit); return; }
+  SORTSTK (int, &bcnf->clause, lglcmpbcnflit);
+  lglpushvarint (lgl, &bcnf->block, lglcntstk (&bcnf->clause));
+  prev = 0;
+  for (p = bcnf->clause.start; p < bcnf->clause.top; p++) {
+    u = lglbcnflit2u (*p);
+    lglpushvarint (lgl, &bcnf->block, u - prev);
+    prev = u;
+  }
+  lglclnstk (&bcnf->clause);
+  if (++bcnf->clauses >= bcnf->blksize) lglflushbcnfblock (bcnf);
+}
+
+static void lglprintbcnf (LGL * lgl, FILE * file,
+  void (*travfun)(LGL *, void *, void (*)(void *, int)))
+{
+  CntTrv cnt;
+  BCNF bcnf;
+  cnt.clauses = 0, cnt.maxvar = lglmaxvar (lgl);
+  travfun (lgl, &cnt, lgltravcounter);
+  CLR (bcnf);
+  bcnf.lgl = lgl;
+  bcnf.file = file;
+  bcnf.blksize = lgl->opts->bincnfblk.val;
+  fwrite (lglbcnfmagic, 1, sizeof lglbcnfmagic, file);
+  lglfputvarint (BCNFVERSION, file);
+  lglfputvarint (cnt.maxvar, file);
+  lglfputvarint (cnt.clauses, file);
+  lglfputvarint (bcnf.blksize, file);
+  travfun (lgl, &bcnf, lglbcnftrav);
+  lglflushbcnfblock (&bcnf);
+  lglrelstk (lgl, &bcnf.clause);
+  DEL (bcnf.block.start, bcnf.block.size);
+  lglprt (lgl, 1, "wrote %d clauses in binary CNF format", cnt.clauses);
+}
+
+static const char *
+lglparsebcnf (LGL * lgl, FILE * in, int force, int * lp, int * mp) {
+  unsigned version, m, n, blksize, clauses, bytes, size, delta, u;
+  const unsigned char * p, * end;
+  int64_t lits = 0;
+  unsigned c = 0;
+  int i, lit, v = 0;
+  const char * res = 0;
+  Buf buf;
+  for (i = 1; i < (int) sizeof lglbcnfmagic; i++)
+    if (getc (in) != lglbcnfmagic[i])
+      return "invalid binary CNF header: magic number mismatch";
+  if (!lglfgetvarint (in, &version))
+    return "invalid binary CNF header: version missing";
+  if (version != BCNFVERSION)
+    return "invalid binary CNF header: unsupported version";
+  if (!lglfgetvarint (in, &m) || m > MAXVAR ||
+      !lglfgetvarint (in, &n) || n > INT_MAX ||
+      !lglfgetvarint (in, &blksize))
+    return "invalid binary CNF header";
+  lglprt (lgl, 1, "found binary CNF header with %u variables %u clauses",
+          m, n);
+  *mp = m;
+  CLR (buf);
+  while (c < n) {
+    if (!lglfgetvarint (in, &clauses) || !clauses || n - c < clauses ||
+        !lglfgetvarint (in, &bytes)) {
+      res = "invalid binary CNF block header";
+      break;
+    }
+    if (buf.size < bytes + 1) {
+      RSZ (buf.start, buf.size, bytes + 1);
+      buf.size = bytes + 1;
+    }
+    if (fread (buf.start, 1, bytes, in) != bytes) {
+      res = "truncated binary CNF block";
+      break;
+    }
+    p = (const unsigned char *) buf.start;
+    end = p + bytes;
+    while (clauses-- > 0) {
+      *lp = ++c;
+      if (!(p = lglgetvarint (p, end, &size))) {
+	res = "invalid clause size in binary CNF block";
+	goto DONE;
+      }
+      u = 0;
+      while (size-- > 0) {
+	if (!(p = lglgetvarint (p, end, &delta))) {
+	  res = "invalid literal in binary CNF block";
+	  goto DONE;
+	}
+	u += delta;
+	lit = lglbcnfu2lit (u);
+	if (!lit || abs (lit) > MAXVAR) {
+	  res = "invalid literal in binary CNF block";
+	  goto DONE;
+	}
+	if (!force && abs (lit) > (int) m) {
+	  res = "maxium variable index exceeded";
+	  goto DONE;
+	}
+	if (abs (lit) > v) v = abs (lit);
+	lgladd (lgl, lit);
+	lits++;
+      }
+      lgladd (lgl, 0);
+    }
+    if (p != end) {
+      res = "inconsistent binary CNF block size";
+      break;
+    }
+  }
+DONE:
+  DEL (buf.start, buf.size);
+  if (!res)
+    lglprt (lgl, 1,
+      "read %d variables, %u clauses, %lld literals in %.2f seconds",
+      v, c, (LGLL) lits, lglsec (lgl));
+  return res;
+}
+
 const char *
 lglparsefile (LGL * lgl, FILE * in, int force, int * lp, int * mp) {
   int ch, prev, m, n, v, c, l, lit, sign, val, embedded = 0, header, section;
+  int incremental, assuming, pending, frozen, queries;
   Buf buf;
+  ch = getc (in);
+  if (ch == lglbcnfmagic[0]) return lglparsebcnf (lgl, in, force, lp, mp);
+  if (ch != EOF) ungetc (ch, in);
   CLR (buf);
 SKIP:
   ch = lglnextch (in, lp);
@@ -26632,6 +31750,7 @@ SKIP:
      else lglprt (lgl, 1,  "no embedded options");
   }
   header = section = m = n = v = l = c = 0;
+  incremental = assuming = pending = frozen = queries = 0;
   if (force) {
     if (ch == 'p')  {
       lglprt (lgl, 1, "will not read header");
@@ -26645,6 +31764,21 @@ SKIP:
     return "invalid header: expected ' ' after 'p'";
   while ((ch = lglnextch (in, lp)) == ' ')
     ;
+  if (ch == 'i') {
+    if (lglnextch (in, lp) != 'n' ||
+        lglnextch (in, lp) != 'c' ||
+        lglnextch (in, lp) != 'c' ||
+        lglnextch (in, lp) != 'n' ||
+        lglnextch (in, lp) != 'f')
+      return "invalid header: expected 'p inccnf'";
+    while ((ch = lglnextch (in, lp)) == ' ')
+      ;
+    if (ch == '\r') ch = lglnextch (in, lp);
+    if (ch != '\n') return "invalid header: expected new line after header";
+    lglprt (lgl, 1, "found 'p inccnf' header");
+    incremental = 1;
+    goto BODY;
+  }
   if (ch != 'c') return "invalid header: expected 'c' after ' '";
   if (lglnextch (in, lp) != 'n')
     return "invalid header: expected 'n' after 'c'";
@@ -26687,13 +31821,25 @@ BODY2:
     section = ch;
     goto BODY;
   }
+  if (ch == 'a') {
+    if (!incremental) return "assumptions only allowed in incremental CNF";
+    if (!lgl->cbs || !lgl->cbs->query.fun)
+      return "no query handler for assumptions";
+    if (section) return "assumptions after section header";
+    if (pending) return "assumptions within clause";
+    assuming = 1;
+    goto BODY;
+  }
   if (ch == EOF) {
+    if (pending || assuming) return "zero sentinel missing at end-of-file";
     if (header && c + 1 == n) return "clause missing";
     if (header && c < n) return "clauses missing";
 DONE:
+    if (incremental) *mp = v;
     lglprt (lgl, 1,
       "read %d variables, %d clauses, %d literals in %.2f seconds", 
       v, c, l, lglsec (lgl));
+    if (queries) lglprt (lgl, 1, "answered %d queries", queries);
     return 0;
   }
   if (ch == '-') {
@@ -26708,15 +31854,27 @@ DONE:
     lit = 10 * lit + (ch - '0');
   if (header && lit > m) return "maxium variable index exceeded";
   if (lit > v) v = lit;
+  if (incremental)
+    while (frozen < lit)
+      lglfreeze (lgl, ++frozen);
+  lit *= sign;
+  if (assuming) {
+    if (lit) lglassume (lgl, lit);
+    else {
+      assuming = 0;
+      lgl->cbs->query.fun (lgl->cbs->query.state, ++queries);
+    }
+    goto BODY;
+  }
   if (lit) l++;
   else c++;
-  lit *= sign;
   if (section) {
     assert (section == 'o');		// no other sections yet
     lglsetimportant (lgl, lit);
     section = 0;
   } else {
     lgladd (lgl, lit);
+    pending = (lit != 0);
     if (!lit && force && c == n) goto DONE;
   }
   goto BODY;
@@ -26778,3 +31936,161 @@ lglparsepath (LGL * lgl, const char * path, int force, int * lp, int * mp)
   if (clin == 2) pclose (in);
   return res;
 }
+
+/*------------------------------------------------------------------------*/
+
+void lglrtrapi (LGL * lgl, FILE * file) {
+  int cmd, arg, res, * start, * top;
+  const char * opt;
+  LTR * ltr;
+  REQINITNOTFORKED ();
+  ltr = ltrinit (file);
+  ABORTIF (!ltr, "out of memory allocating API trace reader");
+  lglprt (lgl, 1, "replaying %s API trace",
+          ltrbinary (ltr) ? "binary" : "text");
+  while ((res = ltrnext (ltr, &cmd, &arg, &opt)) > 0) {
+    switch (cmd) {
+      case LTR_add: lgladd (lgl, arg); break;
+      case LTR_assume: lglassume (lgl, arg); break;
+      case LTR_cassume: lglcassume (lgl, arg); break;
+      case LTR_changed: (void) lglchanged (lgl); break;
+      case LTR_chkclone: lglchkclone (lgl); break;
+      case LTR_deref: (void) lglderef (lgl, arg); break;
+      case LTR_failed: (void) lglfailed (lgl, arg); break;
+      case LTR_fixate: lglfixate (lgl); break;
+      case LTR_fixed: (void) lglfixed (lgl, arg); break;
+      case LTR_flush: lglflushcache (lgl); break;
+      case LTR_freeze: lglfreeze (lgl, arg); break;
+      case LTR_frozen: (void) lglfrozen (lgl, arg); break;
+      case LTR_incvar: (void) lglincvar (lgl); break;
+      case LTR_inconsistent: (void) lglinconsistent (lgl); break;
+      case LTR_lkhd: (void) lglookahead (lgl); break;
+      case LTR_maxvar: (void) lglmaxvar (lgl); break;
+      case LTR_melt: lglmelt (lgl, arg); break;
+      case LTR_meltall: lglmeltall (lgl); break;
+      case LTR_option: lglsetopt (lgl, opt, arg); break;
+      case LTR_reconstk: lglreconstk (lgl, &start, &top); break;
+      case LTR_reduce: lglreducecache (lgl); break;
+      case LTR_repr: (void) lglrepr (lgl, arg); break;
+      case LTR_resetphase: lglresetphase (lgl, arg); break;
+      case LTR_reusable: (void) lglreusable (lgl, arg); break;
+      case LTR_reuse: lglreuse (lgl, arg); break;
+      case LTR_sat: (void) lglsat (lgl); break;
+      case LTR_setimportant: lglsetimportant (lgl, arg); break;
+      case LTR_setphase: lglsetphase (lgl, arg); break;
+      case LTR_setphases: lglsetphases (lgl); break;
+      case LTR_simp: (void) lglsimp (lgl, arg); break;
+      case LTR_stats: lglstats (lgl); break;
+      case LTR_usable: (void) lglusable (lgl, arg); break;
+      default: break;	// 'init', 'release', 'return', ...
+    }
+    if (cmd == LTR_release) break;
+  }
+  ABORTIF (res < 0, "invalid API trace: %s", ltrerr (ltr));
+  lglprt (lgl, 1, "replayed %d API trace events", ltrlineno (ltr) - 1);
+  ltrelease (ltr);
+}
+
+/*------------------------------------------------------------------------*/
+#ifdef LGLMICRO
+/*------------------------------------------------------------------------*/
+// Test only entry point for kernel micro benchmarks (see 'lglmicro.c'),
+// compiled only with '-DLGLMICRO'.  The irredundant clauses are added
+// through the API before, such that their size and the length of watch
+// lists are controlled by the caller.  Then 'learned' redundant clauses
+// of size 'size' with glue uniformly distributed in '[1,glue]' are added
+// and the given kernel is run for 'rounds' rounds.  The time spent in the
+// kernel itself is returned in seconds and its work is stored in
+// '*countptr', i.e., visits for 'propsearch' and 'prop', conflicts for
+// 'ana' (including 'lglmincls') and collected or retired clauses for
+// 'reduce'.
+
+static int lglmicrolit (LGL * lgl) {
+  int idx, tries;
+  if (!lgl->unassigned || lgl->nvars <= 2) return 0;
+  for (tries = 0; tries < 1000; tries++) {
+    idx = 2 + lglrand (lgl) % (lgl->nvars - 2);
+    if (lglval (lgl, idx) || !lglisfree (lgl, idx)) continue;
+    return (lglrand (lgl) & 1) ? -idx : idx;
+  }
+  return 0;
+}
+
+static void lglmicrolearn (LGL * lgl, int learned, int size, int glue) {
+  int i, j, lit;
+  assert (!lgl->level);
+  for (i = 0; i < learned; i++) {
+    assert (lglmtstk (&lgl->clause));
+    for (j = 0; j < size; j++) {
+      if (!(lit = lglmicrolit (lgl))) break;
+      if (lglavar (lgl, lit)->mark) { j--; continue; }
+      lglavar (lgl, lit)->mark = 1;
+      lglpushstk (lgl, &lgl->clause, lit);
+    }
+    for (j = 0; j < (int) lglcntstk (&lgl->clause); j++)
+      lglavar (lgl, lgl->clause.start[j])->mark = 0;
+    lglpushstk (lgl, &lgl->clause, 0);
+    if (lglcntstk (&lgl->clause) > 4)
+      lgladdcls (lgl, REDCS, 1 + lglrand (lgl) % glue, 0);
+    lglclnstk (&lgl->clause);
+  }
+}
+
+double lglmicro (LGL * lgl, const char * kernel,
+                 int learned, int size, int glue,
+		 int64_t rounds, int64_t * countptr) {
+  int64_t round, before, count;
+  int search, prop, ana, reduce, lit;
+  double res, start;
+  REQINITNOTFORKED ();
+  ABORTIF (size < 4, "learned clause size below 4");
+  ABORTIF (glue < 1, "non-positive maximum glue");
+  search = !strcmp (kernel, "propsearch");
+  prop = !strcmp (kernel, "prop");
+  ana = !strcmp (kernel, "ana");
+  reduce = !strcmp (kernel, "reduce");
+  ABORTIF (!search && !prop && !ana && !reduce,
+    "invalid kernel '%s'", kernel);
+  res = 0;
+  count = 0;
+  lglinitsolve (lgl);
+  if (lglbcptop (lgl)) lglmicrolearn (lgl, learned, size, glue);
+  for (round = 0; !lgl->mt && round < rounds; round++) {
+    if (reduce) {
+      before = lgl->stats->reduced.collected + lgl->stats->reduced.retired;
+      start = lglmonotonictime ();
+      lglreduce (lgl, 1);
+      res += lglmonotonictime () - start;
+      count += lgl->stats->reduced.collected + lgl->stats->reduced.retired;
+      count -= before;
+      lglmicrolearn (lgl, learned, size, glue);
+    } else if (ana) {
+      while (lglbcpsearch (lgl) && (lit = lglmicrolit (lgl)))
+	lgldassume (lgl, lit);
+      if (lgl->conf.lit) {
+	start = lglmonotonictime ();
+	lglana (lgl);
+	res += lglmonotonictime () - start;
+	count++;
+      } else if (lgl->level) lglbacktrack (lgl, 0);
+    } else {
+      before = lgl->stats->visits.search;
+      while (!lgl->conf.lit && (lit = lglmicrolit (lgl))) {
+	lgldassume (lgl, lit);
+	start = lglmonotonictime ();
+	if (search) lglbcpsearch (lgl);
+	else lglbcp (lgl);
+	res += lglmonotonictime () - start;
+      }
+      count += lgl->stats->visits.search - before;
+      if (lgl->level) lglbacktrack (lgl, 0);
+    }
+  }
+  if (lgl->level) lglbacktrack (lgl, 0);
+  if (countptr) *countptr = count;
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+#endif
+/*------------------------------------------------------------------------*/
@@ -23,7 +23,8 @@ typedef struct LGL LGL;
 LGL * lglinit (void);				// constructor
 void lglrelease (LGL *);			// destructor
 
-// externally provided memory manager ...
+// externally provided memory manager ...  The sizes passed to these
+// functions are exactly the sizes of the blocks used by the solver.
 
 typedef void * (*lglalloc) (void*mem, size_t);
 typedef void (*lgldealloc) (void*mem, void*, size_t);
@@ -38,6 +39,15 @@ LGL * lglmclone (LGL *, void *mem, lglalloc, lglrealloc, lgldealloc);
 
 int lglunclone (LGL * dst, LGL * src);		// does not release 'src'
 
+// Write the complete solver state to a file and read it back.  Snapshots
+// are only compatible with the same binary build and do not include
+// callbacks, API traces nor output settings.  For compression pass a pipe
+// to an external compressor.  'lglsnapshot' returns zero on write errors
+// and 'lglrestore' a zero pointer on invalid or truncated snapshots.
+
+int lglsnapshot (LGL *, FILE *);
+LGL * lglrestore (FILE *);
+
 // 'Forking' copies only irredundant clauses and also uses internal variable
 // indices of the parent as external variable indices.  Thus 'parent' and
 // the forked off 'child' do neither exactly work the same way, nor do they
@@ -77,6 +87,15 @@ const char * lglparsefile (LGL *, FILE *, int force,
 const char * lglparsepath (LGL *, const char * path, int force,
                            int * lineno_ptr, int * max_var_ptr);
 
+// Incremental CNF files start with 'p inccnf' instead of 'p cnf <m> <n>'
+// and may contain assumption lines 'a <lit> ... 0' between clauses.  All
+// variables are frozen by the parser.  At the end of each assumption line
+// the literals are assumed and the 'query' call back is called with the
+// number of the query, which usually calls 'lglsat' and reports the
+// result.  Without this call back assumption lines are parse errors.
+
+void lglsetquery (LGL *, void (*query)(void*, int count), void *);
+
 //--------------------------------------------------------------------------
 
 const char * lglversion ();
@@ -96,11 +115,17 @@ void lglsizes (LGL *);				// ... data structure sizes
 
 void lglsetout (LGL *, FILE*);			// output file for report
 void lglsetrace (LGL *, FILE*);			// set trace output file
+void lglsetimeline (LGL *, FILE*);		// Chrome trace timeline
 void lglsetprefix (LGL *, const char*);		// prefix for messages
 
 FILE * lglgetout (LGL *);
 const char * lglgetprefix (LGL *);
 
+// The timeline is a JSON array of Chrome trace events, which can be shared
+// by several solver instances, even if they run in different threads.  The
+// opening bracket is written if the file is still empty.  Writing the
+// closing bracket after the last solver is done is optional.
+
 void lglsetopt (LGL *, const char *, int);	// set option value
 int lglreadopts (LGL *, FILE *);		// read and set options
 int lglgetopt (LGL *, const char *);		// get option value
@@ -139,6 +164,17 @@ void lglsetimportant (LGL *, int lit);
 
 void lglsetphases (LGL *);
 
+// Warm start files contain the saved phases, the variable order and low
+// glue learned clauses ('warmglue') of a solver in terms of external
+// variables.  Reading them into a solver for a similar formula after
+// adding its clauses makes it start from the same phases and variable
+// order.  Learned clauses are only added if they are implied by
+// propagation.  Reading resets pending assumptions.  Both functions
+// return zero on I/O or parse errors.
+
+int lglwritewarm (LGL *, FILE *);
+int lglreadwarm (LGL *, FILE *);
+
 //--------------------------------------------------------------------------
 // call back for abort
 
@@ -148,10 +184,41 @@ void lglonabort (LGL *, void * state, void (*callback)(void* state));
 // write and read API trace
 
 void lglwtrapi (LGL *, FILE *);
-void lglrtrapi (LGL *, FILE *);
+void lglrtrapi (LGL *, FILE *);			// text or binary
+
+// The binary API trace format is more compact and much cheaper to write.
+// It is also selected if the file name in the 'LGLAPITRACE' environment
+// variable has suffix '.btr' or '.btr.gz'.  Buffers are written from a
+// background thread if the option 'trapiasync' is set.
+
+void lglwtrapibin (LGL *, FILE *);
+
+//--------------------------------------------------------------------------
+// Binary log of conflicts, restarts and reductions during search, written
+// by a background thread while the option 'clog' is set (see 'lglclog.h'
+// for the format and 'lglunclog' for decoding).  The file is flushed by
+// 'lglrelease' but not closed.
+
+void lglsetclog (LGL *, FILE *);
+
+//--------------------------------------------------------------------------
+// Read a classifier which selects one of several option presets based on
+// the features of the formula at the first call to 'lglsat' or 'lglsimp'
+// (see 'lglreadclassifier' in 'lglib.c' for the format).  Options set
+// explicitly are not overwritten.  Returns the number of presets or '-1'
+// after printing a warning if the file is invalid.  Selecting a preset is
+// controlled by the option 'presetclassify' and then replaces the
+// built-in SAT Competition 2014 classifier ('classify').
+
+int lglreadclassifier (LGL *, FILE *);
 
 //--------------------------------------------------------------------------
 // traverse units, equivalences, remaining clauses, or all clauses:
+//
+// Clauses are projected onto the user variables.  If this would blow up
+// the formula too much (option 'bvaproject'), the clause traversals may
+// also contain auxiliary variables 'lglmaxvar () + 1', 'lglmaxvar () + 2',
+// ... which are existentially quantified and not part of the API.
 
 void lglutrav (LGL *, void * state, void (*trav)(void *, int unit));
 void lgletrav (LGL *, void * state, void (*trav)(void *, int lit, int repr));
@@ -175,6 +242,14 @@ void lglassume (LGL *, int lit);		// assume single units
 void lglcassume (LGL *, int lit);		// assume clause
 						// (at most one)
 
+// Bulk versions of 'lgladd' and 'lglassume' for 'n' literals, where for
+// 'lgladdclauses' clauses are separated by zeroes as with 'lgladd'.  They
+// are equivalent to calling 'lgladd' respectively 'lglassume' for each
+// literal in turn.
+
+void lgladdclauses (LGL *, const int * lits, size_t n);
+void lglassumeall (LGL *, const int * lits, size_t n);
+
 void lglfixate (LGL *);				// add assumptions as units
 
 int lglsat (LGL *);
@@ -184,6 +259,22 @@ int lglderef (LGL *, int lit);			// neg=false, pos=true
 int lglfixed (LGL *, int lit);			// ditto but toplevel
 
 int lglfailed (LGL *, int lit);			// ditto for assumptions
+
+// Bulk versions of 'lglderef' and 'lglfailed'.  The first fills
+// 'buf[1..maxvar]' with the values of all variables (thus 'buf' needs
+// 'maxvar + 1' entries) and returns 'lglmaxvar'.  The second stores the
+// failed assumptions in 'buf' (at most 'size') and returns their number.
+
+int lglgetmodel (LGL *, signed char * buf, int maxvar);
+int lglgetfailed (LGL *, int * buf, int size);
+
+// With '--lazyext=1' the model is not extended to eliminated variables
+// after 'lglsat' returns 10 but only on demand.  Then 'lglextendvars'
+// computes the values of the given variables by processing only the part
+// of the reconstruction stack they depend on.  Afterwards 'lglderef' of
+// these variables does not require full extension anymore.
+
+void lglextendvars (LGL *, const int * vars, int n);
 int lglinconsistent (LGL *);			// contains empty clause?
 int lglchanged (LGL *);				// model changed
 
@@ -327,6 +418,26 @@ double lglmaxmb (LGL *);
 double lglsec (LGL *);
 double lglprocesstime (void);
 
+// Live and peak allocated bytes per subsystem ('core', 'variables',
+// 'external', 'extend', 'irredundant', 'redundant', 'watches', 'search',
+// 'elim', 'gauss', 'simplify' and 'other').
+
+void lglmemtrav (LGL *, void * state,
+                 void (*trav)(void *, const char * name,
+		              size_t current, size_t max));
+
+// Machine readable statistics: traverse all counters of the memory,
+// statistics, time and limit sections with names of the form
+// '<section>.<counter>', or write them as one JSON object (nested by
+// section) respectively as CSV header line followed by one line of
+// values.  The snapshot call back is called during search every
+// 'statsint' conflicts and may use these functions on the given solver.
+
+void lglstrav (LGL *, void * state,
+               void (*trav)(void *, const char * name, double val));
+void lglwritestats (LGL *, FILE *, int csv);
+void lglsetstatsnap (LGL *, void (*snap)(void *, LGL *), void *);
+
 //--------------------------------------------------------------------------
 // low-level parallel support through call backs
 
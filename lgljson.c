@@ -0,0 +1,141 @@
+#include "lgljson.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// How a statistic of several instances is aggregated in 'total'.
+
+enum { LJSSKIP, LJSSUM, LJSMAX, LJSMIN };
+
+typedef struct LJStat { char * name; double val; int kind; } LJStat;
+
+struct LJS {
+  FILE * file;
+  int workers, nstats, szstats, failed;
+  LJStat * stats;
+};
+
+LJS * ljsinit (FILE * file) {
+  LJS * res = malloc (sizeof *res);
+  if (!res) return res;
+  memset (res, 0, sizeof *res);
+  res->file = file;
+  return res;
+}
+
+static int ljshascomponent (const char * name, const char * component) {
+  size_t len = strlen (component);
+  const char * p = name;
+  while ((p = strstr (p, component))) {
+    if ((p == name || p[-1] == '.') && (!p[len] || p[len] == '.'))
+      return 1;
+    p++;
+  }
+  return 0;
+}
+
+// Only counters are added up.  Maxima and minima are aggregated as such.
+// Limits, moving averages and snapshots of the current state or the last
+// round, apart from allocated memory, are meaningless for several
+// instances and skipped.  The kind is derived from the statistic name
+// ('stats.mincls.min' counts minimized clauses and is not a minimum).
+
+static int ljskind (const char * name) {
+  static const char * skipped[] = {
+    "solver.id", "solver.mb", "solver.vars", "solver.clauses",
+    "limits.", "stats.agility", "stats.glue.", "stats.jlevel.",
+    "stats.tlevel", "stats.avglue", "stats.its.avg.",
+    "stats.stability.avg", 0
+  };
+  const char ** p;
+  for (p = skipped; *p; p++)
+    if (!strncmp (name, *p, strlen (*p))) return LJSSKIP;
+  if (!strncmp (name, "stats.mincls.", 13)) return LJSSUM;
+  if (ljshascomponent (name, "last")) return LJSSKIP;
+  if (ljshascomponent (name, "max") ||
+      ljshascomponent (name, "maxmb") ||
+      ljshascomponent (name, "maxbytes")) return LJSMAX;
+  if (ljshascomponent (name, "min")) return LJSMIN;
+  if (!strncmp (name, "memory.", 7) || !strncmp (name, "stats.bytes.", 12))
+    return LJSSUM;
+  if (ljshascomponent (name, "current") ||
+      ljshascomponent (name, "cur")) return LJSSKIP;
+  return LJSSUM;
+}
+
+typedef struct LJSTrav { LJS * ljs; int idx; } LJSTrav;
+
+static void ljstrav (void * voidptr, const char * name, double val) {
+  LJSTrav * trav = voidptr;
+  LJS * ljs = trav->ljs;
+  int idx = trav->idx++;
+  LJStat * stat;
+  if (ljs->failed) return;
+  if (idx == ljs->nstats) {
+    if (ljs->nstats == ljs->szstats) {
+      int newsz = ljs->szstats ? 2*ljs->szstats : 1024;
+      LJStat * stats = realloc (ljs->stats, newsz * sizeof *stats);
+      if (!stats) { ljs->failed = 1; return; }
+      ljs->stats = stats;
+      ljs->szstats = newsz;
+    }
+    stat = ljs->stats + idx;
+    if (!(stat->name = malloc (strlen (name) + 1))) {
+      ljs->failed = 1;
+      return;
+    }
+    strcpy (stat->name, name);
+    stat->kind = ljskind (name);
+    stat->val = val;
+    ljs->nstats++;
+    return;
+  }
+  stat = ljs->stats + idx;
+  assert (!strcmp (stat->name, name));
+  switch (stat->kind) {
+    case LJSSUM: stat->val += val; break;
+    case LJSMAX: if (val > stat->val) stat->val = val; break;
+    case LJSMIN: if (val < stat->val) stat->val = val; break;
+    default: assert (stat->kind == LJSSKIP); break;
+  }
+}
+
+void ljsadd (LJS * ljs, LGL * lgl) {
+  LJSTrav trav;
+  fputs (ljs->workers++ ? "," : "{\"workers\":[", ljs->file);
+  lglwritestats (lgl, ljs->file, 0);
+  trav.ljs = ljs;
+  trav.idx = 0;
+  lglstrav (lgl, &trav, ljstrav);
+}
+
+void ljsrelease (LJS * ljs) {
+  const char * sec = 0, * name, * key;
+  FILE * file = ljs->file;
+  int i, len, count = 0;
+  fputs (ljs->workers ? "]" : "{\"workers\":[]", file);
+  if (!ljs->failed) {
+    fputs (",\"total\":{", file);
+    for (i = 0; i < ljs->nstats; i++) {
+      if (ljs->stats[i].kind == LJSSKIP) continue;
+      name = ljs->stats[i].name;
+      key = strchr (name, '.') + 1;
+      len = key - name;
+      if (!sec || strncmp (sec, name, len)) {
+	if (sec) fputs ("},", file);
+	fprintf (file, "\"%.*s\":{", len - 1, name);
+	sec = name;
+	count = 0;
+      }
+      if (count++) fputc (',', file);
+      fprintf (file, "\"%s\":%.15g", key, ljs->stats[i].val);
+    }
+    fputs (sec ? "}}" : "}", file);
+  }
+  fputs ("}\n", file);
+  fclose (file);
+  for (i = 0; i < ljs->nstats; i++) free (ljs->stats[i].name);
+  free (ljs->stats);
+  free (ljs);
+}
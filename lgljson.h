@@ -0,0 +1,21 @@
+#ifndef LGLJSON_h_INCLUDED
+#define LGLJSON_h_INCLUDED
+
+#include <stdio.h>
+
+#include "lglib.h"
+
+// Aggregated machine readable statistics of several solver instances:
+// 'ljsadd' writes the JSON object of one instance into the 'workers' array
+// and aggregates its statistics, and 'ljsrelease' writes the aggregate as
+// 'total', closes the file and releases the aggregator.  In 'total'
+// counters are added up, maxima and minima combined, and averages, limits
+// and snapshots skipped.  It is omitted if memory for it ran out.
+
+typedef struct LJS LJS;
+
+LJS * ljsinit (FILE * file);
+void ljsadd (LJS *, LGL *);
+void ljsrelease (LJS *);
+
+#endif
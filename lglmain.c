@@ -145,9 +145,57 @@ static void closefile (FILE * file, int type) {
   if (type == 2) pclose (file);
 }
 
+static void printwitness (LGL * lgl, int maxvar, int simponly) {
+  signed char * model;
+  int i, val, lit;
+  OBuf obuf;
+  obuf.pos = 0;
+  if ((model = malloc (maxvar + 1))) lglgetmodel (lgl, model, maxvar);
+  for (i = 1; i <= maxvar; i++) {
+    val = model ? model[i] : lglderef (lgl, i);
+    lit = (val > 0) ? i : -i;
+    print2obuf (&obuf, lit, simponly, stdout);
+  }
+  free (model);
+  print2obuf (&obuf, 0, simponly, stdout);
+  if (obuf.pos > 0) flushobuf (&obuf, simponly, stdout);
+  fflush (stdout);
+}
+
+static void printstatus (int res) {
+  if (res == 10) fputs ("s SATISFIABLE\n", stdout);
+  else if (res == 20) fputs ("s UNSATISFIABLE\n", stdout);
+  else fputs ("c s UNKNOWN\n", stdout);
+}
+
+static int queries, lastqueryres;
+
+static void query (void * voidptr, int count) {
+  LGL * lgl = voidptr;
+  int res;
+  if (verbose >= 0) printf ("c\nc query %d\nc\n", count), fflush (stdout);
+  res = lglsat (lgl);
+  printstatus (res);
+  fflush (stdout);
+  if (res == 10 && lglgetopt (lgl, "witness"))
+    printwitness (lgl, lglmaxvar (lgl), 0);
+  lastqueryres = res;
+  queries = count;
+}
+
+static FILE * jsonfile, * timelinefile, * clogfile;
+
+static void snapshot (void * file, LGL * lgl) {
+  lglwritestats (lgl, file, 0);
+}
+
+// Counts clauses and the maximum variable, which includes auxiliary
+// variables beyond 'maxvar' (see 'lglctrav' in 'lglib.h').
+
 static void lgltravcounter (void * voidptr, int lit) {
-  int * cntptr = voidptr;
-  if (!lit) *cntptr += 1;
+  int * cnt = voidptr;
+  if (!lit) cnt[0]++;
+  else if (abs (lit) > cnt[1]) cnt[1] = abs (lit);
 }
 
 static void lglpushtarget (int target) {
@@ -164,22 +212,23 @@ static int primes[] = {
 static unsigned nprimes = sizeof primes / sizeof *primes;
 
 int main (int argc, char ** argv) {
-  int res, i, j, clout, val, len, lineno, simponly, count, target;
-  const char * iname, * oname, * pname;
-  const char * match, * p, * err, * thanks;
-  FILE * out, * pfile;
-  int maxvar, lit, nopts, simplevel;
+  int res, i, j, clout, val, len, lineno, simponly, cnt[2], target;
+  const char * iname, * oname, * pname, * bname;
+  const char * match, * p, * err, * thanks, * rwname, * wwname, * jname;
+  const char * lname, * cname, * kname;
+  FILE * out, * pfile, * kfile;
+  int maxvar, nopts, simplevel;
   char * tmp;
 #ifndef NLGLDRUPLIG
   const char * tname = 0;
   FILE * tfile = 0;
 #endif
   LGL * lgl;
-  OBuf obuf;
   lineno = 1;
   out = 0;
   res = clout = simponly = simplevel = 0;
-  iname = oname = pname = thanks = 0;
+  iname = oname = pname = bname = thanks = rwname = wwname = jname = 0;
+  lname = cname = kname = 0;
   lgl4sigh = lgl = lglinit ();
   setsighandlers ();
   for (i = 1; i < argc; i++) {
@@ -196,6 +245,7 @@ int main (int argc, char ** argv) {
       printf ("-t <trace>       set proof trace output file (enable tracing)\n");
 #endif
       printf ("-p <options>     read options from file\n");
+      printf ("-b <output>      convert input to binary CNF and exit\n");
       printf ("\n");
       printf ("-T <seconds>     set time limit\n");
       printf ("\n");
@@ -223,6 +273,17 @@ int main (int argc, char ** argv) {
       printf ("--thanks=<whom>  alternative way of specifying the seed\n");
       printf ("                 (inspired by Vampire)\n");
       printf ("\n");
+      printf ("--read-warm=<file>   read phases, variable order and learned\n");
+      printf ("                     clauses of a previous run after parsing\n");
+      printf ("--write-warm=<file>  write them after solving\n");
+      printf ("\n");
+      printf ("--json=<file>        write statistics as JSON lines, every\n");
+      printf ("                     'statsint' conflicts and at the end\n");
+      printf ("--timeline=<file>    write Chrome trace timeline of phases\n");
+      printf ("--conflict-log=<file> write binary conflict log\n");
+      printf ("                     (decode with 'lglunclog')\n");
+      printf ("--classifier=<file>  select option preset from features\n");
+      printf ("\n");
       printf (
 "The following options can also be used in the form '--<name>=<int>',\n"
 "just '--<name>' for increment and '--no-<name>' for zero.  They\n"
@@ -287,6 +348,21 @@ int main (int argc, char ** argv) {
 	goto DONE;
       }
       pname = argv[i];
+    } else if (!strcmp (argv[i], "-b")) {
+      if (++i == argc) {
+	fprintf (stderr, "*** lingeling error: argument to '-b' missing\n");
+	res = 1;
+	goto DONE;
+      } 
+      if (bname) {
+	fprintf (stderr, 
+	         "*** lingeling error: "
+		 "multiple binary CNF files '%s' and '%s'\n",
+		 bname, argv[i]);
+	res = 1;
+	goto DONE;
+      }
+      bname = argv[i];
 #ifndef NLGLDRUPLIG
     } else if (!strcmp (argv[i], "-t")) {
       if (++i == argc) {
@@ -392,6 +468,24 @@ int main (int argc, char ** argv) {
 	  } else if (!strncmp (argv[i], "--thanks=", len)) {
 	    thanks = match + 1;
 	    continue;
+	  } else if (!strncmp (argv[i], "--read-warm=", len)) {
+	    rwname = match + 1;
+	    continue;
+	  } else if (!strncmp (argv[i], "--write-warm=", len)) {
+	    wwname = match + 1;
+	    continue;
+	  } else if (!strncmp (argv[i], "--json=", len)) {
+	    jname = match + 1;
+	    continue;
+	  } else if (!strncmp (argv[i], "--timeline=", len)) {
+	    lname = match + 1;
+	    continue;
+	  } else if (!strncmp (argv[i], "--conflict-log=", len)) {
+	    cname = match + 1;
+	    continue;
+	  } else if (!strncmp (argv[i], "--classifier=", len)) {
+	    kname = match + 1;
+	    continue;
 	  } else if (!isdigit ((int)*p)) {
 ERR:
             fprintf (stderr,
@@ -494,6 +588,54 @@ ERR:
       printf ("c read and set %d options\nc\n", nopts), fflush (stdout);
     fclose (pfile);
   }
+  if (timelimit >= 0) {
+    if (verbose >= 0) {
+      printf ("c\nc setting time limit of %d seconds\n", timelimit);
+      fflush (stdout);
+    }
+    lglseterm (lgl, checkalarm, &caughtalarm);
+    sig_alrm_handler = signal (SIGALRM, catchalrm);
+    alarm (timelimit);
+  }
+  if (jname) {
+    if (!(jsonfile = fopen (jname, "w"))) {
+      fprintf (stderr,
+        "*** lingeling error: can not write statistics file %s\n", jname);
+      res = 1;
+      goto DONE;
+    }
+    lglsetstatsnap (lgl, snapshot, jsonfile);
+  }
+  if (lname) {
+    if (!(timelinefile = fopen (lname, "w"))) {
+      fprintf (stderr,
+        "*** lingeling error: can not write timeline file %s\n", lname);
+      res = 1;
+      goto DONE;
+    }
+    lglsetimeline (lgl, timelinefile);
+  }
+  if (cname) {
+    if (!(clogfile = fopen (cname, "wb"))) {
+      fprintf (stderr,
+        "*** lingeling error: can not write conflict log %s\n", cname);
+      res = 1;
+      goto DONE;
+    }
+    lglsetclog (lgl, clogfile);
+  }
+  if (kname) {
+    if (!(kfile = fopen (kname, "r"))) {
+      fprintf (stderr,
+        "*** lingeling error: can not read classifier %s\n", kname);
+      res = 1;
+      goto DONE;
+    }
+    if (lglreadclassifier (lgl, kfile) < 0) res = 1;
+    fclose (kfile);
+    if (res) goto DONE;
+  }
+  lglsetquery (lgl, query, lgl);
   if (!iname) {
     iname = "<stdin>";
     err = lglparsefile (lgl, stdin, force, &lineno, &maxvar);
@@ -503,19 +645,57 @@ ERR:
     res = 1;
     goto DONE;
   }
-  if (verbose >= 1) {
-    printf ("c\n");
-    if (verbose >= 2) printf ("c final options:\nc\n");
-    lglopts (lgl, "c ", 0);
+  if (queries) {
+    res = lastqueryres;
+    if (timelimit >= 0) {
+      caughtalarm = 0;
+      (void) signal (SIGALRM, sig_alrm_handler);
+    }
+    if (verbose >= 0) fputs ("c\n", stdout), lglstats (lgl);
+    if (jsonfile) lglwritestats (lgl, jsonfile, 0);
+    goto DONE;
   }
-  if (timelimit >= 0) {
+  if (bname) {
+    if (!strcmp (bname, "-")) out = stdout, bname = "<stdout>", clout = 0;
+    else if (!(out = writefile (bname, &clout))) { res = 1; goto DONE; }
     if (verbose >= 0) {
-      printf ("c\nc setting time limit of %d seconds\n", timelimit);
+      printf ("c writing binary CNF to '%s'\n", bname);
       fflush (stdout);
     }
-    lglseterm (lgl, checkalarm, &caughtalarm);
-    sig_alrm_handler = signal (SIGALRM, catchalrm);
-    alarm (timelimit);
+    lglsetopt (lgl, "bincnf", 1);
+    lglprintall (lgl, out);
+    closefile (out, clout);
+    if (verbose >= 0) {
+      printf ("c converted '%s' to '%s' in %.2f seconds\n",
+              iname, bname, lglsec (lgl));
+      fflush (stdout);
+    }
+    goto DONE;
+  }
+  if (rwname) {
+    if (!(pfile = fopen (rwname, "r"))) {
+      fprintf (stderr,
+        "*** lingeling error: can not read warm start file %s\n", rwname);
+      res = 1;
+      goto DONE;
+    }
+    if (verbose >= 0) {
+      printf ("c reading warm start file %s\n", rwname);
+      fflush (stdout);
+    }
+    if (!lglreadwarm (lgl, pfile)) {
+      fprintf (stderr,
+        "*** lingeling error: invalid warm start file %s\n", rwname);
+      fclose (pfile);
+      res = 1;
+      goto DONE;
+    }
+    fclose (pfile);
+  }
+  if (verbose >= 1) {
+    printf ("c\n");
+    if (verbose >= 2) printf ("c final options:\nc\n");
+    lglopts (lgl, "c ", 0);
   }
   for (i = 0; i < ntargets; i++) lglassume (lgl, targets[i]);
   if (simplevel > 0) {
@@ -535,15 +715,26 @@ ERR:
     caughtalarm = 0;
     (void) signal (SIGALRM, sig_alrm_handler);
   }
+  if (wwname && (out = writefile (wwname, &clout))) {
+    if (verbose >= 0) {
+      printf ("c\nc writing warm start file %s\n", wwname);
+      fflush (stdout);
+    }
+    if (!lglwritewarm (lgl, out))
+      fprintf (stderr,
+        "*** lingeling error: writing warm start file %s failed\n",
+	wwname);
+    closefile (out, clout);
+  }
   if (oname) {
     double start = lglsec (lgl), delta;
     if (!strcmp (oname, "-")) out = stdout, oname = "<stdout>", clout = 0;
     else if (!(out = writefile (oname, &clout))) { res = 1; goto DONE; }
     if (verbose >= 0) {
-      count = 0;
-      lglctrav (lgl, &count, lgltravcounter);
+      cnt[0] = 0, cnt[1] = maxvar;
+      lglctrav (lgl, cnt, lgltravcounter);
       printf ("c\nc writing 'p cnf %d %d' to '%s'\n",
-	      maxvar, count, oname);
+	      cnt[1], cnt[0], oname);
       fflush (stdout);
     }
     lglprint (lgl, out);
@@ -557,30 +748,24 @@ ERR:
   }
   if (!simponly || verbose >= 0) {
     if (simponly) fputs ("c ", stdout);
-    if (res == 10) fputs ("s SATISFIABLE\n", stdout);
-    else if (res == 20) fputs ("s UNSATISFIABLE\n", stdout);
-    else fputs ("c s UNKNOWN\n", stdout);
+    printstatus (res);
     if (thanks) printf ("c\nc Thanks to %s!\nc\n", thanks);
     fflush (stdout);
-    if (res == 10 && lglgetopt (lgl, "witness")) {
-      obuf.pos = 0;
-      for (i = 1; i <= maxvar; i++) {
-	lit = (lglderef (lgl, i) > 0) ? i : -i;
-	print2obuf (&obuf, lit, simponly, stdout);
-      }
-      print2obuf (&obuf, 0, simponly, stdout);
-      if (obuf.pos > 0) flushobuf (&obuf, simponly, stdout);
-      fflush (stdout);
-    }
+    if (res == 10 && lglgetopt (lgl, "witness"))
+      printwitness (lgl, maxvar, simponly);
   }
   if (verbose >= 0) fputs ("c\n", stdout), lglstats (lgl);
+  if (jsonfile) lglwritestats (lgl, jsonfile, 0);
 DONE:
+  if (jsonfile) fclose (jsonfile);
 #ifndef NLGLDRUPLIG
   if (tfile) fclose (tfile);
 #endif
   resetsighandlers ();
   lgl4sigh = 0;
   lglrelease (lgl);
+  if (timelinefile) fputs ("\n]\n", timelinefile), fclose (timelinefile);
+  if (clogfile) fclose (clogfile);
   free (targets);
   if (verbose > 0) printf ("c exit %d\n", res);
   fflush (stdout);
@@ -178,6 +178,10 @@ static void * opts (Data * data, unsigned r) {
       lglsetopt (data->lgl, name, val);
     }
   }
+  if (!pick (&rng, 0, 3)) {
+    lglsetopt (data->lgl, "lazyext", 1);
+    lglsetopt (data->lgl, "lazyextchk", 1);
+  }
 #ifndef NLGLDRUPLIG
   if (!pick (&rng, 0, 3)) {
     lglsetopt (data->lgl, "druplig", 1);
@@ -252,6 +256,70 @@ static void * lkhd (Data * data, unsigned r) {
   return sat;
 }
 
+static void chksnapshot (LGL * lgl, int res) {
+  FILE * file;
+  LGL * restored;
+  int idx;
+  if (lglgetopt (lgl, "druplig")) return;
+  if (!(file = tmpfile ())) return;
+  if (lglsnapshot (lgl, file)) {
+    rewind (file);
+    restored = lglrestore (file);
+    assert (restored);
+    assert (lglmaxvar (restored) == lglmaxvar (lgl));
+    assert (lglinconsistent (restored) == lglinconsistent (lgl));
+    if (res == 10)
+      for (idx = 1; idx <= lglmaxvar (lgl); idx++)
+	assert (lglderef (restored, idx) == lglderef (lgl, idx));
+    lglrelease (restored);
+  }
+  fclose (file);
+}
+
+static void chkwarm (LGL * lgl) {
+  FILE * file;
+  int ok;
+  if (lglgetopt (lgl, "druplig")) return;
+  if (!(file = tmpfile ())) return;
+  ok = lglwritewarm (lgl, file);
+  assert (ok);
+  rewind (file);
+  ok = lglreadwarm (lgl, file);
+  assert (ok);
+  fclose (file);
+}
+
+static void countstat (void * ptr, const char * name, double val) {
+  (void) val;
+  assert (strchr (name, '.'));
+  *(int *) ptr += 1;
+}
+
+static void summem (void * ptr, const char * name,
+                    size_t current, size_t max) {
+  (void) name;
+  assert (current <= max);
+  *(size_t *) ptr += current;
+}
+
+static void snapstats (void * ptr, LGL * lgl) {
+  size_t bytes = 0;
+  int count = 0;
+  (void) ptr;
+  lglstrav (lgl, &count, countstat);
+  assert (count > 0);
+  lglmemtrav (lgl, &bytes, summem);
+  assert (bytes == lglbytes (lgl));
+}
+
+static void chkstats (LGL * lgl, int csv) {
+  FILE * file;
+  if (!(file = tmpfile ())) return;
+  lglwritestats (lgl, file, csv);
+  assert (ftell (file) > 0);
+  fclose (file);
+}
+
 static void * sat (Data * data, unsigned r) {
   int res, freeze, i, pos, delta, lit, * assumed, nassumed, szassumed;
   LGL * lgl = data->lgl;
@@ -259,6 +327,8 @@ static void * sat (Data * data, unsigned r) {
   RNG rng;
   rng = initrng (r);
   if (!pick (&rng, 0, 500)) lglchkclone (lgl);
+  if (!pick (&rng, 0, 50)) chkwarm (lgl);
+  if (!pick (&rng, 0, 50)) lglsetstatsnap (lgl, snapstats, 0);
   freeze = pick (&rng, 0, 10);
   if (freeze) {
     if (data->navailable > 1) {
@@ -308,10 +378,11 @@ static void * sat (Data * data, unsigned r) {
       pos = pick (&rng, 0, data->navailable - 1);
       lit = data->available[pos];
       if (pick (&rng, 0, 1)) lit = -lit;
-      lglassume (lgl, lit);
       assert (nassumed < szassumed);
       assumed[nassumed++] = lit;
     } while (!pick (&rng, 0, 10));
+    if (pick (&rng, 0, 1)) lglassumeall (lgl, assumed, nassumed);
+    else for (i = 0; i < nassumed; i++) lglassume (lgl, assumed[i]);
   } else assumed = 0, nassumed = szassumed = 0;
   if (!pick (&rng, 0, 4)) {
     pos = pick (&rng, 0, data->navailable - 1);
@@ -326,16 +397,30 @@ static void * sat (Data * data, unsigned r) {
   if (pick (&rng, 0, 20)) res = lglsat (lgl);
   else res = lglsimp (lgl, pick (&rng, 0, 10));
   assert (!res || res == 10 || res == 20);
+  if (!pick (&rng, 0, 50)) chksnapshot (lgl, res);
+  if (!pick (&rng, 0, 50)) chkstats (lgl, pick (&rng, 0, 1));
   if (res == 10) {
     if (data->print) printf ("sat ");
     if (!pick (&rng, 0, 4)) lglinconsistent (lgl);
     if (!pick (&rng, 0, 20)) lglsetphases (lgl);
+    if (!pick (&rng, 0, 3)) {
+      int * vars, nvars = pick (&rng, 0, 10);
+      vars = malloc ((nvars + 1) * sizeof *vars);
+      for (i = 0; i < nvars; i++) vars[i] = pick (&rng, 1, 2*data->m);
+      lglextendvars (lgl, vars, nvars);
+      free (vars);
+    }
     i = pick (&rng, 0, data->m);
     while (i--) {
       lit = pick (&rng, 1, 2*data->m);
       if (pick (&rng, 0, 1)) lit = -lit;
       lglderef (lgl, lit);
     }
+    if (!pick (&rng, 0, 4)) {
+      signed char * model = malloc (2*data->m + 1);
+      lglgetmodel (lgl, model, pick (&rng, 0, 2*data->m));
+      free (model);
+    }
     if (!pick (&rng, 0, 30)) lglsetphases (lgl);
     if (freeze) {
       assert (data->nfrozen <= data->navailable);
@@ -383,6 +468,11 @@ static void * sat (Data * data, unsigned r) {
       i = pick (&rng, 0, 3*nassumed/2);
       while (i-- > 0)
 	(void) lglfailed (data->lgl, assumed [ pick (&rng, 0, nassumed-1)]);
+      if (!pick (&rng, 0, 2)) {
+	int * failed = malloc (nassumed * sizeof *failed);
+	(void) lglgetfailed (data->lgl, failed, pick (&rng, 0, nassumed));
+	free (failed);
+      }
     }
     if (!pick (&rng, 0, 4)) lglinconsistent (lgl);
   } else if (data->print) printf ("nil ");
@@ -0,0 +1,156 @@
+/*-------------------------------------------------------------------------*/
+/* Copyright 2010-2020 Armin Biere Johannes Kepler University Linz Austria */
+/*-------------------------------------------------------------------------*/
+
+#include "lglib.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------*/
+// Micro benchmarks of the propagation, analysis and reduce kernels on
+// random states with controlled clause size, watch list length and glue
+// distribution.  Needs the library compiled with '-DLGLMICRO' (see the
+// 'lglmicro' target in the makefile).
+
+double lglmicro (LGL *, const char * kernel,
+                 int learned, int size, int glue,
+		 int64_t rounds, int64_t * countptr);
+
+static int vars = 100000, len = 3, occs = 6, learned = 100000;
+static int size = 8, glue = 8, rounds = 100, reductions = 10;
+static unsigned rng = 1;
+
+static const char * kernels[] = { "propsearch", "prop", "ana", "reduce" };
+static const char * units[] = { "visit", "visit", "conflict", "clause" };
+
+#define NKERNELS ((int)(sizeof kernels / sizeof *kernels))
+
+static void die (const char * fmt, ...) {
+  va_list ap;
+  fputs ("*** lglmicro: ", stderr);
+  va_start (ap, fmt);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  fflush (stderr);
+  exit (1);
+}
+
+static void msg (const char * fmt, ...) {
+  va_list ap;
+  fputs ("c [lglmicro] ", stdout);
+  va_start (ap, fmt);
+  vprintf (fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+static unsigned next (void) {
+  rng *= 1664525u;
+  rng += 1013904223u;
+  return rng;
+}
+
+static int pick (int n) { return (next () >> 8) % n; }
+
+// Every literal occurs in about 'occs' clauses of size 'len', which
+// determines the length of the watch lists.
+
+static LGL * build (unsigned seed) {
+  int clauses, i, j, k, * c;
+  LGL * lgl;
+  if (!(c = malloc (len * sizeof *c))) die ("out of memory");
+  lgl = lglinit ();
+  lglsetopt (lgl, "verbose", -1);
+  lglsetopt (lgl, "seed", (int) seed);
+  rng = seed;
+  clauses = (int) ((2.0 * vars * occs) / len);
+  for (i = 0; i < clauses; i++) {
+    for (j = 0; j < len; j++) {
+      c[j] = 1 + pick (vars);
+      for (k = 0; k < j; k++) if (c[k] == c[j]) break;
+      if (k < j) { j--; continue; }
+      lgladd (lgl, (next () & (1u << 20)) ? -c[j] : c[j]);
+    }
+    lgladd (lgl, 0);
+  }
+  free (c);
+  return lgl;
+}
+
+static int isnum (const char * str) {
+  const char * p = str;
+  if (!*p) return 0;
+  while (*p) if (*p < '0' || *p++ > '9') return 0;
+  return 1;
+}
+
+static int intarg (int argc, char ** argv, int * iptr) {
+  if (*iptr + 1 >= argc || !isnum (argv[*iptr + 1]))
+    die ("argument to '%s' missing or invalid", argv[*iptr]);
+  return atoi (argv[++*iptr]);
+}
+
+int main (int argc, char ** argv) {
+  const char * only = 0;
+  unsigned seed = rng;
+  double seconds;
+  int64_t count;
+  LGL * lgl;
+  int i, k;
+  for (i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h")) {
+      printf (
+"usage: lglmicro [-h][-k <kernel>][-v <vars>][-l <len>][-o <occs>]"
+"[-L <learned>]\n"
+"                [-s <size>][-g <glue>][-r <rounds>][-R <reductions>]"
+"[-S <seed>]\n"
+"\n"
+"kernels: propsearch prop ana reduce (default all)\n");
+      exit (0);
+    } else if (!strcmp (argv[i], "-k")) {
+      if (++i == argc) die ("argument to '-k' missing");
+      only = argv[i];
+    } else if (!strcmp (argv[i], "-v")) vars = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-l")) len = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-o")) occs = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-L")) learned = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-s")) size = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-g")) glue = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-r")) rounds = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-R")) reductions = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-S")) seed = intarg (argc, argv, &i);
+    else die ("invalid command line option '%s' (try '-h')", argv[i]);
+  }
+  if (vars < len) die ("expected at least as many variables as '-l'");
+  if (len < 2) die ("expected clause length of at least 2");
+  if (size < 4) die ("expected learned clause size of at least 4");
+  if (glue < 1) die ("expected positive glue");
+  if (only) {
+    for (k = 0; k < NKERNELS; k++) if (!strcmp (only, kernels[k])) break;
+    if (k == NKERNELS) die ("invalid kernel '%s' (try '-h')", only);
+  }
+  msg ("%d variables, clause length %d, %d occurrences per literal",
+       vars, len, occs);
+  msg ("%d learned clauses of size %d with glue up to %d",
+       learned, size, glue);
+  msg ("%d rounds, %d reductions", rounds, reductions);
+  msg ("%-10s %12s %-8s %10s %10s",
+       "kernel", "count", "unit", "seconds", "ns/unit");
+  for (k = 0; k < NKERNELS; k++) {
+    if (only && strcmp (only, kernels[k])) continue;
+    lgl = build (seed);
+    seconds = lglmicro (lgl, kernels[k], learned, size, glue,
+                        strcmp (kernels[k], "reduce") ? rounds : reductions,
+			&count);
+    msg ("%-10s %12lld %-8s %10.3f %10.1f",
+         kernels[k], (long long) count, units[k], seconds,
+	 count ? 1e9 * seconds / count : 0.0);
+    lglrelease (lgl);
+  }
+  return 0;
+}
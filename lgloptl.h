@@ -9,6 +9,8 @@ OPT(bcaddlimldscale,2,-7,7,"bca added clause limit ld scale");
 OPT(bcamaxeff,10*M,0,I,"BCA maximum number of steps");
 OPT(bcaminuse,100,0,I,"min number of literals required to be usable");
 OPT(bcawait,2,0,2,"wait for BCE (1) and/or BVE (2)");
+OPT(bincnf,0,0,1,"print binary CNF in 'lglprint' and 'lglprintall'");
+OPT(bincnfblk,1<<16,1,I,"clauses per block in binary CNF");
 OPT(bkwdocclim,100,0,I,"backward occurrence limit");
 OPT(bkwdresched,1,0,1,"reschedule variables during backward");
 OPT(bkwdroundlim,7,1,I,"bkwd round limit");
@@ -33,6 +35,12 @@ OPT(blockwait,1,0,1,"wait for BVE");
 OPT(boost,1,0,1,"enable boosting of preprocessors");
 OPT(bumpreasonlits,1,0,1,"bump reason literals too");
 OPT(bumpsimp,0,0,1,"bump during simplification too");
+OPT(bva,1,0,1,"bounded variable addition (BVA)");
+OPT(bvamaxeff,20*M,-1,I,"max effort in BVA (-1=unlimited)");
+OPT(bvamineff,2*M,0,I,"min effort in BVA");
+OPT(bvaproject,10,0,I,"max growth projecting out BVA variables");
+OPT(bvareleff,20,0,10*K,"rel effort in BVA");
+OPT(bvawait,2,0,2,"wait for BCE (1) and/or BVE (2)");
 OPT(card,1,0,1,"cardinality constraint reasoning");
 OPT(cardcut,2,0,2,"1=gomoroy-cuts,2=strengthen");
 OPT(cardexpam1,3,2,I,"min length of exported at-most-one constraint");
@@ -48,7 +56,8 @@ OPT(cardreleff,5,0,10*K,"rel effort for cardinality reasoning");
 OPT(cardreschedint,10,1,I,"reschedule variable for card reasoning");
 OPT(carduse,2,0,3,"use clauses (1=oneside,2=bothsidetoo,3=anyside)");
 OPT(cardwait,0,0,2,"wait for BCE (1) and/or BVE (2)");
-OPT(classify,2,0,3,"classifier for parameter setting");
+OPT(classify,2,0,3,"SC14 classifier (not with 'presetclassify')");
+OPT(clog,1,0,1,"write conflict log (if set with 'lglsetclog')");
 OPT(cce2wait,1,0,I,"wait for ATE to finish before doing ABCE");
 OPT(cce,3,0,3,"covered clause elimination (1=ate,2=abce,3=acce)");
 OPT(cce3wait,2,0,I,"wait for ABCE to finish before doing ACCE");
@@ -91,12 +100,16 @@ OPT(elmboostint,5,1,I,"elimination boost interval");
 OPT(elmboostvlim,4*M,1,I,"elimination boost var lim");
 OPT(elmclslim,1*M,3,I,"max antecendent size in elimination");
 OPT(elmfull,0,0,1,"no elimination limits");
+OPT(elmgate,1,0,1,"gate detection in BVE");
+OPT(elmgatexor,5,0,7,"max clause size of XOR gates in BVE");
 OPT(elmineff,20*M,0,I,"min effort in BVE");
 OPT(elmlitslim,200,0,I,"one side literals limit for elimination");
 OPT(elmocclim1,1000,1,I,"one-sided max occ of BVE");
 OPT(elmocclim,1*M,3,I,"max occurrences in BVE");
 OPT(elmocclim2,100,2,I,"two-sided max occ of BVE");
 OPT(elmoccsumforced,0,0,10,"forced occurrence sum");
+OPT(elmpar,0,0,64,"parallel BVE worker threads (0=sequential)");
+OPT(elmparbatch,1000,1,I,"parallel BVE candidates per batch");
 OPT(elmreleff,200,0,10*K,"rel effort in BVE");
 OPT(elmresched,0,0,7,"reschedule variables (1=else,2=boost,4=full)");
 OPT(elmroundlim,3,1,I,"variable elimination rounds limit");
@@ -142,6 +155,8 @@ OPT(jlevelmacdsmooth,10,0,32,"e for avg EMA with alpha=2^-e");
 OPT(jwhred,1,0,2,"JWH score based on redundant clauses too (2=only)");
 OPT(keepmaxglue,1,0,1,"keep maximum glue clauses");
 OPT(keepmaxglueint,1,1,I,"keep maximum glue clause interval (1 always)");
+OPT(lazyext,0,0,1,"extend model on demand or partially ('lglextendvars')");
+OPT(lazyextchk,0,0,1,"check partial against full model extension");
 OPT(lhbr,1,0,1, "enable lazy hyber binary reasoning");
 OPT(lkhd,2,-1,4, "-1=LOCS,0=LIS,1=JWH,2=TREELOOK,3=LENSUM,4=RELEVANCE");
 OPT(locs,0,-1,I,"use local search (-1=always otherwise how often)");
@@ -169,6 +184,7 @@ OPT(minrecsizelim,1000,0,I,"size limit for using recursive minimization");
 OPT(move,2,0,2,"move redundant cls (1=only-binary,2=ternary-too)");
 OPT(otfs,0,0,1,"enable on-the-fly subsumption");
 OPT(penmax,4,0,16,"maximum penalty");
+OPT(perf,0,0,1,"hardware performance counters per phase (Linux)");
 OPT(phase,0,-1,1,"default initial phase (-1=neg,0=JeroslowWang,1=pos)");
 OPT(phaseluckfactor,200,100,10*K,"min phase luck factor (pos/neg)");
 OPT(phaselucklim,100,0,1000,"phase luck limit in promille");
@@ -191,6 +207,7 @@ OPT(prbsimplemaxeff,200*M,-1,I,"max effort in simple probing");
 OPT(prbsimplemineff,2*M,0,I,"min effort in simple probing");
 OPT(prbsimplereleff,40,0,10*K,"rel effort in simple probing");
 OPT(prbsimplertc,0,0,1,"run simple probing until completion");
+OPT(presetclassify,1,0,1,"select preset with classifier read from file");
 OPT(probe,1,0,1,"enable probing");
 OPT(profile,1,0,4,"profile level");
 OPT(profilelong,0,0,1,"print long profile information");
@@ -283,11 +300,19 @@ OPT(sizepen,1*M,1,I,"number of clauses size penalty starting point");
 OPT(sleeponabort,0,0,I,"sleep this seconds before abort/exit");
 OPT(smallirr,90,0,100,"max percentage irr lits for BCE and VE");
 OPT(smallve,1,0,1,"enable small number variables elimination");
-OPT(smallvevars,FUNVAR,4,FUNVAR, "variables small variable elimination");
+OPT(smallvevars,12,4,FUNVAR, "variables small variable elimination");
 OPT(smallvewait,0,0,1,"wait with small variable elimination");
 OPT(sortlits,0,0,1,"sort lits of cls during garbage collection");
 OPT(stabema,7,0,32,"e for stability EMA with alpha=2^-e");
+OPT(statsint,100*K,1,I,"conflict interval of statistics snapshot callback");
 OPT(subl,0,0,10*K,"try to subsume this many recent learned clauses");
+OPT(subsume,1,0,1,"backward subsumption and strengthening");
+OPT(subsumebatch,10*K,1,I,"subsumption candidates per batch");
+OPT(subsumemaxeff,5*M,-1,I,"max effort in subsumption");
+OPT(subsumemineff,100*K,0,I,"min effort in subsumption");
+OPT(subsumepar,0,0,64,"subsumption worker threads (0=sequential)");
+OPT(subsumered,1,0,1,"subsume and strengthen kept learned clauses");
+OPT(subsumereleff,20,0,10*K,"rel effort in subsumption");
 OPT(sweep,1,0,1,"enabled SAT sweeping");
 OPT(sweepboost,10,1,1000,"sweeping boost");
 OPT(sweepboostdel,4,0,100,"initial sweeping boost delay");
@@ -306,6 +331,9 @@ OPT(sweepreleff,3,0,10*K,"rel effort in sweeping");
 OPT(sweeprtc,0,0,1,"run sweeping until completion");
 OPT(sweeprtcint,14,1,I,"run sweeping until completion interval");
 OPT(sweeprtcintvlim,100*K,1,I,"run sweeping until completion int var lim");
+OPT(sweepsim,1,0,1,"simulate gates to refine initial sweeping classes");
+OPT(sweepsimgates,50,0,100,"min percentage of variables defined by gates");
+OPT(sweepsimwords,4,1,64,"simulated 64-bit words per variable");
 OPT(sweepsuccessmaxwortc,6,1,I,"sweeping success max wo run-to-completion");
 OPT(sweepsuccessrat,1000,1,I,"sweeping success ratio");
 OPT(sweepwait,2,0,2,"wait for BCE (1) and/or BVE (2)");
@@ -319,9 +347,11 @@ OPT(ternres,1,0,1,"generate ternary resolvents");
 OPT(ternresboost,5,1,100,"initial ternary resolution boost");
 OPT(ternresrtc,0,0,1,"run ternary resolvents until completion");
 OPT(ternreswait,2,0,2,"wait for BCE (1) and/or BVE (2)");
+OPT(timer,0,0,2,"phase timer (0=process,1=monotonic,2=tsc)");
 OPT(tlevelema,12,0,32,"e for EMA with alpha=2^-e");
 OPT(transred,1,0,1,"enable transitive reduction");
 OPT(transredwait,2,0,2,"wait for BCE (1) and/or BVE (2)");
+OPT(trapiasync,0,0,1,"write binary API trace asynchronously");
 OPT(trapiflush,0,0,1,"flush API trace after each call");
 OPT(trdmaxeff,2*M,-1,I,"max effort in transitive reduction");
 OPT(trdmineff,100*K,0,I,"min effort in transitive reduction");
@@ -352,4 +382,6 @@ OPT(usedtwice,1,0,1,"used twice optimization for clause minimization");
 OPT(verbose,0,-1,5,"verbosity level");
 OPT(wait,1,0,1,"enable or disable all waiting");
 OPT(waitmax,4,-1,I,"max simps to wait (-1=nomax)");
+OPT(warmcls,10000,0,I,"max learned clauses in warm start files");
+OPT(warmglue,4,2,I,"max glue of learned clauses in warm start files");
 OPT(witness,1,0,1,"print witness");
@@ -0,0 +1,208 @@
+#include "lgltrapi.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------*/
+
+const unsigned char ltrmagic[4] = { 0x8d, 'L', 'T', 'R' };
+
+static const char * ltrcmdnames[] = {
+#define LTRCMD(NAME,SIG) # NAME,
+LTRCMDS
+#undef LTRCMD
+};
+
+static const char ltrcmdsigs[] = {
+#define LTRCMD(NAME,SIG) SIG,
+LTRCMDS
+#undef LTRCMD
+};
+
+const char * ltrcmd2str (int cmd) {
+  if (cmd < 0 || cmd >= LTR_NCMDS) return "<invalid>";
+  return ltrcmdnames[cmd];
+}
+
+int ltrcmdsig (int cmd) {
+  if (cmd < 0 || cmd >= LTR_NCMDS) return 0;
+  return ltrcmdsigs[cmd];
+}
+
+int ltrstr2cmd (const char * str) {
+  int cmd;
+  for (cmd = 0; cmd < LTR_NCMDS; cmd++)
+    if (!strcmp (ltrcmdnames[cmd], str)) return cmd;
+  return -1;
+}
+
+/*------------------------------------------------------------------------*/
+
+#define LTRMAXLINE 128
+
+struct LTR {
+  FILE * file;
+  int binary, lineno;
+  char line[LTRMAXLINE];
+  char * opt;
+  size_t szopt;
+  char err[LTRMAXLINE + 80];
+};
+
+static int ltrgetu (LTR *, unsigned *);
+
+LTR * ltrinit (FILE * file) {
+  LTR * res = malloc (sizeof *res);
+  unsigned version;
+  int ch, i;
+  if (!res) return res;
+  memset (res, 0, sizeof *res);
+  res->file = file;
+  ch = getc (file);
+  if (ch == ltrmagic[0]) {
+    res->binary = 1;
+    for (i = 1; i < (int) sizeof ltrmagic; i++)
+      if (getc (file) != ltrmagic[i]) {
+	sprintf (res->err, "invalid binary trace magic number");
+	return res;
+      }
+    if (!ltrgetu (res, &version))
+      sprintf (res->err, "binary trace version missing");
+    else if (version != LTRVERSION)
+      sprintf (res->err, "unsupported binary trace version %u", version);
+  } else if (ch != EOF) ungetc (ch, file);
+  res->lineno = 1;
+  return res;
+}
+
+void ltrelease (LTR * ltr) {
+  free (ltr->opt);
+  free (ltr);
+}
+
+const char * ltrerr (LTR * ltr) { return ltr->err[0] ? ltr->err : 0; }
+
+int ltrbinary (LTR * ltr) { return ltr->binary; }
+
+int ltrlineno (LTR * ltr) { return ltr->lineno; }
+
+static int ltrperr (LTR * ltr, const char * fmt, ...) {
+  va_list ap;
+  va_start (ap, fmt);
+  vsnprintf (ltr->err, sizeof ltr->err, fmt, ap);
+  va_end (ap);
+  return -1;
+}
+
+/*------------------------------------------------------------------------*/
+
+static int ltrgetu (LTR * ltr, unsigned * uptr) {
+  unsigned res = 0, shift = 0;
+  int ch;
+  do {
+    if (shift > 28) return 0;
+    if ((ch = getc (ltr->file)) == EOF) return 0;
+    res |= (ch & 0x7fu) << shift;
+    shift += 7;
+  } while (ch & 0x80);
+  *uptr = res;
+  return 1;
+}
+
+static int ltrgeti (LTR * ltr, int * iptr) {
+  unsigned u;
+  if (!ltrgetu (ltr, &u)) return 0;
+  *iptr = (u & 1) ? (int) ~(u >> 1) : (int) (u >> 1);
+  return 1;
+}
+
+static int ltrnextbinary (LTR * ltr,
+                          int * cmdptr, int * argptr, const char ** optptr) {
+  unsigned len;
+  int ch, sig;
+  if ((ch = getc (ltr->file)) == EOF) return 0;
+  if (ch >= LTR_NCMDS)
+    return ltrperr (ltr, "invalid opcode %d", ch);
+  sig = ltrcmdsig (ch);
+  *cmdptr = ch;
+  *argptr = 0;
+  *optptr = 0;
+  if (sig == 'O') {
+    if (!ltrgetu (ltr, &len) || len >= LTRMAXLINE)
+      return ltrperr (ltr, "invalid option name");
+    if (ltr->szopt <= len) {
+      ltr->szopt = len + 1;
+      ltr->opt = realloc (ltr->opt, ltr->szopt);
+    }
+    if (fread (ltr->opt, 1, len, ltr->file) != len)
+      return ltrperr (ltr, "truncated option name");
+    ltr->opt[len] = 0;
+    *optptr = ltr->opt;
+  }
+  if (sig != 'N' && !ltrgeti (ltr, argptr))
+    return ltrperr (ltr, "truncated argument of '%s'", ltrcmd2str (ch));
+  ltr->lineno++;
+  return 1;
+}
+
+/*------------------------------------------------------------------------*/
+
+static int ltrisnumstr (const char * str) {
+  const char * p;
+  int ch;
+  if (*(p = str) == '-') p++;
+  if (!isdigit ((int)*p++)) return 0;
+  while (isdigit (ch = *p)) p++;
+  return !ch;
+}
+
+static int ltrnextext (LTR * ltr,
+                       int * cmdptr, int * argptr, const char ** optptr) {
+  char * tok, * arg, * opt, * save;
+  int ch, len = 0, cmd, sig;
+  for (;;) {
+    ch = getc (ltr->file);
+    if (ch == EOF) {
+      if (!len) return 0;
+      return ltrperr (ltr, "new line missing");
+    }
+    if (ch == '\r') continue;
+    if (ch == '\n') break;
+    if (len + 1 >= LTRMAXLINE)
+      return ltrperr (ltr, "line buffer exceeded");
+    ltr->line[len++] = ch;
+  }
+  ltr->line[len] = 0;
+  if (!(tok = strtok_r (ltr->line, " ", &save)))
+    return ltrperr (ltr, "empty line");
+  if ((cmd = ltrstr2cmd (tok)) < 0)
+    return ltrperr (ltr, "invalid command '%s'", tok);
+  sig = ltrcmdsig (cmd);
+  *cmdptr = cmd;
+  *argptr = 0;
+  *optptr = 0;
+  if (sig == 'O') {
+    if (!(opt = strtok_r (0, " ", &save)))
+      return ltrperr (ltr, "option name missing");
+    *optptr = opt;
+  }
+  if (sig != 'N') {
+    if (!(arg = strtok_r (0, " ", &save)) || !ltrisnumstr (arg))
+      return ltrperr (ltr, "expected integer argument for '%s'", tok);
+    *argptr = atoi (arg);
+  }
+  if (strtok_r (0, " ", &save))
+    return ltrperr (ltr, "argument after '%s'", tok);
+  ltr->lineno++;
+  return 1;
+}
+
+int ltrnext (LTR * ltr, int * cmdptr, int * argptr, const char ** optptr) {
+  if (ltr->err[0]) return -1;
+  if (ltr->binary) return ltrnextbinary (ltr, cmdptr, argptr, optptr);
+  return ltrnextext (ltr, cmdptr, argptr, optptr);
+}
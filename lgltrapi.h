@@ -0,0 +1,91 @@
+#ifndef lgltrapi_h_INCLUDED
+#define lgltrapi_h_INCLUDED
+
+#include <stdio.h>
+
+/*------------------------------------------------------------------------*/
+// API trace commands with their argument signature: 'N' for no argument,
+// 'I' for one integer argument and 'O' for an option name and its value.
+// The order of this list determines the binary opcodes and thus new
+// commands should only be added at the end.
+
+#define LTRCMDS \
+LTRCMD(init,'N') \
+LTRCMD(option,'O') \
+LTRCMD(chkclone,'N') \
+LTRCMD(add,'I') \
+LTRCMD(setphase,'I') \
+LTRCMD(resetphase,'I') \
+LTRCMD(setimportant,'I') \
+LTRCMD(assume,'I') \
+LTRCMD(cassume,'I') \
+LTRCMD(fixate,'N') \
+LTRCMD(reduce,'N') \
+LTRCMD(flush,'N') \
+LTRCMD(setphases,'N') \
+LTRCMD(negass,'N') \
+LTRCMD(return,'I') \
+LTRCMD(sat,'N') \
+LTRCMD(lkhd,'N') \
+LTRCMD(changed,'N') \
+LTRCMD(simp,'I') \
+LTRCMD(maxvar,'N') \
+LTRCMD(incvar,'N') \
+LTRCMD(deref,'I') \
+LTRCMD(failed,'I') \
+LTRCMD(inconsistent,'N') \
+LTRCMD(fixed,'I') \
+LTRCMD(repr,'I') \
+LTRCMD(freeze,'I') \
+LTRCMD(frozen,'I') \
+LTRCMD(usable,'I') \
+LTRCMD(reusable,'I') \
+LTRCMD(reuse,'I') \
+LTRCMD(meltall,'N') \
+LTRCMD(melt,'I') \
+LTRCMD(reconstk,'N') \
+LTRCMD(release,'N') \
+LTRCMD(stats,'N')
+
+typedef enum LTRCmd {
+#define LTRCMD(NAME,SIG) LTR_ ## NAME,
+LTRCMDS
+#undef LTRCMD
+  LTR_NCMDS
+} LTRCmd;
+
+/*------------------------------------------------------------------------*/
+// Binary traces start with these four bytes followed by the format version
+// as varint.  Each command is then encoded as opcode byte, followed by its
+// integer argument mapped to unsigned by 'zig-zag' encoding and written as
+// LEB128 varint.  For 'option' the length of the option name as varint
+// and the name itself precede the value.
+
+#define LTRVERSION 1
+
+extern const unsigned char ltrmagic[4];
+
+const char * ltrcmd2str (int cmd);
+int ltrcmdsig (int cmd);
+int ltrstr2cmd (const char * str);
+
+/*------------------------------------------------------------------------*/
+// Reader for both text and binary API traces.  The format is detected from
+// the first byte of the file.
+
+typedef struct LTR LTR;
+
+LTR * ltrinit (FILE * file);
+void ltrelease (LTR *);
+
+// Returns '1' and sets the command, argument and option name (for
+// 'option' only, valid until the next call), '0' at end-of-file and '-1'
+// on error, in which case 'ltrerr' returns the error message.
+
+int ltrnext (LTR *, int * cmdptr, int * argptr, const char ** optptr);
+
+const char * ltrerr (LTR *);
+int ltrbinary (LTR *);
+int ltrlineno (LTR *);		// line number (text) or event (binary)
+
+#endif
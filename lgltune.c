@@ -0,0 +1,530 @@
+/*-------------------------------------------------------------------------*/
+/* Copyright 2010-2020 Armin Biere Johannes Kepler University Linz Austria */
+/*-------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*------------------------------------------------------------------------*/
+// Local parameter tuning of 'lingeling' on a corpus of CNF files.  The
+// parameter configuration space is read from a PCS file as produced by
+// 'lingeling --pcs' (or '--pcs-mixed', '--pcs-reduced'), which by default
+// is taken directly from the solver.  Each round starts from the best
+// configuration found so far (initially the defaults) and generates new
+// candidates by changing a few random parameters.  All candidates are run
+// in parallel on the instances in random order.  In 'race' mode
+// candidates which fall clearly behind the leader are dropped after each
+// stage, while 'random' mode evaluates every candidate on all instances.
+// Configurations are ranked by the number of solved instances and then
+// by PAR2 score (wall clock time, twice the time limit if unsolved).  The
+// best configuration is written as option file for 'lglreadopts', which
+// 'lingeling -p <file>' reads, and only contains non-default values.
+
+static int timelimit = 60, jobs, rounds = 3, ncands = 16, changes = 3;
+static int race = 1, verbose;
+static const char * solver = "./lingeling", * pcsname, * outname;
+static unsigned rng = 1;
+
+static void die (const char * fmt, ...) {
+  va_list ap;
+  fputs ("*** lgltune: ", stderr);
+  va_start (ap, fmt);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  fflush (stderr);
+  exit (1);
+}
+
+static void msg (const char * fmt, ...) {
+  va_list ap;
+  fputs ("c [lgltune] ", stdout);
+  va_start (ap, fmt);
+  vprintf (fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+static double getime (void) {
+  struct timeval tv;
+  double res = 0;
+  if (!gettimeofday (&tv, 0)) res = 1e-6 * tv.tv_usec, res += tv.tv_sec;
+  return res;
+}
+
+static unsigned next (void) {
+  rng *= 1664525u;
+  rng += 1013904223u;
+  return rng;
+}
+
+static int pick (int n) { return (next () >> 8) % n; }
+
+static double uniform (void) { return (next () >> 8) / (double)(1u<<24); }
+
+static void * alloc (size_t bytes) {
+  void * res = calloc (1, bytes ? bytes : 1);
+  if (!res) die ("out of memory");
+  return res;
+}
+
+static char * strclone (const char * str) {
+  return strcpy (alloc (strlen (str) + 1), str);
+}
+
+/*------------------------------------------------------------------------*/
+// Parameters are either categorical '<name> {<v0>,...,<vn>}[<default>]'
+// or integer ranges '<name> [<min>,<max>][<default>]i' with an optional
+// 'l' for sampling on a logarithmic scale.  Everything after '#' is a
+// comment.  Parameters with a single value are skipped.
+
+typedef struct Param {
+  char * name;
+  int dflt, min, max, log, * vals, nvals;
+} Param;
+
+static Param * params;
+static int nparams, szparams;
+
+static void addparam (Param * p) {
+  if (nparams == szparams) {
+    szparams = szparams ? 2*szparams : 256;
+    if (!(params = realloc (params, szparams * sizeof *params)))
+      die ("out of memory");
+  }
+  params[nparams++] = *p;
+}
+
+static void parsepcsline (char * line, const char * path, int lineno) {
+  char * p, * q, * name;
+  int nvals, i;
+  Param param;
+  if ((p = strchr (line, '#'))) *p = 0;
+  p = line;
+  while (*p == ' ' || *p == '\t') p++;
+  if (!*p || *p == '\n') return;
+  name = p;
+  while (*p && *p != ' ' && *p != '\t') p++;
+  if (!*p) die ("%s:%d: expected domain", path, lineno);
+  *p++ = 0;
+  while (*p == ' ' || *p == '\t') p++;
+  memset (&param, 0, sizeof param);
+  if (*p == '{') {
+    for (nvals = 1, q = p; *q && *q != '}'; q++) if (*q == ',') nvals++;
+    if (*q != '}') die ("%s:%d: expected '}'", path, lineno);
+    param.vals = alloc (nvals * sizeof *param.vals);
+    for (i = 0, q = p + 1; i < nvals; i++) {
+      param.vals[i] = strtol (q, &q, 10);
+      if (*q != (i + 1 < nvals ? ',' : '}'))
+	die ("%s:%d: invalid value in set", path, lineno);
+      q++;
+    }
+    param.nvals = nvals;
+    param.min = param.vals[0], param.max = param.vals[nvals - 1];
+  } else if (*p == '[') {
+    param.min = strtol (p + 1, &q, 10);
+    if (*q != ',') die ("%s:%d: expected ','", path, lineno);
+    param.max = strtol (q + 1, &q, 10);
+    if (*q++ != ']') die ("%s:%d: expected ']'", path, lineno);
+    if (param.min > param.max) die ("%s:%d: empty range", path, lineno);
+  } else die ("%s:%d: expected '{' or '['", path, lineno);
+  if (*q != '[') die ("%s:%d: expected default", path, lineno);
+  param.dflt = strtol (q + 1, &q, 10);
+  if (*q != ']') die ("%s:%d: expected ']' after default", path, lineno);
+  param.log = (strchr (q, 'l') != 0);
+  if (param.min == param.max) { free (param.vals); return; }
+  param.name = strclone (name);
+  addparam (&param);
+}
+
+static void parsepcs (FILE * file, const char * path) {
+  char line[1024];
+  int lineno = 0;
+  while (fgets (line, sizeof line, file)) {
+    lineno++;
+    if (!strchr (line, '\n') && !feof (file))
+      die ("%s:%d: line too long", path, lineno);
+    parsepcsline (line, path, lineno);
+  }
+}
+
+static void readpcs (void) {
+  char cmd[1024];
+  FILE * file;
+  if (pcsname) {
+    if (!(file = fopen (pcsname, "r"))) die ("can not read '%s'", pcsname);
+    parsepcs (file, pcsname);
+    fclose (file);
+  } else {
+    if (strlen (solver) > 1000) die ("solver path too long");
+    sprintf (cmd, "%s --pcs", solver);
+    if (!(file = popen (cmd, "r"))) die ("can not run '%s'", cmd);
+    parsepcs (file, cmd);
+    if (pclose (file)) die ("'%s' failed", cmd);
+  }
+  if (!nparams) die ("no parameters to tune");
+}
+
+/*------------------------------------------------------------------------*/
+
+typedef struct Cand {
+  int * vals, alive, wrong, solved, evaluated;
+  double par2;
+} Cand;
+
+static Cand * cands;
+static int * best, * expected;
+
+static char ** instances;
+static int ninstances, szinstances;
+
+static void addinstance (const char * path) {
+  if (access (path, R_OK)) die ("can not read instance '%s'", path);
+  if (ninstances == szinstances) {
+    szinstances = szinstances ? 2*szinstances : 64;
+    if (!(instances = realloc (instances, szinstances * sizeof *instances)))
+      die ("out of memory");
+  }
+  instances[ninstances++] = strclone (path);
+}
+
+static void readlist (const char * path) {
+  char line[1024], * p;
+  FILE * file;
+  if (!(file = fopen (path, "r"))) die ("can not read list '%s'", path);
+  while (fgets (line, sizeof line, file)) {
+    if ((p = strchr (line, '\n'))) *p = 0;
+    if (line[0] && line[0] != '#') addinstance (line);
+  }
+  fclose (file);
+}
+
+static int mutate (Param * p, int val) {
+  double f;
+  int64_t res;
+  int i;
+  if (p->nvals) {
+    for (i = 0; i < p->nvals && p->vals[i] != val; i++)
+      ;
+    if (i < p->nvals && p->nvals > 1)
+      i = (i + 1 + pick (p->nvals - 1)) % p->nvals;
+    else i = pick (p->nvals);
+    return p->vals[i];
+  }
+  if (p->log || (int64_t) p->max - p->min > 1000) {
+    // Scale by a factor between 1/4 and 4 around the current value.
+    f = exp2 (4 * uniform () - 2);
+    res = val > 0 ? (int64_t) (val * f + 0.5) : val - 1 + pick (3);
+    if (res == val) res += (f < 1) ? -1 : 1;
+  } else {
+    i = (int) (((int64_t) p->max - p->min + 3) / 4);
+    res = val - i + pick (2*i + 1);
+  }
+  if (res < p->min) res = p->min;
+  if (res > p->max) res = p->max;
+  return (int) res;
+}
+
+static void newcands (void) {
+  Param * p;
+  Cand * c;
+  int i, j;
+  for (i = 0; i < ncands; i++) {
+    c = cands + i;
+    memcpy (c->vals, best, nparams * sizeof *best);
+    c->alive = 1;
+    c->wrong = c->solved = c->evaluated = 0;
+    c->par2 = 0;
+    if (!i) continue;                   // keep incumbent
+    for (j = 0; j < changes; j++) {
+      p = params + pick (nparams);
+      c->vals[p - params] = mutate (p, c->vals[p - params]);
+    }
+  }
+}
+
+static int better (Cand * a, Cand * b) {
+  if (a->wrong != b->wrong) return !a->wrong;
+  if (a->solved != b->solved) return a->solved > b->solved;
+  return a->par2 < b->par2;
+}
+
+/*------------------------------------------------------------------------*/
+
+typedef struct Job { int cand, inst, pid; double start; } Job;
+
+static pid_t startjob (Job * job) {
+  char tlimbuf[20], ** argv;
+  Cand * c = cands + job->cand;
+  int argc, i;
+  pid_t pid;
+  argv = alloc ((nparams + 6) * sizeof *argv);
+  argc = 0;
+  argv[argc++] = (char *) solver;
+  argv[argc++] = "-n";
+  sprintf (tlimbuf, "%d", timelimit);
+  argv[argc++] = "-T";
+  argv[argc++] = tlimbuf;
+  for (i = 0; i < nparams; i++) {
+    if (c->vals[i] == params[i].dflt) continue;
+    argv[argc] = alloc (strlen (params[i].name) + 16);
+    sprintf (argv[argc++], "--%s=%d", params[i].name, c->vals[i]);
+  }
+  argv[argc++] = instances[job->inst];
+  argv[argc] = 0;
+  if (!(pid = fork ())) {
+    if (!freopen ("/dev/null", "w", stdout)) exit (1);
+    if (!freopen ("/dev/null", "w", stderr)) exit (1);
+    execv (solver, argv);
+    exit (1);
+  }
+  if (pid < 0) die ("can not generate child process");
+  for (i = 4; i < argc - 1; i++) free (argv[i]);
+  free (argv);
+  job->pid = pid;
+  job->start = getime ();
+  return pid;
+}
+
+static void finishjob (Job * job, int status) {
+  Cand * c = cands + job->cand;
+  double wall = getime () - job->start;
+  int res = WIFEXITED (status) ? WEXITSTATUS (status) : -1;
+  c->evaluated++;
+  if ((res == 10 || res == 20) && wall <= timelimit) {
+    if (expected[job->inst] && expected[job->inst] != res) {
+      msg ("candidate %d produced wrong result %d on '%s'",
+           job->cand, res, instances[job->inst]);
+      c->wrong = 1;
+    } else expected[job->inst] = res;
+    c->solved++;
+    c->par2 += wall;
+  } else c->par2 += 2.0 * timelimit;
+  if (verbose)
+    msg ("candidate %d on '%s' result %d in %.2f seconds",
+         job->cand, instances[job->inst], res, wall);
+}
+
+// Run all jobs with at most 'jobs' processes in parallel.  Solvers are
+// given the time limit with '-T' but are killed after twice the limit.
+
+static void runjobs (Job * todo, int n) {
+  int started, running, i, status;
+  double deadline;
+  pid_t pid;
+  started = running = 0;
+  while (started < n || running) {
+    while (started < n && running < jobs)
+      startjob (todo + started++), running++;
+    if ((pid = waitpid (-1, &status, WNOHANG)) > 0) {
+      for (i = 0; i < started; i++)
+	if (todo[i].pid == pid) break;
+      if (i == started) continue;
+      finishjob (todo + i, status);
+      todo[i].pid = 0;
+      running--;
+      continue;
+    }
+    deadline = getime () - 2.0 * timelimit - 1;
+    for (i = 0; i < started; i++)
+      if (todo[i].pid && todo[i].start < deadline)
+	kill (todo[i].pid, SIGKILL);
+    usleep (1000);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+static Cand * leader (void) {
+  Cand * res = 0;
+  int i;
+  for (i = 0; i < ncands; i++)
+    if (cands[i].alive && (!res || better (cands + i, res)))
+      res = cands + i;
+  return res;
+}
+
+// Drop candidates with wrong results, fewer solved instances, or a PAR2
+// score which is worse than the one of the leader by a margin shrinking
+// with the number of evaluated instances.
+
+static int eliminate (int evaluated) {
+  Cand * l = leader (), * c;
+  double margin;
+  int i, res = 0;
+  if (evaluated < 2) return 0;
+  margin = 1 + 2 / sqrt (evaluated);
+  for (i = 0; i < ncands; i++) {
+    c = cands + i;
+    if (!c->alive || c == l) continue;
+    if (c->wrong || c->solved < l->solved ||
+        c->par2 > margin * l->par2 + 0.01 * evaluated)
+      c->alive = 0, res++;
+  }
+  return res;
+}
+
+static void tune (void) {
+  int round, i, j, k, stage, alive, evaluated, * order, ntodo;
+  Job * todo;
+  Cand * l;
+  order = alloc (ninstances * sizeof *order);
+  todo = alloc (ncands * (size_t) ninstances * sizeof *todo);
+  for (round = 1; round <= rounds; round++) {
+    newcands ();
+    for (i = 0; i < ninstances; i++) order[i] = i;
+    for (i = ninstances - 1; i > 0; i--) {
+      j = pick (i + 1);
+      k = order[i], order[i] = order[j], order[j] = k;
+    }
+    alive = ncands;
+    for (evaluated = 0; evaluated < ninstances; evaluated += stage) {
+      // Evaluate enough instances per stage to keep all jobs busy.
+      stage = race ? (jobs + alive - 1) / alive : ninstances;
+      if (stage > ninstances - evaluated) stage = ninstances - evaluated;
+      ntodo = 0;
+      for (i = 0; i < ncands; i++) {
+	if (!cands[i].alive) continue;
+	for (j = evaluated; j < evaluated + stage; j++) {
+	  todo[ntodo].cand = i;
+	  todo[ntodo].inst = order[j];
+	  todo[ntodo].pid = 0;
+	  ntodo++;
+	}
+      }
+      runjobs (todo, ntodo);
+      if (race) alive -= eliminate (evaluated + stage);
+    }
+    l = leader ();
+    memcpy (best, l->vals, nparams * sizeof *best);
+    msg ("round %d: best candidate %d solved %d of %d, PAR2 %.2f, "
+         "%d of %d candidates left",
+	 round, (int) (l - cands), l->solved, ninstances, l->par2,
+	 alive, ncands);
+  }
+  free (todo);
+  free (order);
+}
+
+static void writebest (void) {
+  FILE * file;
+  int i, count = 0;
+  if (!(file = fopen (outname, "w"))) die ("can not write '%s'", outname);
+  for (i = 0; i < nparams; i++) {
+    if (best[i] == params[i].dflt) continue;
+    fprintf (file, "%s %d\n", params[i].name, best[i]);
+    msg ("--%s=%d (default %d)", params[i].name, best[i], params[i].dflt);
+    count++;
+  }
+  fclose (file);
+  msg ("wrote %d non-default options to '%s'", count, outname);
+}
+
+/*------------------------------------------------------------------------*/
+
+static int isnum (const char * str) {
+  const char * p = str;
+  if (!*p) return 0;
+  while (*p) if (*p < '0' || *p++ > '9') return 0;
+  return 1;
+}
+
+static int intarg (int argc, char ** argv, int * iptr) {
+  if (*iptr + 1 >= argc || !isnum (argv[*iptr + 1]))
+    die ("argument to '%s' missing or invalid", argv[*iptr]);
+  return atoi (argv[++*iptr]);
+}
+
+static const char * strarg (int argc, char ** argv, int * iptr) {
+  if (*iptr + 1 >= argc) die ("argument to '%s' missing", argv[*iptr]);
+  return argv[++*iptr];
+}
+
+int main (int argc, char ** argv) {
+  const char * mode;
+  long cores;
+  int i;
+  outname = "lgltune.opts";
+  cores = sysconf (_SC_NPROCESSORS_ONLN);
+  jobs = cores > 0 ? (int) cores : 1;
+  for (i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h")) {
+      printf (
+"usage: lgltune [ <option> ... ] <cnf> ...\n"
+"\n"
+"where <option> is one of the following:\n"
+"\n"
+"  -h             print this command line option summary\n"
+"  -v             print result of each run\n"
+"  -l <list>      read instances from file (one path per line)\n"
+"  -b <solver>    solver binary (default '%s')\n"
+"  -p <pcs>       configuration space (default from '<solver> --pcs')\n"
+"  -o <file>      option file of best configuration (default '%s')\n"
+"  -m <mode>      search mode 'race' or 'random' (default 'race')\n"
+"  -j <jobs>      number of parallel solver processes (default %d)\n"
+"  -T <seconds>   time limit per run (default %d)\n"
+"  -r <rounds>    number of rounds (default %d)\n"
+"  -n <cands>     candidates per round including the best (default %d)\n"
+"  -c <changes>   changed parameters per candidate (default %d)\n"
+"  -S <seed>      random seed (default %u)\n",
+        solver, outname, jobs, timelimit, rounds, ncands, changes, rng);
+      exit (0);
+    } else if (!strcmp (argv[i], "-v")) verbose = 1;
+    else if (!strcmp (argv[i], "-l")) readlist (strarg (argc, argv, &i));
+    else if (!strcmp (argv[i], "-b")) solver = strarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-p")) pcsname = strarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-o")) outname = strarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-m")) {
+      mode = strarg (argc, argv, &i);
+      if (!strcmp (mode, "race")) race = 1;
+      else if (!strcmp (mode, "random")) race = 0;
+      else die ("invalid mode '%s' (try '-h')", mode);
+    } else if (!strcmp (argv[i], "-j")) jobs = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-T")) timelimit = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-r")) rounds = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-n")) ncands = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-c")) changes = intarg (argc, argv, &i);
+    else if (!strcmp (argv[i], "-S")) rng = intarg (argc, argv, &i);
+    else if (argv[i][0] == '-')
+      die ("invalid command line option '%s' (try '-h')", argv[i]);
+    else addinstance (argv[i]);
+  }
+  if (!ninstances) die ("no instances given (try '-h')");
+  if (jobs < 1) die ("expected positive number of jobs");
+  if (timelimit < 1) die ("expected positive time limit");
+  if (ncands < 1) die ("expected positive number of candidates");
+  if (access (solver, X_OK)) die ("can not execute solver '%s'", solver);
+  readpcs ();
+  msg ("%d parameters, %d instances, %d jobs, time limit %d seconds",
+       nparams, ninstances, jobs, timelimit);
+  msg ("%s search, %d rounds, %d candidates, %d changes, seed %u",
+       race ? "racing" : "random", rounds, ncands, changes, rng);
+  cands = alloc (ncands * sizeof *cands);
+  for (i = 0; i < ncands; i++)
+    cands[i].vals = alloc (nparams * sizeof *cands[i].vals);
+  best = alloc (nparams * sizeof *best);
+  for (i = 0; i < nparams; i++) best[i] = params[i].dflt;
+  expected = alloc (ninstances * sizeof *expected);
+  tune ();
+  writebest ();
+  for (i = 0; i < ncands; i++) free (cands[i].vals);
+  free (cands);
+  free (best);
+  free (expected);
+  for (i = 0; i < nparams; i++)
+    free (params[i].name), free (params[i].vals);
+  free (params);
+  for (i = 0; i < ninstances; i++) free (instances[i]);
+  free (instances);
+  return 0;
+}
@@ -0,0 +1,142 @@
+/*-------------------------------------------------------------------------*/
+/* Copyright 2010-2020 Armin Biere Johannes Kepler University Linz Austria */
+/*-------------------------------------------------------------------------*/
+
+#include "lglclog.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------*/
+// Decodes binary conflict logs written through 'lglsetclog' (for instance
+// with 'lingeling --conflict-log=<file>') into one line per event or into
+// comma separated values with one column per argument of all events.
+
+static const char * names[] = {
+#define LCLEVENT(NAME,ARGS,FIELDS) # NAME,
+LCLEVENTS
+#undef LCLEVENT
+};
+
+static const int nargs[] = {
+#define LCLEVENT(NAME,ARGS,FIELDS) ARGS,
+LCLEVENTS
+#undef LCLEVENT
+};
+
+static const char * fields[] = {
+#define LCLEVENT(NAME,ARGS,FIELDS) FIELDS,
+LCLEVENTS
+#undef LCLEVENT
+};
+
+static FILE * file;
+static const char * name;
+static int64_t offset;
+
+static void die (const char * fmt, ...) {
+  va_list ap;
+  fputs ("*** lglunclog: ", stderr);
+  va_start (ap, fmt);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  fflush (stderr);
+  exit (1);
+}
+
+static int next (void) {
+  int res = getc (file);
+  if (res != EOF) offset++;
+  return res;
+}
+
+static uint64_t getu (const char * what) {
+  uint64_t res = 0;
+  unsigned shift = 0;
+  int ch;
+  do {
+    if (shift > 63) die ("%s: invalid %s at offset %lld",
+                         name, what, (long long) offset);
+    if ((ch = next ()) == EOF)
+      die ("%s: truncated %s at offset %lld",
+           name, what, (long long) offset);
+    res |= (uint64_t) (ch & 0x7f) << shift;
+    shift += 7;
+  } while (ch & 0x80);
+  return res;
+}
+
+int main (int argc, char ** argv) {
+  const unsigned char magic[] = LCLMAGIC;
+  uint64_t args[LCLMAXARGS], version;
+  int64_t conflicts, count[LCL_NEVENTS];
+  int i, j, csv, ch, event, sep;
+  const char * p;
+  csv = 0;
+  name = 0;
+  for (i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h")) {
+      printf ("usage: lglunclog [-h][-c][<log>]\n"
+"\n"
+"  -h   print this command line option summary\n"
+"  -c   comma separated values with one column per argument\n"
+"\n"
+"events and their arguments:\n"
+"\n");
+      for (event = 0; event < LCL_NEVENTS; event++)
+	printf ("  %-10s %s\n", names[event], fields[event]);
+      exit (0);
+    } else if (!strcmp (argv[i], "-c")) csv = 1;
+    else if (argv[i][0] == '-' && argv[i][1])
+      die ("invalid command line option '%s' (try '-h')", argv[i]);
+    else if (name) die ("multiple logs '%s' and '%s'", name, argv[i]);
+    else name = argv[i];
+  }
+  if (!name || !strcmp (name, "-")) file = stdin, name = "<stdin>";
+  else if (!(file = fopen (name, "rb"))) die ("can not read '%s'", name);
+  for (i = 0; i < (int) sizeof magic; i++)
+    if (next () != magic[i]) die ("%s: invalid magic number", name);
+  if ((version = getu ("version")) != LCLVERSION)
+    die ("%s: unsupported version %llu",
+         name, (unsigned long long) version);
+  if (csv) {
+    fputs ("event,conflicts", stdout);
+    for (event = 0; event < LCL_NEVENTS; event++) {
+      printf (",%s.", names[event]);
+      for (p = fields[event]; *p; p++)
+	if (*p == ',') printf (",%s.", names[event]);
+	else fputc (*p, stdout);
+    }
+    fputc ('\n', stdout);
+  }
+  memset (count, 0, sizeof count);
+  conflicts = 0;
+  while ((ch = next ()) != EOF) {
+    if (ch >= LCL_NEVENTS)
+      die ("%s: invalid event %d at offset %lld",
+           name, ch, (long long) offset - 1);
+    event = ch;
+    conflicts += getu ("conflicts");
+    for (i = 0; i < nargs[event]; i++) args[i] = getu (names[event]);
+    count[event]++;
+    sep = csv ? ',' : ' ';
+    printf ("%s%c%lld", names[event], sep, (long long) conflicts);
+    for (j = 0; j < LCL_NEVENTS; j++) {
+      if (!csv && j != event) continue;
+      for (i = 0; i < nargs[j]; i++)
+	if (j != event) fputc (',', stdout);
+	else printf ("%c%llu", sep, (unsigned long long) args[i]);
+    }
+    fputc ('\n', stdout);
+  }
+  if (file != stdin) fclose (file);
+  fprintf (stderr, "c [lglunclog] %lld conflicts", (long long) conflicts);
+  for (event = 0; event < LCL_NEVENTS; event++)
+    fprintf (stderr, ", %lld %s", (long long) count[event], names[event]);
+  fputc ('\n', stderr);
+  return 0;
+}
@@ -8,13 +8,40 @@
 #include <stdarg.h>
 #include <ctype.h>
 #include <signal.h>
+#include <stdint.h>
+#include <sys/time.h>
 
 #include "lglib.h"
+#include "lgltrapi.h"
 
 void lglchkclone (LGL *);
 
-static int verbose, exitonabort, lineno;
+static int verbose, exitonabort, lineno, bench, json, ncalls;
 static const char * name;
+static FILE * deltas;
+
+static LGL * lgl;
+static int res, * start, * top;
+
+typedef struct Event { int cmd, arg; char * opt; } Event;
+
+static Event * events;
+static int nevents, szevents;
+
+typedef struct Latency {
+  const char * name;
+  double * times, sum;
+  int count, size;
+} Latency;
+
+static Latency satlat = { "sat", 0, 0, 0, 0 };
+static Latency simplat = { "simp", 0, 0, 0, 0 };
+
+typedef struct Bulk { int64_t count; double time; } Bulk;
+
+static Bulk adds, assumptions;
+
+typedef struct Sample { double process; int64_t confs, decs, props; } Sample;
 
 static void die (const char * fmt, ...) {
   va_list ap;
@@ -50,47 +77,269 @@ static void msg (const char * fmt, ...) {
   fflush (stdout);
 }
 
-static int isnumstr (const char * str) {
-  const char * p;
-  int ch;
-  if (*(p = str) == '-') p++;
-  if (!isdigit ((int)*p++)) return 0;
-  while (isdigit (ch = *p)) p++;
-  return !ch;
+static void exitonsig (int sig) { 
+  msg ("exit(%d) on signal %d", sig, sig);
+  exit (sig); 
 }
 
-static int intarg (char * op) {
-  const char * tok;
-  if (!(tok = strtok (0, " ")) || !isnumstr (tok) || strtok (0, " ")) {
-    perr ("expected integer argument for '%s'", op);
-    exit (1);
+static void replay (int cmd, int arg, const char * opt) {
+  if (verbose) {
+    if (opt)
+      msg ("event %d : %s %s %d", lineno, ltrcmd2str (cmd), opt, arg);
+    else if (ltrcmdsig (cmd) == 'I')
+      msg ("event %d : %s %d", lineno, ltrcmd2str (cmd), arg);
+    else msg ("event %d : %s", lineno, ltrcmd2str (cmd));
+  }
+  switch (cmd) {
+    case LTR_add: lgladd (lgl, arg); break;
+    case LTR_return:
+      if (arg != res)
+        die ("expected return value %d but got %d", arg, res);
+      break;
+    case LTR_deref: res = lglderef (lgl, arg); break;
+    case LTR_failed: res = lglfailed (lgl, arg); break;
+    case LTR_fixed: res = lglfixed (lgl, arg); break;
+    case LTR_repr: res = lglrepr (lgl, arg); break;
+    case LTR_incvar: res = lglincvar (lgl); break;
+    case LTR_maxvar: res = lglmaxvar (lgl); break;
+    case LTR_changed: res = lglchanged (lgl); break;
+    case LTR_inconsistent: res = lglinconsistent (lgl); break;
+    case LTR_lkhd: res = lglookahead (lgl); break;
+    case LTR_fixate: lglfixate (lgl); break;
+    case LTR_reduce: lglreducecache (lgl); break;
+    case LTR_flush: lglflushcache (lgl); break;
+    case LTR_chkclone: lglchkclone (lgl); break;
+    case LTR_assume: lglassume (lgl, arg); break;
+    case LTR_cassume: lglcassume (lgl, arg); break;
+    case LTR_init: lgl = lglinit (); break;
+    case LTR_sat: res = lglsat (lgl); break;
+    case LTR_simp: res = lglsimp (lgl, arg); break;
+    case LTR_stats: lglstats (lgl); break;
+    case LTR_freeze: lglfreeze (lgl, arg); break;
+    case LTR_melt: lglmelt (lgl, arg); break;
+    case LTR_meltall: lglmeltall (lgl); break;
+    case LTR_reuse: lglreuse (lgl, arg); break;
+    case LTR_frozen: res = lglfrozen (lgl, arg); break;
+    case LTR_usable: res = lglusable (lgl, arg); break;
+    case LTR_reusable: res = lglreusable (lgl, arg); break;
+    case LTR_reconstk: lglreconstk (lgl, &start, &top); break;
+    case LTR_setimportant: lglsetimportant (lgl, arg); break;
+    case LTR_setphases: lglsetphases (lgl); break;
+    case LTR_setphase: lglsetphase (lgl, arg); break;
+    case LTR_resetphase: lglresetphase (lgl, arg); break;
+    case LTR_option: lglsetopt (lgl, opt, arg); break;
+    case LTR_release: lglrelease (lgl); break;
+    default: perr ("unsupported command '%s'", ltrcmd2str (cmd)); break;
   }
-  return atoi (tok);
 }
 
-static int noarg (const char * str, char * op) {
-  if (strcmp (str, op)) return 0;
-  if (strtok (0, " ")) perr ("argument after '%s'", op);
-  return 1;
+static double getime (void) {
+  struct timeval tv;
+  double res = 0;
+  if (!gettimeofday (&tv, 0)) res = 1e-6 * tv.tv_usec, res += tv.tv_sec;
+  return res;
 }
 
-static void exitonsig (int sig) { 
-  msg ("exit(%d) on signal %d", sig, sig);
-  exit (sig); 
+static void bmsg (const char * fmt, ...) {
+  va_list ap;
+  fputs ("c [lgluntrace] ", stdout);
+  va_start (ap, fmt);
+  vprintf (fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+static void pushevent (int cmd, int arg, const char * opt) {
+  Event * e;
+  if (nevents == szevents) {
+    szevents = szevents ? 2*szevents : 1024;
+    events = realloc (events, szevents * sizeof *events);
+    if (!events) die ("out of memory");
+  }
+  e = events + nevents++;
+  e->cmd = cmd;
+  e->arg = arg;
+  e->opt = opt ? strdup (opt) : 0;
+}
+
+static void pushlatency (Latency * l, double t) {
+  if (l->count == l->size) {
+    l->size = l->size ? 2*l->size : 64;
+    l->times = realloc (l->times, l->size * sizeof *l->times);
+    if (!l->times) die ("out of memory");
+  }
+  l->times[l->count++] = t;
+  l->sum += t;
+}
+
+static void sample (Sample * s) {
+  s->process = lglsec (lgl);
+  s->confs = lglgetconfs (lgl);
+  s->decs = lglgetdecs (lgl);
+  s->props = lglgetprops (lgl);
+}
+
+static void printdeltasheader (void) {
+  if (!deltas) return;
+  if (json) fputs ("[\n", deltas);
+  else fputs ("call,event,type,arg,result,wall,process,"
+              "conflicts,decisions,propagations,mb\n", deltas);
+}
+
+static void printdeltas (int event, int cmd, int arg, double wall,
+                         Sample * before, Sample * after) {
+  const char * type = ltrcmd2str (cmd);
+  double process = after->process - before->process;
+  int64_t confs = after->confs - before->confs;
+  int64_t decs = after->decs - before->decs;
+  int64_t props = after->props - before->props;
+  if (!deltas) return;
+  if (json)
+    fprintf (deltas,
+      "%s  {\"call\":%d,\"event\":%d,\"type\":\"%s\",\"arg\":%d,"
+      "\"result\":%d,\"wall\":%.6f,\"process\":%.6f,"
+      "\"conflicts\":%lld,\"decisions\":%lld,\"propagations\":%lld,"
+      "\"mb\":%.3f}",
+      ncalls > 1 ? ",\n" : "", ncalls, event, type, arg, res, wall, process,
+      (long long) confs, (long long) decs, (long long) props, lglmb (lgl));
+  else
+    fprintf (deltas, "%d,%d,%s,%d,%d,%.6f,%.6f,%lld,%lld,%lld,%.3f\n",
+      ncalls, event, type, arg, res, wall, process,
+      (long long) confs, (long long) decs, (long long) props, lglmb (lgl));
+}
+
+static void printdeltasfooter (void) {
+  if (!deltas) return;
+  if (json) fputs (ncalls ? "\n]\n" : "]\n", deltas);
+}
+
+static int cmpdbl (const void * p, const void * q) {
+  double a = * (const double *) p, b = * (const double *) q;
+  if (a < b) return -1;
+  if (a > b) return 1;
+  return 0;
+}
+
+// Nearest rank percentile of the sorted latencies.
+
+static double percentile (Latency * l, int p) {
+  int rank = (p * (int64_t) l->count + 99) / 100;
+  if (rank < 1) rank = 1;
+  return l->times[rank - 1];
+}
+
+// Latencies are put into buckets of powers of two microseconds.
+
+#define NBUCKETS 32
+
+static void printlatency (Latency * l) {
+  int buckets[NBUCKETS], i, b;
+  double us;
+  if (!l->count) return;
+  qsort (l->times, l->count, sizeof *l->times, cmpdbl);
+  bmsg ("%s: %d calls in %.3f seconds, average %.6f seconds",
+        l->name, l->count, l->sum, l->sum / l->count);
+  bmsg ("%s: min %.6f p50 %.6f p99 %.6f max %.6f seconds", l->name,
+        l->times[0], percentile (l, 50), percentile (l, 99),
+	l->times[l->count - 1]);
+  memset (buckets, 0, sizeof buckets);
+  for (i = 0; i < l->count; i++) {
+    us = 1e6 * l->times[i];
+    for (b = 0; b < NBUCKETS - 1 && us > (double)(1u << b); b++)
+      ;
+    buckets[b]++;
+  }
+  for (b = 0; b < NBUCKETS; b++)
+    if (buckets[b])
+      bmsg ("%s: %s %10u us %8d %5.1f%%", l->name,
+            b == NBUCKETS - 1 ? "> " : "<=", 1u << b, buckets[b],
+	    100.0 * buckets[b] / l->count);
+}
+
+static void printbulk (const char * name, Bulk * b) {
+  if (!b->count) return;
+  bmsg ("%s: %lld calls in %.3f seconds, %.2f million calls per second",
+        name, (long long) b->count, b->time,
+	b->time > 0 ? 1e-6 * b->count / b->time : 0.0);
+}
+
+static int isbulk (int cmd) {
+  return cmd == LTR_add || cmd == LTR_assume || cmd == LTR_cassume;
+}
+
+// Runs of consecutive 'add' or 'assume' calls are timed as a whole, while
+// each 'sat' and 'simp' call is timed individually.  Since the trace has
+// been read completely before, parsing is not part of the measurements.
+
+static void runbench (void) {
+  Sample before, after;
+  double t, delta;
+  int i, j, cmd;
+  Event * e;
+  printdeltasheader ();
+  t = getime ();
+  for (i = 0; i < nevents; i = j) {
+    e = events + i;
+    cmd = e->cmd;
+    lineno = i + 1;
+    if (isbulk (cmd)) {
+      delta = getime ();
+      for (j = i; j < nevents && events[j].cmd == cmd; j++) {
+	lineno = j + 1;
+	replay (cmd, events[j].arg, 0);
+      }
+      delta = getime () - delta;
+      if (cmd == LTR_add) adds.count += j - i, adds.time += delta;
+      else assumptions.count += j - i, assumptions.time += delta;
+    } else if (cmd == LTR_sat || cmd == LTR_simp) {
+      sample (&before);
+      delta = getime ();
+      replay (cmd, e->arg, 0);
+      delta = getime () - delta;
+      sample (&after);
+      pushlatency (cmd == LTR_sat ? &satlat : &simplat, delta);
+      ncalls++;
+      printdeltas (i + 1, cmd, e->arg, delta, &before, &after);
+      j = i + 1;
+    } else {
+      replay (cmd, e->arg, e->opt);
+      j = i + 1;
+    }
+  }
+  t = getime () - t;
+  printdeltasfooter ();
+  bmsg ("replayed %d events in %.3f seconds", nevents, t);
+  printbulk ("add", &adds);
+  printbulk ("assume", &assumptions);
+  printlatency (&satlat);
+  printlatency (&simplat);
 }
 
 int main (int argc, char ** argv) {
-  int i, len, ch, close = 0, res, arg;
-  char buffer[80], * tok, * opt;
+  const char * opt, * dname = 0;
+  int i, len, close = 0, cmd, arg, status;
   FILE * file;
-  char * cmd;
-  LGL * lgl;
+  char * str;
+  LTR * ltr;
   for (i = 1; i < argc; i++) {
     if (!strcmp (argv[i], "-h")) {
-      printf ("usage: lgluntrace [-h][-v][-e][<trace>[.gz]]\n");
+      printf (
+"usage: lgluntrace [-h][-v][-e][-b][--csv=<file>|--json=<file>]"
+" [<trace>[.gz]]\n"
+"\n"
+"  -b | --bench     time 'sat' and 'simp' calls and 'add'/'assume' runs\n"
+"  --csv=<file>     write statistics deltas of each call as CSV (implies '-b')\n"
+"  --json=<file>    write statistics deltas of each call as JSON (implies '-b')\n");
       exit (0);
     } else if (!strcmp (argv[i], "-v")) verbose = 1;
     else if (!strcmp (argv[i], "-e")) exitonabort = 1;
+    else if (!strcmp (argv[i], "-b") || !strcmp (argv[i], "--bench"))
+      bench = 1;
+    else if (!strncmp (argv[i], "--csv=", 6))
+      bench = 1, json = 0, dname = argv[i] + 6;
+    else if (!strncmp (argv[i], "--json=", 7))
+      bench = 1, json = 1, dname = argv[i] + 7;
     else if (argv[i][0] == '-')
       die ("invalid command line option '%s' (try '-h')", argv[i]);
     else if (name)
@@ -100,10 +349,10 @@ int main (int argc, char ** argv) {
   if(name) {
     len = strlen (name);
     if (len >= 3 && !strcmp (name + len - 3, ".gz")) {
-      cmd = malloc (len + 20);
-      sprintf (cmd, "gunzip -c %s", name);
-      file = popen (cmd, "r");
-      free (cmd);
+      str = malloc (len + 20);
+      sprintf (str, "gunzip -c %s", name);
+      file = popen (str, "r");
+      free (str);
       if (file) close = 2;
     } else {
       file = fopen (name, "r");
@@ -111,6 +360,11 @@ int main (int argc, char ** argv) {
     }
     if (!file) die ("can not read '%s'", name);
   } else name = "<stdin>", file = stdin;
+  if (dname) {
+    if (!strcmp (dname, "-")) deltas = stdout;
+    else if (!(deltas = fopen (dname, "w")))
+      die ("can not write '%s'", dname);
+  }
   if (exitonabort) {
     msg ("setting signal handlers since '-e' specified");
     signal (SIGINT, exitonsig);
@@ -119,69 +373,29 @@ int main (int argc, char ** argv) {
     signal (SIGTERM, exitonsig);
   }
   msg ("reading %s", name);
-  buffer[len = 0] = 0;
-  lineno = 1;
-  res = 0;
-  lgl = 0;
-NEXT:
-  ch = getc (file);
-  if (ch == EOF) goto DONE;
-  if (ch == '\r') goto NEXT;
-  if (ch != '\n') {
-    if (len + 1 >= (int) sizeof (buffer)) perr ("line buffer exceeded");
-    buffer[len++] = ch;
-    buffer[len] = 0;
-    goto NEXT;
+  if (!(ltr = ltrinit (file))) die ("out of memory");
+  if (ltrbinary (ltr)) msg ("binary trace format");
+  while ((status = ltrnext (ltr, &cmd, &arg, &opt)) > 0) {
+    lineno = ltrlineno (ltr) - 1;
+    if (bench) pushevent (cmd, arg, opt);
+    else replay (cmd, arg, opt);
+  }
+  if (status < 0) {
+    lineno = ltrlineno (ltr);
+    perr ("%s", ltrerr (ltr));
   }
-  msg ("line %d : %s", lineno, buffer);
-  if (!(tok = strtok (buffer, " "))) perr ("empty line");
-  else if (!strcmp (tok, "add")) lgladd (lgl, intarg ("add"));
-  else if (!strcmp (tok, "return")) {
-    arg = intarg ("return");
-    if (arg != res) 
-      die ("expected return value %d but got %d", arg, res);
-  } else if (!strcmp (tok, "deref")) res = lglderef (lgl, intarg ("deref"));
-  else if (!strcmp (tok, "failed")) res = lglfailed (lgl, intarg ("failed"));
-  else if (!strcmp (tok, "fixed")) res = lglfixed (lgl, intarg ("fixed"));
-  else if (!strcmp (tok, "repr")) res = lglrepr (lgl, intarg ("repr"));
-  else if (noarg (tok, "incvar")) res = lglincvar (lgl);
-  else if (noarg (tok, "maxvar")) res = lglmaxvar (lgl);
-  else if (noarg (tok, "changed")) res = lglchanged (lgl);
-  else if (noarg (tok, "inconsistent")) res = lglinconsistent (lgl);
-  else if (noarg (tok, "lkhd")) res = lglookahead (lgl);
-  else if (noarg (tok, "fixate")) lglfixate (lgl);
-  else if (noarg (tok, "reduce")) lglreducecache (lgl);
-  else if (noarg (tok, "flush")) lglflushcache (lgl);
-  else if (noarg (tok, "chkclone")) lglchkclone (lgl);
-  else if (!strcmp (tok, "assume")) lglassume (lgl, intarg ("assume"));
-  else if (noarg (tok, "init")) lgl = lglinit ();
-  else if (noarg (tok, "sat")) res = lglsat (lgl);
-  else if (!strcmp (tok, "simp")) res = lglsimp (lgl, intarg ("simp"));
-  else if (noarg (tok, "stats")) lglstats (lgl);
-  else if (!strcmp (tok, "freeze")) lglfreeze (lgl, intarg ("freeze"));
-  else if (!strcmp (tok, "melt")) lglmelt (lgl, intarg ("melt"));
-  else if (!strcmp (tok, "reuse")) lglreuse (lgl, intarg ("reuse"));
-  else if (!strcmp (tok, "frozen")) res = lglfrozen (lgl, intarg ("frozen"));
-  else if (!strcmp (tok, "usable")) res = lglusable (lgl, intarg ("usable"));
-  else if (!strcmp (tok, "reusable"))
-    res = lglreusable (lgl, intarg ("reusable"));
-  else if (!strcmp (tok, "setimportant"))
-    lglsetimportant (lgl, intarg ("setimportant"));
-  else if (noarg (tok, "setphases")) lglsetphases (lgl);
-  else if (!strcmp (tok, "setphase")) lglsetphase (lgl, intarg ("setphase"));
-  else if (!strcmp (tok, "resetphase"))
-    lglresetphase (lgl, intarg ("resetphase"));
-  else if (!strcmp (tok, "option")) {
-    if (!(opt = strtok (0, " "))) perr ("option name missing");
-    lglsetopt (lgl, opt, intarg ("option"));
-  } else if (noarg (tok, "release")) lglrelease (lgl);
-  else perr ("invalid command '%s'", tok);
-  lineno++;
-  len = 0;
-  goto NEXT;
-DONE:
+  ltrelease (ltr);
   if(close == 1) fclose (file);
   if(close == 2) pclose (file);
+  if (bench) {
+    msg ("read %d events", nevents);
+    runbench ();
+    for (i = 0; i < nevents; i++) free (events[i].opt);
+    free (events);
+    free (satlat.times);
+    free (simplat.times);
+  }
+  if (deltas && deltas != stdout) fclose (deltas);
   msg ("done %s", name);
   return 0;
 }
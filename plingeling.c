@@ -3,6 +3,7 @@
 /*-------------------------------------------------------------------------*/
 
 #include "lglib.h"
+#include "lgljson.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -93,6 +94,8 @@ static int * vals, * fixed, * repr;
 struct { Cls ** start; long first, num, added, collected, size; } clauses;
 static int nfixed, globalres, gcs;
 static const char * name;
+static FILE * timelinefile;
+static LJS * jsonstats;
 static int nworkers2;
 struct { size_t max, current;} mem;
 static int catchedsig;
@@ -873,6 +876,7 @@ static void setopts (LGL * lgl, int i) {
   int j;
   w->lgl = lgl;
   lglsetid (lgl, i, nworkers);
+  if (timelinefile) lglsetimeline (lgl, timelinefile);
   lglsetime (lgl, getime);
   setopt (i, lgl, "verbose", verbose);
 #ifndef NLGLOG
@@ -966,7 +970,7 @@ int main (int argc, char ** argv) {
   int i, res, clin, lit, val, id, nbcore, witness = 1, tobecloned, tobestarted;
   Worker * w, * winner, *maxconsumer, * maxproducer, ** sorted, *earlyworker;
   int sumconsumed, sumconsumedunits, sumconsumedcls, sumconsumedeqs;
-  const char * errstr, * arg;
+  const char * errstr, * arg, * jsonname = 0, * timelinename = 0;
   size_t bytes;
   char * cmd;
   start = currentime ();
@@ -986,6 +990,8 @@ int main (int argc, char ** argv) {
 "  -l         increase logging level\n"
 #endif
 "  -n         do not print solution / witness\n"
+"  --json=<file>  write JSON statistics of all workers and their sum\n"
+"  --timeline=<file>  write Chrome trace timeline of all workers\n"
 #ifndef NLGLYALSAT
 "\n"
 "  --force-locs    force (mainy) local search\n"
@@ -1010,6 +1016,9 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
 #endif
     else if (!strcmp (argv[i], "-p")) plain = 1;
     else if (!strcmp (argv[i], "-n")) witness = 0;
+    else if (!strncmp (argv[i], "--json=", 7)) jsonname = argv[i] + 7;
+    else if (!strncmp (argv[i], "--timeline=", 11))
+      timelinename = argv[i] + 11;
 #ifndef NLGLYALSAT
     else if (!strcmp (argv[i], "--force-locs")) forcelocs++;
 #endif
@@ -1053,6 +1062,13 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
     } else name = argv[i];
   }
   if (nworkers2) assert (!nworkers), nworkers = nworkers2;
+  if (jsonname) {
+    FILE * jsonfile = fopen (jsonname, "w");
+    if (!jsonfile) die ("can not write statistics to '%s'", jsonname);
+    jsonstats = ljsinit (jsonfile);
+  }
+  if (timelinename && !(timelinefile = fopen (timelinename, "w")))
+    die ("can not write timeline to '%s'", timelinename);
   lglbnr ("Plingeling Parallel SAT Solver", "c ", stdout);
   fflush (stdout);
   if (verbose) printf ("c\n");
@@ -1347,6 +1363,11 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
     printf ("c\nc -------------[overall statistics]------------- \nc\n");
   } else printf ("c\n");
   stats ();
+  if (jsonstats) {
+    for (i = 0; i < nworkers; i++)
+      if (workers[i].lgl) ljsadd (jsonstats, workers[i].lgl);
+    ljsrelease (jsonstats);
+  }
 
   if (verbose >= 2) printf ("c\n");
   msg (-1, 2, "releasing %d workers", nworkers);
@@ -1363,6 +1384,7 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
   if (!noeqs) DEL (repr, nvars + 1);
   DEL (vals, nvars + 1);
   deleteallcls ();
+  if (timelinefile) fputs ("\n]\n", timelinefile), fclose (timelinefile);
 
   assert (getenv ("PLINGELINGLEAK") || !mem.current);
 
@@ -3,6 +3,7 @@
 /*-------------------------------------------------------------------------*/
 
 #include "lglib.h"
+#include "lgljson.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -160,7 +161,7 @@ static int64_t * confstack;
 static int numconfstack, sizeconfstack;
 
 static const char * fname;
-static FILE * file;
+static FILE * file, * timelinefile;
 static int lineno;
 
 size_t maxbytes, hardlimbytes, softlimbytes, splitlimbytes, currentbytes;
@@ -180,6 +181,7 @@ static struct { unsigned z, w; } rng;
 static struct { 
   Lock confs;
   Lock done;
+  Lock json;
   Lock leafs;
   Lock mem;
   Lock msg;
@@ -267,6 +269,7 @@ static void unlockgen (Lock *lock, const char * name) {
 
 LOCK (confs)
 LOCK (done)
+LOCK (json)
 LOCK (leafs)
 LOCK (mem)
 LOCK (msg)
@@ -280,6 +283,7 @@ LOCK (stats)
 LOCK (workers)
 UNLOCK (confs)
 UNLOCK (done)
+UNLOCK (json)
 UNLOCK (leafs)
 UNLOCK (mem)
 UNLOCK (msg)
@@ -590,6 +594,8 @@ static void usage () {
 "  -v             increase verbose level\n"
 "  -S             print statistics for each solver instance too\n"
 "  -n             do not print satisfying assignments\n"
+"  --json=<file>  write JSON statistics of all solver instances and sum\n"
+"  --timeline=<file>  write Chrome trace timeline with one track per node\n"
 "\n"             
 "  -t <workers>   maximum number actual worker threads (system default %d)\n"
 "  -a <nodes>     maximum number active nodes (system default %d)\n"
@@ -810,7 +816,7 @@ static void initroot () {
   lglsetopt (root, "druplig", 0);
   lglsetopt (root, "classify", 0);
   if (verbose) lglsetopt (root, "verbose", verbose);
-  else if (!showstats) lglsetopt (root, "profile", 0);
+  else if (!showstats && !timelinefile) lglsetopt (root, "profile", 0);
   lglsetopt (root, "abstime", 1);
   lglsetopt (root, "trep", 0);
   lglsetopt (root, "compact", 1);
@@ -821,6 +827,7 @@ static void initroot () {
     lglsetmsglock (root, lockmsg, unlockmsg, 0);
   }
   lglsetime (root, getime);
+  if (timelinefile) lglsetimeline (root, timelinefile);
   lglsetprefix (root, "c (root) ");
 }
 
@@ -856,6 +863,7 @@ static Node * newnode (Node * parent, int decision) {
   }
   sprintf (prefix, "c (%d %lld) ", res->depth, (LL) res->id);
   lglsetprefix (res->lgl, prefix);
+  if (timelinefile) lglsetid (res->lgl, (int) res->id + 1, (int) res->id + 2);
   lglseterm (res->lgl, term, 0);
   lglsetmsglock (res->lgl, lockmsg, unlockmsg, 0);
   if (!noparallel) lglsetconsumeunits (res->lgl, consumeunits, &res->consumed);
@@ -880,6 +888,24 @@ static void updstats (Node * node) {
   unlockstats ();
 }
 
+/*------------------------------------------------------------------------*/
+// Aggregated machine readable statistics of all solver instances.
+
+static LJS * jsonstats;
+
+static void jsonworker (LGL * lgl) {
+  if (!jsonstats) return;
+  lockjson ();
+  ljsadd (jsonstats, lgl);
+  unlockjson ();
+}
+
+static void jsonclose (void) {
+  if (!jsonstats) return;
+  ljsrelease (jsonstats);
+  jsonstats = 0;
+}
+
 static void delnode (Node * node) {
   Node * last;
   int lastpos;
@@ -909,6 +935,7 @@ static void delnode (Node * node) {
   DEL (node, 1);
   assert (lgl);
   if (showstats) lglstats (lgl);
+  jsonworker (lgl);
   lglrelease (lgl);
   deleted++;
 }
@@ -1028,6 +1055,7 @@ static void startparallel (LGL * lgl) {
   parallel.lgl = lglclone (lgl);
   sprintf (prefix, "c (parallel%d) ", nparallel);
   lglsetprefix (parallel.lgl, prefix);
+  lglsetimeline (parallel.lgl, 0);	// would share the track of its node
   lglsetopt (parallel.lgl, "locs", -1);
   lglsetopt (parallel.lgl, "locsbanner", nparallel == 1);
   lglsetopt (parallel.lgl, "locsmaxeff", 1000000);
@@ -1075,6 +1103,7 @@ static void releaseparallel () {
   propagations += lglgetprops (lgl) - parallel.propagations;
   unlockparstats ();
   if (showstats) lglstats (lgl);
+  jsonworker (lgl);
   lglrelease (lgl);
   DEL (parallel.units, nvars);
   parallel.nunits = 0;
@@ -2019,6 +2048,7 @@ static void init () {
 
   pthread_mutex_init (&lock.confs.mutex, 0);
   pthread_mutex_init (&lock.done.mutex, 0);
+  pthread_mutex_init (&lock.json.mutex, 0);
   pthread_mutex_init (&lock.leafs.mutex, 0);
   pthread_mutex_init (&lock.mem.mutex, 0);
   pthread_mutex_init (&lock.msg.mutex, 0);
@@ -2184,7 +2214,16 @@ int main (int argc, char ** argv) {
       treelookdepth = 0, treelookdepthset = 1;
     else if (parselopt (argv[i], &treelookdepth, "treelook"))
       treelookdepthset = 1;
-    else if (parselopt (argv[i], &minclim, "min")) ;
+    else if (!strncmp (argv[i], "--json=", 7)) {
+      FILE * jsonfile = fopen (argv[i] + 7, "w");
+      if (!jsonfile)
+	err ("can not write JSON statistics to '%s'", argv[i] + 7);
+      if (jsonstats) ljsrelease (jsonstats);
+      jsonstats = ljsinit (jsonfile);
+    } else if (!strncmp (argv[i], "--timeline=", 11)) {
+      if (!(timelinefile = fopen (argv[i] + 11, "w")))
+	err ("can not write timeline to '%s'", argv[i] + 11);
+    } else if (parselopt (argv[i], &minclim, "min")) ;
     else if (parselopt (argv[i], &initclim, "init")) ;
     else if (parselopt (argv[i], &maxclim, "max")) ;
     else if (*argv[i] == '-')
@@ -2385,7 +2424,10 @@ int main (int argc, char ** argv) {
     while ((leaf = deqleaf ())) deleaf (leaf);
   }
 
+  jsonworker (root);
+  jsonclose ();
   lglrelease (root);
+  if (timelinefile) fputs ("\n]\n", timelinefile), fclose (timelinefile);
   resetsighandlers ();
 
   stats ();